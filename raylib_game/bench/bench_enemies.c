@@ -0,0 +1,429 @@
+/**
+ * Kitchen Knight - Enemy Update Benchmark
+ * =======================================
+ * Compares the original array-of-structs enemy update against the SoA pool
+ * and its SIMD kernels at several horde sizes, then measures the AI level
+ * of detail scheduler under a 10k horde. Runs without a window.
+ *
+ * Usage: kk_bench_enemies [frames]
+ */
+
+#include "enemies/enemy_lod.h"
+#include "enemies/enemy_types.h"
+#include "game.h"
+#include "logger.h"
+#include "raymath.h"
+#include "simd.h"
+#include "timer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DT (1.0f / 60.0f)
+#define LOD_ENEMIES 10000
+#define LOD_FRAMES 600
+#define LOD_LEVEL_CELLS 100 // Open level side, in map cells
+#define LOCKSTEP_ENEMIES 64
+#define LOCKSTEP_FRAMES 240
+
+// ==========================================
+// REFERENCE: ORIGINAL AoS UPDATE
+// ==========================================
+// Verbatim copy of the pre-SoA enemy struct and update, kept here so the
+// comparison stays honest as the real pool evolves.
+
+typedef struct {
+  EnemyType type;
+  AIState state;
+  Vector3 position;
+  float radius;
+  int hp;
+  int maxHP;
+  uint8_t flags;
+  float stateTimer;
+  Color color;
+  float attackRange;
+  float attackCooldown;
+  float currentCooldown;
+  float speed;
+} EnemyAoS;
+
+static float Clampf(float value, float min, float max) {
+  if (value < min)
+    return min;
+  if (value > max)
+    return max;
+  return value;
+}
+
+static void UpdateSingleEnemyAoS(EnemyAoS *enemy, Vector3 playerPos,
+                                 float dt) {
+  if (!(enemy->flags & ENEMY_FLAG_ACTIVE))
+    return;
+  if (enemy->state == AI_DEAD)
+    return;
+
+  if (enemy->flags & ENEMY_FLAG_HURT) {
+    enemy->stateTimer -= dt;
+    if (enemy->stateTimer <= 0) {
+      enemy->flags &= ~ENEMY_FLAG_HURT;
+      enemy->state = AI_CHASE;
+    }
+    return;
+  }
+
+  float dist = Vector3Distance(enemy->position, playerPos);
+
+  if (enemy->state == AI_IDLE) {
+    if (dist < 20.0f) {
+      enemy->state = AI_CHASE;
+    }
+  }
+
+  if (enemy->state == AI_CHASE) {
+    if (dist <= enemy->attackRange) {
+      enemy->state = AI_ATTACK;
+      enemy->stateTimer = 0.5f;
+    }
+  }
+
+  if (enemy->state == AI_CHASE) {
+    Vector3 dir = Vector3Subtract(playerPos, enemy->position);
+    dir.y = 0;
+    dir = Vector3Normalize(dir);
+
+    enemy->position =
+        Vector3Add(enemy->position, Vector3Scale(dir, enemy->speed * dt));
+
+    float halfArena = (ARENA_SIZE / 2.0f) - 1.0f;
+    enemy->position.x = Clampf(enemy->position.x, -halfArena, halfArena);
+    enemy->position.z = Clampf(enemy->position.z, -halfArena, halfArena);
+  }
+
+  if (enemy->state == AI_ATTACK) {
+    enemy->stateTimer -= dt;
+    if (enemy->stateTimer <= 0) {
+      enemy->state = AI_CHASE;
+      enemy->currentCooldown = enemy->attackCooldown;
+    }
+  }
+
+  if (enemy->currentCooldown > 0) {
+    enemy->currentCooldown -= dt;
+  }
+}
+
+// ==========================================
+// SCENE SETUP
+// ==========================================
+
+static uint32_t rngState = 12345u;
+
+static float RandomRange(float min, float max) {
+  rngState = rngState * 1664525u + 1013904223u;
+  return min + (max - min) * (float)(rngState >> 8) / 16777216.0f;
+}
+
+static Vector3 *MakePositions(int count) {
+  Vector3 *positions = malloc(sizeof(Vector3) * (size_t)count);
+  float half = ARENA_SIZE / 2.0f - 1.0f;
+  rngState = 12345u;
+  for (int i = 0; i < count; i++) {
+    positions[i] = (Vector3){RandomRange(-half, half), ENEMY_HEIGHT / 2.0f,
+                             RandomRange(-half, half)};
+  }
+  return positions;
+}
+
+// Thirds of the horde: toasters, blenders, microwaves
+static EnemyType TypeForIndex(int i, int count) {
+  return (EnemyType)((int64_t)i * 3 / count);
+}
+
+static void SpawnSoA(const Vector3 *positions, int count) {
+  ResetEnemyPool();
+  int start = 0;
+  for (int t = 0; t < 3; t++) {
+    int end = start;
+    while (end < count && TypeForIndex(end, count) == (EnemyType)t)
+      end++;
+    SpawnEnemyWave((EnemyType)t, &positions[start], end - start);
+    start = end;
+  }
+}
+
+static EnemyAoS *SpawnAoS(const Vector3 *positions, int count) {
+  EnemyAoS *enemies = calloc((size_t)count, sizeof(EnemyAoS));
+  for (int i = 0; i < count; i++) {
+    int hp;
+    float speed, attackRange;
+    Color color;
+    GetEnemyDefaults(TypeForIndex(i, count), &hp, &speed, &attackRange,
+                     &color);
+    enemies[i] = (EnemyAoS){.type = TypeForIndex(i, count),
+                            .state = AI_IDLE,
+                            .position = positions[i],
+                            .radius = ENEMY_WIDTH / 2.0f,
+                            .hp = hp,
+                            .maxHP = hp,
+                            .flags = ENEMY_FLAG_ACTIVE,
+                            .color = color,
+                            .attackRange = attackRange,
+                            .attackCooldown = 1.0f,
+                            .speed = speed};
+  }
+  return enemies;
+}
+
+// Player walks a slow circle so enemies keep switching states
+static Vector3 PlayerAt(int frame) {
+  float t = (float)frame * BENCH_DT * 0.5f;
+  return (Vector3){cosf(t) * 15.0f, PLAYER_HEIGHT, sinf(t) * 15.0f};
+}
+
+// ==========================================
+// RUNS
+// ==========================================
+
+static double RunAoS(EnemyAoS *enemies, int count, int frames) {
+  uint64_t start = GetTimestampNs();
+  for (int f = 0; f < frames; f++) {
+    Vector3 player = PlayerAt(f);
+    for (int i = 0; i < count; i++) {
+      UpdateSingleEnemyAoS(&enemies[i], player, BENCH_DT);
+    }
+  }
+  return (double)(GetTimestampNs() - start);
+}
+
+static double RunSoA(int frames) {
+  GameState game = {0};
+  uint64_t start = GetTimestampNs();
+  for (int f = 0; f < frames; f++) {
+    game.playerPos = PlayerAt(f);
+    UpdateEnemies(&game, BENCH_DT);
+  }
+  return (double)(GetTimestampNs() - start);
+}
+
+// Max position difference between the two layouts after identical frames
+static float CompareLayouts(const EnemyAoS *enemies, int count) {
+  float maxDiff = 0.0f;
+  for (int i = 0; i < count; i++) {
+    float dx = fabsf(enemies[i].position.x - enemyPool.posX[i]);
+    float dz = fabsf(enemies[i].position.z - enemyPool.posZ[i]);
+    maxDiff = fmaxf(maxDiff, fmaxf(dx, dz));
+  }
+  return maxDiff;
+}
+
+// ==========================================
+// AI LEVEL OF DETAIL
+// ==========================================
+
+static void SetLODEnabled(bool enabled) {
+  EnemyLODConfig config = GetEnemyLODConfig();
+  config.enabled = enabled;
+  SetEnemyLODConfig(&config);
+}
+
+// 10k enemies spread over a square of the given half size
+static void RunLOD(const char *scene, float half, bool enabled) {
+  Vector3 *positions = malloc(sizeof(Vector3) * LOD_ENEMIES);
+  rngState = 777u;
+  for (int i = 0; i < LOD_ENEMIES; i++) {
+    positions[i] = (Vector3){RandomRange(-half, half), ENEMY_HEIGHT / 2.0f,
+                             RandomRange(-half, half)};
+  }
+  SetLODEnabled(enabled);
+  SpawnSoA(positions, LOD_ENEMIES);
+
+  GameState game = {0};
+  uint64_t total = 0, worst = 0;
+  double ticked = 0.0;
+  for (int f = 0; f < LOD_FRAMES; f++) {
+    game.playerPos = PlayerAt(f);
+    UpdateEnemies(&game, BENCH_DT);
+    const EnemyLODStats *stats = GetEnemyLODStats();
+    total += stats->frameNs;
+    if (stats->frameNs > worst)
+      worst = stats->frameNs;
+    ticked += stats->ticked;
+  }
+
+  const EnemyLODStats *stats = GetEnemyLODStats();
+  printf("%-14s %4s %10.1f %10.1f %9.0f %7d %7d %7d %7d\n", scene,
+         enabled ? "on" : "off", (double)total / LOD_FRAMES / 1000.0,
+         (double)worst / 1000.0, ticked / LOD_FRAMES, stats->bandCount[0],
+         stats->bandCount[1], stats->bandCount[2], stats->bandCount[3]);
+  free(positions);
+}
+
+static void RunLODSuite(void) {
+  EnemyLODConfig config = GetEnemyLODConfig();
+  printf("\nAI LOD, %d enemies, %d frames (bands <%.0f/<%.0f/<%.0f/far, "
+         "every %d/%d/%d/%d frames)\n",
+         LOD_ENEMIES, LOD_FRAMES, config.bandDistance[0],
+         config.bandDistance[1], config.bandDistance[2],
+         config.tickInterval[0], config.tickInterval[1],
+         config.tickInterval[2], config.tickInterval[3]);
+  printf("%-14s %4s %10s %10s %9s %7s %7s %7s %7s\n", "scene", "lod",
+         "avg us", "worst us", "ticked", "band0", "band1", "band2", "band3");
+
+  // Open arena, direct chase
+  float arenaHalf = ARENA_SIZE / 2.0f - 1.0f;
+  RunLOD("arena", arenaHalf, false);
+  RunLOD("arena", arenaHalf, true);
+
+  // Large open level, flow field steering
+  LevelMap level = {.width = LOD_LEVEL_CELLS, .height = LOD_LEVEL_CELLS};
+  size_t cells = (size_t)LOD_LEVEL_CELLS * LOD_LEVEL_CELLS;
+  level.data = malloc(cells);
+  memset(level.data, CELL_EMPTY, cells);
+  SetEnemyLevel(&level);
+  float levelHalf = LOD_LEVEL_CELLS * MAP_CELL_SIZE / 2.0f - 1.0f;
+  RunLOD("level 100x100", levelHalf, false);
+  RunLOD("level 100x100", levelHalf, true);
+  SetEnemyLevel(NULL);
+  free(level.data);
+
+  SetLODEnabled(true);
+}
+
+// ==========================================
+// LOD LOCK-STEP
+// ==========================================
+// Every SIMD level must leave the pool bit for bit where the scalar
+// reference does, including enemies whose band changes mid-run: the player
+// walks in and out of range and far enemies get hit (forced to band 0).
+
+static EnemyPool lockstepRef;
+
+static void RunLockStep(const Vector3 *positions) {
+  SpawnSoA(positions, LOCKSTEP_ENEMIES);
+  GameState game = {0};
+  for (int f = 0; f < LOCKSTEP_FRAMES; f++) {
+    game.playerPos = PlayerAt(f);
+    if (f == LOCKSTEP_FRAMES / 2)
+      game.playerPos = (Vector3){-20.0f, PLAYER_HEIGHT, -20.0f};
+    // Hits land on different tick phases, so some find time banked
+    if (f == 80 || f == 161 || f == 203) {
+      for (int i = 0; i < LOCKSTEP_ENEMIES; i++) {
+        if (i < 8 || i % 2 == 0) // The far block whole, then every other
+          DamageEnemy(GetEnemyHandle(i), 1);
+      }
+    }
+    UpdateEnemies(&game, BENCH_DT);
+  }
+}
+
+#define SAME(field, i)                                                         \
+  (memcmp(&enemyPool.field[i], &lockstepRef.field[i],                          \
+          sizeof(enemyPool.field[i])) == 0)
+
+// First slot that differs from the scalar run, or -1
+static int FindLockStepMismatch(void) {
+  for (int i = 0; i < LOCKSTEP_ENEMIES; i++) {
+    if (!SAME(posX, i) || !SAME(posZ, i) || !SAME(stateTimer, i) ||
+        !SAME(currentCooldown, i) || !SAME(state, i) || !SAME(flags, i) ||
+        !SAME(lodBand, i) || !SAME(lodAccum, i) || !SAME(hp, i))
+      return i;
+  }
+  return -1;
+}
+
+static bool CheckLODLockStep(void) {
+  // A block of 8 in a far band, then a scattered rest
+  Vector3 positions[LOCKSTEP_ENEMIES];
+  float half = ARENA_SIZE / 2.0f - 1.0f;
+  rngState = 4242u;
+  for (int i = 0; i < LOCKSTEP_ENEMIES; i++) {
+    positions[i] = i < 8 ? (Vector3){22.0f, ENEMY_HEIGHT / 2.0f, 22.0f}
+                         : (Vector3){RandomRange(-half, half),
+                                     ENEMY_HEIGHT / 2.0f,
+                                     RandomRange(-half, half)};
+  }
+
+  SimdLevel best = GetSimdLevel();
+  SetLODEnabled(true);
+  SetSimdLevel(SIMD_SCALAR);
+  RunLockStep(positions);
+  memcpy(&lockstepRef, &enemyPool, sizeof(lockstepRef));
+
+  bool ok = true;
+  printf("\nAI LOD lock-step vs scalar, %d enemies, %d frames:",
+         LOCKSTEP_ENEMIES, LOCKSTEP_FRAMES);
+  for (SimdLevel level = SIMD_SSE2; level <= best; level++) {
+    SetSimdLevel(level);
+    RunLockStep(positions);
+    int slot = FindLockStepMismatch();
+    if (slot < 0) {
+      printf(" %s match", GetSimdLevelName(level));
+    } else {
+      printf(" %s MISMATCH at slot %d", GetSimdLevelName(level), slot);
+      ok = false;
+    }
+  }
+  printf("\n");
+  SetSimdLevel(best);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 0;
+  const int counts[] = {64, 1024, 16384, 65536};
+  const int numCounts = (int)(sizeof(counts) / sizeof(counts[0]));
+  SimdLevel best = GetSimdLevel();
+  SetLogLevel(LOG_LEVEL_WARN); // Wave spawns and hits would flood the tables
+
+  printf("Enemy update benchmark (best SIMD: %s)\n", GetSimdLevelName(best));
+
+  // The layout comparison needs every enemy updated every frame
+  SetLODEnabled(false);
+  printf("%8s %8s %12s %12s %12s %12s %9s %10s\n", "enemies", "frames",
+         "AoS ns/e", "SoA-sc ns/e", "SSE2 ns/e", "AVX2 ns/e", "speedup",
+         "max |dpos|");
+
+  for (int c = 0; c < numCounts; c++) {
+    int count = counts[c];
+    // Aim for ~4M enemy updates per run so small hordes are measurable
+    int runFrames = frames > 0 ? frames : 4000000 / count;
+    if (runFrames < 60)
+      runFrames = 60;
+
+    Vector3 *positions = MakePositions(count);
+    double updates = (double)count * runFrames;
+
+    EnemyAoS *aos = SpawnAoS(positions, count);
+    double aosNs = RunAoS(aos, count, runFrames) / updates;
+
+    double levelNs[3] = {0};
+    for (SimdLevel level = SIMD_SCALAR; level <= best; level++) {
+      SetSimdLevel(level);
+      SpawnSoA(positions, count);
+      levelNs[level] = RunSoA(runFrames) / updates;
+    }
+    SetSimdLevel(best);
+
+    // Lock-step correctness check from a fresh start
+    free(aos);
+    aos = SpawnAoS(positions, count);
+    SpawnSoA(positions, count);
+    RunAoS(aos, count, 120);
+    RunSoA(120);
+    float diff = CompareLayouts(aos, count);
+
+    printf("%8d %8d %12.2f %12.2f %12.2f %12.2f %8.1fx %10.2e\n", count,
+           runFrames, aosNs, levelNs[SIMD_SCALAR],
+           best >= SIMD_SSE2 ? levelNs[SIMD_SSE2] : 0.0,
+           best >= SIMD_AVX2 ? levelNs[SIMD_AVX2] : 0.0,
+           aosNs / levelNs[best], diff);
+
+    free(aos);
+    free(positions);
+  }
+
+  RunLODSuite();
+  return CheckLODLockStep() ? 0 : 1;
+}
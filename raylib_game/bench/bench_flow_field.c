@@ -0,0 +1,323 @@
+/**
+ * Kitchen Knight - Flow Field Benchmark
+ * =====================================
+ * Times full flow field integration and per-enemy direction lookups on
+ * generated maps (1k and 1M cells), counts how often a walking player
+ * actually triggers a rebuild, and compares incremental (LPA*) repairs
+ * against full rebuilds. Runs without a window.
+ *
+ * Usage: kk_bench_flow_field [builds]
+ */
+
+#include "flow_field.h"
+#include "logger.h"
+#include "map_loader.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WALL_PERCENT 20
+#define LOOKUPS 4000000
+#define WALK_FRAMES 600
+#define WALK_DT (1.0f / 60.0f)
+#define WALK_SPEED 10.0f // PLAYER_SPEED
+#define REPAIR_STEPS 64
+#define AGENT_COUNT 1000
+#define AGENT_SPREAD 24 // Agents within this many cells of the player
+
+// ==========================================
+// MAP GENERATION
+// ==========================================
+
+static uint32_t rngState = 12345u;
+
+static uint32_t NextRandom(void) {
+  rngState = rngState * 1664525u + 1013904223u;
+  return rngState >> 8;
+}
+
+// Border walls plus scattered wall cells
+static LevelMap MakeMap(int width, int height) {
+  LevelMap map = {0};
+  map.width = width;
+  map.height = height;
+  map.data = malloc((size_t)width * (size_t)height);
+  rngState = 12345u;
+  for (int z = 0; z < height; z++) {
+    for (int x = 0; x < width; x++) {
+      bool border = x == 0 || z == 0 || x == width - 1 || z == height - 1;
+      bool wall = border || (int)(NextRandom() % 100) < WALL_PERCENT;
+      map.data[z * width + x] = wall ? CELL_WALL : CELL_EMPTY;
+    }
+  }
+  return map;
+}
+
+// Random open cell
+static void RandomOpenCell(const LevelMap *map, int *x, int *z) {
+  do {
+    *x = (int)(NextRandom() % (uint32_t)map->width);
+    *z = (int)(NextRandom() % (uint32_t)map->height);
+  } while (GetCell(map, *x, *z) == CELL_WALL);
+}
+
+// ==========================================
+// RUNS
+// ==========================================
+
+static void RunMap(int width, int height, int builds) {
+  LevelMap map = MakeMap(width, height);
+  FlowField field;
+  if (!InitFlowField(&field, width, height)) {
+    free(map.data);
+    return;
+  }
+
+  // Full builds from random goals
+  uint64_t buildNs = 0, worstNs = 0;
+  for (int b = 0; b < builds; b++) {
+    int gx, gz;
+    RandomOpenCell(&map, &gx, &gz);
+    BuildFlowField(&field, &map, gx, gz);
+    buildNs += field.lastBuildNs;
+    if (field.lastBuildNs > worstNs)
+      worstNs = field.lastBuildNs;
+  }
+
+  int reachable = 0;
+  size_t cells = (size_t)width * (size_t)height;
+  for (size_t i = 0; i < cells; i++)
+    reachable += field.cost[i] != FLOW_COST_UNREACHABLE;
+
+  // O(1) lookups from random cells (what every enemy does per frame)
+  int *probe = malloc(sizeof(int) * 2 * 4096);
+  for (int i = 0; i < 4096; i++) {
+    probe[i * 2] = (int)(NextRandom() % (uint32_t)width);
+    probe[i * 2 + 1] = (int)(NextRandom() % (uint32_t)height);
+  }
+  int found = 0;
+  uint64_t start = GetTimestampNs();
+  for (int i = 0; i < LOOKUPS; i++) {
+    int p = (i & 4095) * 2;
+    int nx, nz;
+    found += GetFlowStep(&field, probe[p], probe[p + 1], &nx, &nz);
+  }
+  double lookupNs = (double)(GetTimestampNs() - start) / LOOKUPS;
+  free(probe);
+
+  // Player walking straight across open ground: rebuild only on cell change
+  LevelMap open = {.width = width, .height = height};
+  open.data = malloc(cells);
+  memset(open.data, CELL_EMPTY, cells);
+  FlowField walk;
+  InitFlowField(&walk, width, height);
+  float px = 1.5f * MAP_CELL_SIZE, pz = 1.5f * MAP_CELL_SIZE;
+  uint64_t walkNs = 0;
+  for (int f = 0; f < WALK_FRAMES; f++) {
+    px += WALK_SPEED * WALK_DT;
+    int cx = (int)(px / MAP_CELL_SIZE) % width;
+    int cz = (int)(pz / MAP_CELL_SIZE);
+    if (UpdateFlowFieldGoal(&walk, &open, cx, cz))
+      walkNs += walk.lastBuildNs;
+  }
+
+  printf("%9d %7d %12.3f %12.3f %10.2f %9.1f%% %6d/%-6d %10.3f\n",
+         width * height, builds, NsToMs(buildNs) / builds, NsToMs(worstNs),
+         lookupNs, 100.0 * reachable / (double)cells, walk.buildCount,
+         WALK_FRAMES, NsToMs(walkNs) / WALK_FRAMES);
+  (void)found;
+
+  UnloadFlowField(&walk);
+  UnloadFlowField(&field);
+  free(open.data);
+  free(map.data);
+}
+
+// ==========================================
+// INCREMENTAL REPAIR
+// ==========================================
+
+typedef struct {
+  uint64_t ns;
+  int64_t touched;
+  int64_t expanded;
+} RepairTotals;
+
+static void AddRepair(RepairTotals *totals, const FlowField *field) {
+  totals->ns += field->lastRepairNs;
+  totals->touched += field->lastRepairTouched;
+  totals->expanded += field->lastRepairExpanded;
+}
+
+static void PrintRepair(const char *label, const RepairTotals *totals,
+                        int steps, double buildMs, int mismatches) {
+  double ms = NsToMs(totals->ns) / steps;
+  printf("  %-24s %10.3f %12.0f %12.0f %8.2fx %10d\n", label, ms,
+         (double)totals->touched / steps, (double)totals->expanded / steps,
+         buildMs / ms, mismatches);
+}
+
+// Cells whose settled cost differs from a fresh full build
+static int CountMismatches(const FlowField *repaired, const LevelMap *map,
+                           FlowField *reference, const int32_t *agents,
+                           int agentCount) {
+  BuildFlowField(reference, map, repaired->goalX, repaired->goalZ);
+  int mismatches = 0;
+  if (agents) {
+    for (int a = 0; a < agentCount; a++)
+      mismatches += repaired->cost[agents[a]] != reference->cost[agents[a]];
+  } else {
+    size_t cells = (size_t)map->width * (size_t)map->height;
+    for (size_t i = 0; i < cells; i++)
+      mismatches += repaired->cost[i] != reference->cost[i];
+  }
+  return mismatches;
+}
+
+// Next open cell one step from (x, z), wandering in a fixed pattern
+static void StepGoal(const LevelMap *map, int *x, int *z, int step) {
+  static const int moves[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+  for (int attempt = 0; attempt < 4; attempt++) {
+    const int *m = moves[(step / 8 + attempt) & 3];
+    if (GetCell(map, *x + m[0], *z + m[1]) != CELL_WALL) {
+      *x += m[0];
+      *z += m[1];
+      return;
+    }
+  }
+}
+
+static void RunRepairs(int width, int height) {
+  LevelMap map = MakeMap(width, height);
+  FlowField field, reference;
+  InitFlowField(&field, width, height);
+  InitFlowField(&reference, width, height);
+  int cells = width * height;
+
+  int gx = width / 2, gz = height / 2;
+  map.data[gz * width + gx] = CELL_EMPTY;
+
+  // Baseline: what a full rebuild per player step costs
+  uint64_t buildNs = 0;
+  int bx = gx, bz = gz;
+  for (int s = 0; s < REPAIR_STEPS; s++) {
+    StepGoal(&map, &bx, &bz, s);
+    BuildFlowField(&field, &map, bx, bz);
+    buildNs += field.lastBuildNs;
+  }
+  double buildMs = NsToMs(buildNs) / REPAIR_STEPS;
+
+  printf("%d cells: full rebuild %.3f ms (%d cells settled)\n", cells,
+         buildMs, cells);
+  printf("  %-24s %10s %12s %12s %9s %10s\n", "repair", "ms", "touched",
+         "expanded", "vs build", "mismatch");
+
+  // Player steps, whole field repaired
+  RepairTotals totals = {0};
+  int mismatches = 0;
+  BuildFlowField(&field, &map, gx, gz);
+  bx = gx;
+  bz = gz;
+  for (int s = 0; s < REPAIR_STEPS; s++) {
+    StepGoal(&map, &bx, &bz, s);
+    MoveFlowFieldGoal(&field, &map, bx, bz);
+    RepairFlowField(&field, &map, NULL, 0);
+    AddRepair(&totals, &field);
+  }
+  mismatches = CountMismatches(&field, &map, &reference, NULL, 0);
+  PrintRepair("goal step, full field", &totals, REPAIR_STEPS, buildMs,
+              mismatches);
+
+  // Player steps, repaired only out to a horde around the player
+  int32_t *agents = malloc(sizeof(int32_t) * AGENT_COUNT);
+  for (int a = 0; a < AGENT_COUNT; a++) {
+    int ax, az;
+    do {
+      ax = gx + (int)(NextRandom() % (2 * AGENT_SPREAD + 1)) - AGENT_SPREAD;
+      az = gz + (int)(NextRandom() % (2 * AGENT_SPREAD + 1)) - AGENT_SPREAD;
+    } while (GetCell(&map, ax, az) == CELL_WALL);
+    agents[a] = az * width + ax;
+  }
+  totals = (RepairTotals){0};
+  BuildFlowField(&field, &map, gx, gz);
+  bx = gx;
+  bz = gz;
+  for (int s = 0; s < REPAIR_STEPS; s++) {
+    StepGoal(&map, &bx, &bz, s);
+    MoveFlowFieldGoal(&field, &map, bx, bz);
+    RepairFlowField(&field, &map, agents, AGENT_COUNT);
+    AddRepair(&totals, &field);
+  }
+  mismatches =
+      CountMismatches(&field, &map, &reference, agents, AGENT_COUNT);
+  PrintRepair("goal step, agent horizon", &totals, REPAIR_STEPS, buildMs,
+              mismatches);
+
+  // Same walk through RetargetFlowField, which picks repair or rebuild
+  totals = (RepairTotals){0};
+  BuildFlowField(&field, &map, gx, gz);
+  int buildsBefore = field.buildCount;
+  uint64_t retargetNs = 0;
+  bx = gx;
+  bz = gz;
+  for (int s = 0; s < REPAIR_STEPS; s++) {
+    StepGoal(&map, &bx, &bz, s);
+    uint64_t t0 = GetTimestampNs();
+    RetargetFlowField(&field, &map, bx, bz, agents, AGENT_COUNT);
+    retargetNs += GetTimestampNs() - t0;
+  }
+  mismatches =
+      CountMismatches(&field, &map, &reference, agents, AGENT_COUNT);
+  printf("  %-24s %10.3f %12s %12s %8.2fx %10d (%d rebuilds)\n",
+         "goal step, retarget", NsToMs(retargetNs) / REPAIR_STEPS, "-", "-",
+         buildMs / (NsToMs(retargetNs) / REPAIR_STEPS), mismatches,
+         field.buildCount - buildsBefore);
+
+  // Walls closing and reopening near the player (doors, destructibles)
+  totals = (RepairTotals){0};
+  BuildFlowField(&field, &map, gx, gz);
+  for (int s = 0; s < REPAIR_STEPS; s++) {
+    int wx, wz;
+    do {
+      wx = gx + (int)(NextRandom() % 17) - 8;
+      wz = gz + (int)(NextRandom() % 17) - 8;
+    } while (GetCell(&map, wx, wz) == CELL_WALL || (wx == gx && wz == gz));
+    char *cell = &map.data[wz * width + wx];
+    *cell = CELL_WALL;
+    NotifyFlowFieldCellChanged(&field, &map, wx, wz);
+    RepairFlowField(&field, &map, NULL, 0);
+    AddRepair(&totals, &field);
+    *cell = CELL_EMPTY;
+    NotifyFlowFieldCellChanged(&field, &map, wx, wz);
+    RepairFlowField(&field, &map, NULL, 0);
+    AddRepair(&totals, &field);
+  }
+  mismatches = CountMismatches(&field, &map, &reference, NULL, 0);
+  PrintRepair("wall toggle, full field", &totals, REPAIR_STEPS * 2, buildMs,
+              mismatches);
+
+  free(agents);
+  UnloadFlowField(&reference);
+  UnloadFlowField(&field);
+  free(map.data);
+}
+
+int main(int argc, char **argv) {
+  int builds = argc > 1 ? atoi(argv[1]) : 0;
+  SetLogLevel(LOG_LEVEL_WARN); // Keep log lines out of the table
+
+  printf("Flow field benchmark (%d%% random walls, 8-connected)\n",
+         WALL_PERCENT);
+  printf("%9s %7s %12s %12s %10s %10s %13s %10s\n", "cells", "builds",
+         "build ms", "worst ms", "lookup ns", "reachable", "walk rebuilds",
+         "ms/frame");
+
+  RunMap(32, 32, builds > 0 ? builds : 2000);
+  RunMap(1000, 1000, builds > 0 ? builds : 20);
+
+  printf("\nIncremental repair vs full rebuild (%d steps)\n", REPAIR_STEPS);
+  RunRepairs(32, 32);
+  RunRepairs(1000, 1000);
+  return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * Kitchen Knight - Job System Scaling Benchmark
+ * =============================================
+ * Runs the enemy and particle updates for a 50k horde on a large open level
+ * with 1..N workers, and checks every run ends bit-identical to the
+ * single-worker one. Runs without a window.
+ *
+ * Usage: kk_bench_jobs [frames] [max workers]
+ */
+
+#include "enemies/enemy_lod.h"
+#include "enemies/enemy_types.h"
+#include "game.h"
+#include "jobs.h"
+#include "logger.h"
+#include "particles.h"
+#include "sys_thread.h"
+#include "timer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DT (1.0f / 60.0f)
+#define BENCH_ENEMIES 50000
+#define BENCH_FRAMES 300
+#define LEVEL_CELLS 100 // Open level side, in map cells
+
+// Final state of the reference run
+static float refX[MAX_ENEMIES];
+static float refZ[MAX_ENEMIES];
+static uint8_t refState[MAX_ENEMIES];
+
+// ==========================================
+// SCENE
+// ==========================================
+
+static uint32_t rngState = 12345u;
+
+static float RandomRange(float min, float max) {
+  rngState = rngState * 1664525u + 1013904223u;
+  return min + (max - min) * (float)(rngState >> 8) / 16777216.0f;
+}
+
+static void SpawnHorde(float half) {
+  ResetEnemyPool();
+  rngState = 12345u;
+  Vector3 *positions = malloc(sizeof(Vector3) * BENCH_ENEMIES);
+  for (int i = 0; i < BENCH_ENEMIES; i++) {
+    positions[i] = (Vector3){RandomRange(-half, half), ENEMY_HEIGHT / 2.0f,
+                             RandomRange(-half, half)};
+  }
+  int third = BENCH_ENEMIES / 3;
+  SpawnEnemyWave(ENEMY_TOASTER, positions, third);
+  SpawnEnemyWave(ENEMY_BLENDER, positions + third, third);
+  SpawnEnemyWave(ENEMY_MICROWAVE, positions + 2 * third,
+                 BENCH_ENEMIES - 2 * third);
+  free(positions);
+
+  // Same LOD stagger for every run
+  EnemyLODConfig config = GetEnemyLODConfig();
+  SetEnemyLODConfig(&config);
+}
+
+// Player walks a slow circle so enemies keep switching states
+static Vector3 PlayerAt(int frame) {
+  float t = (float)frame * BENCH_DT * 0.5f;
+  return (Vector3){cosf(t) * 60.0f, PLAYER_HEIGHT, sinf(t) * 60.0f};
+}
+
+// ==========================================
+// RUNS
+// ==========================================
+
+// Average ns per simulated frame
+static double RunFrames(int frames) {
+  GameState game = {0};
+  InitParticleSystem();
+  uint64_t total = 0;
+  for (int f = 0; f < frames; f++) {
+    game.playerPos = PlayerAt(f);
+    if (f % 30 == 0)
+      SpawnExplosion(game.playerPos, ORANGE, 64);
+
+    uint64_t start = GetTimestampNs();
+    UpdateEnemies(&game, BENCH_DT);
+    UpdateParticles(BENCH_DT);
+    total += GetTimestampNs() - start;
+  }
+  return (double)total / frames;
+}
+
+static void SaveReference(void) {
+  memcpy(refX, enemyPool.posX, sizeof(refX));
+  memcpy(refZ, enemyPool.posZ, sizeof(refZ));
+  memcpy(refState, enemyPool.state, sizeof(refState));
+}
+
+// Largest position difference to the reference; states must match exactly
+static double CompareToReference(int *stateMismatches) {
+  double maxDiff = 0.0;
+  *stateMismatches = 0;
+  for (int i = 0; i < enemyHighWater; i++) {
+    maxDiff = fmax(maxDiff, fabs((double)enemyPool.posX[i] - refX[i]));
+    maxDiff = fmax(maxDiff, fabs((double)enemyPool.posZ[i] - refZ[i]));
+    if (enemyPool.state[i] != refState[i])
+      (*stateMismatches)++;
+  }
+  return maxDiff;
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : BENCH_FRAMES;
+  int maxWorkers = argc > 2 ? atoi(argv[2]) : GetCpuCount();
+  if (frames < 1)
+    frames = BENCH_FRAMES;
+  if (maxWorkers < 1)
+    maxWorkers = 1;
+  if (maxWorkers > JOB_MAX_WORKERS)
+    maxWorkers = JOB_MAX_WORKERS;
+  SetLogLevel(LOG_LEVEL_WARN); // Wave spawns would flood the table
+
+  LevelMap level = {.width = LEVEL_CELLS, .height = LEVEL_CELLS};
+  size_t cells = (size_t)LEVEL_CELLS * LEVEL_CELLS;
+  level.data = malloc(cells);
+  memset(level.data, CELL_EMPTY, cells);
+  SetEnemyLevel(&level);
+  float half = LEVEL_CELLS * MAP_CELL_SIZE / 2.0f - 1.0f;
+
+  printf("Job system scaling, %d enemies on a %dx%d level, %d frames, "
+         "%d CPU(s)\n",
+         BENCH_ENEMIES, LEVEL_CELLS, LEVEL_CELLS, frames, GetCpuCount());
+  printf("%8s %12s %9s %11s %11s %10s\n", "workers", "ms/frame", "speedup",
+         "efficiency", "max |dpos|", "state diff");
+
+  double baseNs = 0.0;
+  for (int workers = 1; workers <= maxWorkers; workers++) {
+    InitJobSystem(workers);
+    SpawnHorde(half);
+    double ns = RunFrames(frames);
+
+    int mismatches = 0;
+    double diff = 0.0;
+    if (workers == 1) {
+      baseNs = ns;
+      SaveReference();
+    } else {
+      diff = CompareToReference(&mismatches);
+    }
+
+    double speedup = baseNs / ns;
+    printf("%8d %12.3f %8.2fx %10.0f%% %11.2e %10d\n", GetJobWorkerCount(),
+           ns / 1.0e6, speedup, 100.0 * speedup / workers, diff, mismatches);
+  }
+
+  ShutdownJobSystem();
+  SetEnemyLevel(NULL);
+  free(level.data);
+  return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * Kitchen Knight - Particle Update Benchmark
+ * ==========================================
+ * Compares the original array-of-structs particle update (every slot
+ * scanned, dead ones skipped by flag) against the dense SoA pool and its
+ * SIMD kernels at several live counts. Runs without a window.
+ *
+ * Usage: kk_bench_particles [frames]
+ */
+
+#include "logger.h"
+#include "particles.h"
+#include "raymath.h"
+#include "simd.h"
+#include "timer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DT (1.0f / 60.0f)
+#define BENCH_WINDOW 20 // Frames per run; the shortest explosion lives 30
+
+// ==========================================
+// REFERENCE: ORIGINAL AoS UPDATE
+// ==========================================
+// Verbatim copy of the pre-SoA particle struct and update, kept here so the
+// comparison stays honest as the real pool evolves.
+
+typedef struct {
+  Vector3 position;
+  Vector3 prevPosition;
+  Vector3 velocity;
+  Color color;
+  float lifetime;
+  float maxLifetime;
+  float size;
+  bool active;
+} Particle;
+
+static Particle aosPool[MAX_PARTICLES];
+
+static void UpdateParticleRangeAoS(float dt, int begin, int end) {
+  for (int i = begin; i < end; i++) {
+    if (!aosPool[i].active)
+      continue;
+
+    Particle *p = &aosPool[i];
+
+    // Physics
+    p->position = Vector3Add(p->position, Vector3Scale(p->velocity, dt));
+    p->velocity.y -= 15.0f * dt; // Gravity
+
+    // Lifetime
+    p->lifetime -= dt;
+    if (p->lifetime <= 0) {
+      p->active = false;
+    }
+
+    // Floor collision
+    if (p->position.y < 0.1f) {
+      p->position.y = 0.1f;
+      p->velocity.y *= -0.3f; // Bounce
+      p->velocity.x *= 0.8f;
+      p->velocity.z *= 0.8f;
+    }
+  }
+}
+
+// ==========================================
+// SCENE SETUP
+// ==========================================
+
+static ParticlePool startPool; // Live particles every run starts from
+
+// One explosion of count particles, a metre up so the floor gets hit
+static void MakeScene(int count) {
+  SetRandomSeed(12345u);
+  InitParticleSystem();
+  SpawnExplosion((Vector3){0.0f, 1.0f, 0.0f}, ORANGE, count);
+  memcpy(&startPool, &particlePool, sizeof(startPool));
+}
+
+static void ResetSoA(void) {
+  memcpy(&particlePool, &startPool, sizeof(particlePool));
+}
+
+// Live particles packed at the front, as FindFreeSlot left them
+static void ResetAoS(void) {
+  memset(aosPool, 0, sizeof(aosPool));
+  for (int i = 0; i < startPool.count; i++) {
+    Vector3 pos = {startPool.posX[i], startPool.posY[i], startPool.posZ[i]};
+    aosPool[i] = (Particle){
+        .position = pos,
+        .prevPosition = pos,
+        .velocity = {startPool.velX[i], startPool.velY[i], startPool.velZ[i]},
+        .color = startPool.color[i],
+        .lifetime = startPool.lifetime[i],
+        .maxLifetime = startPool.maxLifetime[i],
+        .size = startPool.size[i],
+        .active = true};
+  }
+}
+
+// ==========================================
+// RUNS
+// ==========================================
+
+// Timed over runs windows of BENCH_WINDOW frames, reset between windows
+static double RunAoS(int runs) {
+  uint64_t total = 0;
+  for (int r = 0; r < runs; r++) {
+    ResetAoS();
+    uint64_t start = GetTimestampNs();
+    for (int f = 0; f < BENCH_WINDOW; f++)
+      UpdateParticleRangeAoS(BENCH_DT, 0, MAX_PARTICLES);
+    total += GetTimestampNs() - start;
+  }
+  return (double)total;
+}
+
+static double RunSoA(int runs) {
+  uint64_t total = 0;
+  for (int r = 0; r < runs; r++) {
+    ResetSoA();
+    uint64_t start = GetTimestampNs();
+    for (int f = 0; f < BENCH_WINDOW; f++)
+      UpdateParticles(BENCH_DT);
+    total += GetTimestampNs() - start;
+  }
+  return (double)total;
+}
+
+// Max position difference between the two layouts after identical frames.
+// Nothing dies inside a window, so slots still line up.
+static float CompareLayouts(int count) {
+  float maxDiff = 0.0f;
+  if (particlePool.count != count)
+    return INFINITY;
+  for (int i = 0; i < count; i++) {
+    float dx = fabsf(aosPool[i].position.x - particlePool.posX[i]);
+    float dy = fabsf(aosPool[i].position.y - particlePool.posY[i]);
+    float dz = fabsf(aosPool[i].position.z - particlePool.posZ[i]);
+    maxDiff = fmaxf(maxDiff, fmaxf(dx, fmaxf(dy, dz)));
+  }
+  return maxDiff;
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 0;
+  const int counts[] = {256, 4096, 32768, MAX_PARTICLES};
+  const int numCounts = (int)(sizeof(counts) / sizeof(counts[0]));
+  SimdLevel best = GetSimdLevel();
+  SetLogLevel(LOG_LEVEL_WARN); // Keep log lines out of the table
+
+  printf("Particle update benchmark (pool %d, best SIMD: %s)\n",
+         MAX_PARTICLES, GetSimdLevelName(best));
+  printf("%8s %8s %12s %12s %12s %12s %9s %10s\n", "live", "frames",
+         "AoS ns/p", "SoA-sc ns/p", "SSE2 ns/p", "AVX2 ns/p", "speedup",
+         "max |dpos|");
+
+  for (int c = 0; c < numCounts; c++) {
+    int count = counts[c];
+    // Aim for ~40M particle updates per run so small bursts are measurable
+    int runFrames = frames > 0 ? frames : 40000000 / count;
+    int runs = (runFrames + BENCH_WINDOW - 1) / BENCH_WINDOW;
+    if (runs < 3)
+      runs = 3;
+    runFrames = runs * BENCH_WINDOW;
+    double updates = (double)count * runFrames;
+
+    MakeScene(count);
+    double aosNs = RunAoS(runs) / updates;
+
+    double levelNs[3] = {0};
+    for (SimdLevel level = SIMD_SCALAR; level <= best; level++) {
+      SetSimdLevel(level);
+      levelNs[level] = RunSoA(runs) / updates;
+    }
+    SetSimdLevel(best);
+
+    // Lock-step correctness check: one window of each from the same start
+    RunAoS(1);
+    RunSoA(1);
+    float diff = CompareLayouts(count);
+
+    printf("%8d %8d %12.2f %12.2f %12.2f %12.2f %8.1fx %10.2e\n", count,
+           runFrames, aosNs, levelNs[SIMD_SCALAR],
+           best >= SIMD_SSE2 ? levelNs[SIMD_SSE2] : 0.0,
+           best >= SIMD_AVX2 ? levelNs[SIMD_AVX2] : 0.0,
+           aosNs / levelNs[best], diff);
+  }
+  return 0;
+}
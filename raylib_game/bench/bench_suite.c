@@ -0,0 +1,375 @@
+/**
+ * Kitchen Knight - Benchmark Suite
+ * ================================
+ * Repeatable timings for the simulation hot paths at several entity counts
+ * and map sizes: enemy AI, projectile collision, particle update and
+ * spawning, level loading and frustum culling. Every case times each call
+ * separately and reports percentiles and ns per entity (from the median),
+ * so one slow call shows up instead of vanishing into an average. Runs
+ * without a window; use it before and after every optimization.
+ *
+ * Usage: kk_bench [samples] [case filter]
+ *   e.g. kk_bench 1000 Particles
+ */
+
+#include "combat.h"
+#include "culling.h"
+#include "enemies/enemy_lod.h"
+#include "enemies/enemy_types.h"
+#include "game.h"
+#include "jobs.h"
+#include "logger.h"
+#include "map_loader.h"
+#include "particles.h"
+#include "simd.h"
+#include "spatial_grid.h"
+#include "timer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_SAMPLES 500
+#define BENCH_WARMUP 20
+#define LOAD_SAMPLES_MAX 30 // Level loads hit the disk; fewer is enough
+#define OPEN_LEVEL_CELLS 100
+#define BENCH_LEVEL_FILE "kk_bench_level.txt"
+
+// Projectile lanes run between rows of enemies placed this far apart, so
+// every step queries the grid but nothing dies mid-run
+#define TARGET_SPACING 4.0f
+#define TARGET_ROWS 100
+#define PROJECTILE_RESET 300 // Steps before refilling (lifetime is 3 s)
+#define PARTICLE_REFILL 50   // Steps before refilling (explosions last 0.5+ s)
+
+static int samples = BENCH_SAMPLES;
+static const char *filter = NULL;
+static uint64_t *sampleNs = NULL;
+
+// ==========================================
+// REPORTING
+// ==========================================
+
+static int CompareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static double PercentileUs(const uint64_t *sorted, int count, double p) {
+  int index = (int)ceil(p / 100.0 * count) - 1;
+  if (index < 0)
+    index = 0;
+  return sorted[index] / 1e3;
+}
+
+static void Report(const char *name, const char *variant, int entities,
+                   int count) {
+  qsort(sampleNs, (size_t)count, sizeof(uint64_t), CompareU64);
+  double p50 = PercentileUs(sampleNs, count, 50.0);
+  printf("%-16s %-14s %8d %9.2f %9.2f %9.2f %9.2f %10.2f\n", name, variant,
+         entities, p50, PercentileUs(sampleNs, count, 95.0),
+         PercentileUs(sampleNs, count, 99.0), sampleNs[count - 1] / 1e3,
+         entities > 0 ? p50 * 1e3 / entities : 0.0);
+}
+
+static bool Selected(const char *name) {
+  return !filter || strstr(name, filter) != NULL;
+}
+
+// ==========================================
+// SCENES
+// ==========================================
+
+static uint32_t rngState = 12345u;
+
+static float RandomRange(float min, float max) {
+  rngState = rngState * 1664525u + 1013904223u;
+  return min + (max - min) * (float)(rngState >> 8) / 16777216.0f;
+}
+
+// Open level with no inner walls, so the flow field covers it all
+static LevelMap MakeOpenLevel(int cells) {
+  LevelMap level = {.width = cells, .height = cells};
+  level.data = malloc((size_t)cells * (size_t)cells);
+  memset(level.data, CELL_EMPTY, (size_t)cells * (size_t)cells);
+  return level;
+}
+
+static void SpawnHorde(int count, float half) {
+  ResetEnemyPool();
+  rngState = 12345u;
+  Vector3 *positions = malloc(sizeof(Vector3) * (size_t)count);
+  for (int i = 0; i < count; i++) {
+    positions[i] = (Vector3){RandomRange(-half, half), ENEMY_HEIGHT / 2.0f,
+                             RandomRange(-half, half)};
+  }
+  int third = count / 3;
+  SpawnEnemyWave(ENEMY_TOASTER, positions, third);
+  SpawnEnemyWave(ENEMY_BLENDER, positions + third, third);
+  SpawnEnemyWave(ENEMY_MICROWAVE, positions + 2 * third, count - 2 * third);
+  free(positions);
+
+  // Same LOD stagger for every run
+  EnemyLODConfig config = GetEnemyLODConfig();
+  SetEnemyLODConfig(&config);
+}
+
+// ==========================================
+// CASES
+// ==========================================
+
+// One fixed step of enemy AI; the player circles so states keep changing
+static void BenchEnemies(const LevelMap *level, const char *variant,
+                         int count) {
+  float half = level ? level->width * MAP_CELL_SIZE / 2.0f - 1.0f : 24.0f;
+  SetEnemyLevel(level);
+  SpawnHorde(count, half);
+
+  GameState game = {0};
+  for (int s = -BENCH_WARMUP; s < samples; s++) {
+    float t = (float)(s + BENCH_WARMUP) * SIM_DT * 0.5f;
+    game.playerPos = (Vector3){cosf(t) * half * 0.5f, PLAYER_HEIGHT,
+                               sinf(t) * half * 0.5f};
+
+    uint64_t start = GetTimestampNs();
+    UpdateEnemies(&game, SIM_DT);
+    uint64_t ns = GetTimestampNs() - start;
+    RebuildEnemyGrid(); // Untimed, as StepGame does next
+    if (s >= 0)
+      sampleNs[s] = ns;
+  }
+  Report("UpdateEnemies", variant, count, samples);
+  SetEnemyLevel(NULL);
+}
+
+static void FireVolley(int count) {
+  InitCombat();
+  float half = TARGET_ROWS * TARGET_SPACING / 2.0f;
+  for (int i = 0; i < count; i++) {
+    int row = i % TARGET_ROWS;
+    float z = -half + row * TARGET_SPACING + TARGET_SPACING / 2.0f;
+    float x = -half + (float)(i / TARGET_ROWS) * 10.0f;
+    SpawnProjectile((Vector3){x, ENEMY_HEIGHT / 2.0f, z},
+                    (Vector3){1.0f, 0.0f, 0.0f}, 1);
+  }
+}
+
+// Projectile movement and grid collision inside UpdateCombat
+static void BenchProjectiles(int count) {
+  ResetEnemyPool();
+  float half = TARGET_ROWS * TARGET_SPACING / 2.0f;
+  static Vector3 targets[TARGET_ROWS * TARGET_ROWS];
+  for (int r = 0; r < TARGET_ROWS; r++) {
+    for (int c = 0; c < TARGET_ROWS; c++) {
+      targets[r * TARGET_ROWS + c] =
+          (Vector3){-half + c * TARGET_SPACING, ENEMY_HEIGHT / 2.0f,
+                    -half + r * TARGET_SPACING};
+    }
+  }
+  SpawnEnemyWave(ENEMY_TOASTER, targets, TARGET_ROWS * TARGET_ROWS);
+  RebuildEnemyGrid();
+
+  GameState game = {0}; // No legacy enemy, no input
+  InputFrame input = {.dt = SIM_DT};
+  int survivors = activeEnemyCount;
+  for (int s = -BENCH_WARMUP; s < samples; s++) {
+    if ((s + BENCH_WARMUP) % PROJECTILE_RESET == 0)
+      FireVolley(count);
+
+    uint64_t start = GetTimestampNs();
+    UpdateCombat(&game, &input, SIM_DT);
+    uint64_t ns = GetTimestampNs() - start;
+    if (s >= 0)
+      sampleNs[s] = ns;
+  }
+  Report("UpdateCombat", "projectiles", count, samples);
+  if (activeEnemyCount != survivors)
+    printf("  (warning: %d targets were hit)\n", survivors - activeEnemyCount);
+  ResetEnemyPool();
+}
+
+static void BenchParticleUpdate(int count) {
+  for (int s = -BENCH_WARMUP; s < samples; s++) {
+    if ((s + BENCH_WARMUP) % PARTICLE_REFILL == 0) {
+      InitParticleSystem();
+      SpawnExplosion((Vector3){0.0f, 2.0f, 0.0f}, ORANGE, count);
+    }
+
+    uint64_t start = GetTimestampNs();
+    UpdateParticles(SIM_DT);
+    uint64_t ns = GetTimestampNs() - start;
+    if (s >= 0)
+      sampleNs[s] = ns;
+  }
+  Report("UpdateParticles", "explosion", count, samples);
+}
+
+// Into an empty pool, or a full one where bursts recycle the oldest
+static void BenchExplosionSpawn(int count, bool full) {
+  InitParticleSystem();
+  if (full)
+    SpawnExplosion((Vector3){0.0f, 2.0f, 0.0f}, ORANGE, MAX_PARTICLES);
+  for (int s = -BENCH_WARMUP; s < samples; s++) {
+    if (full) {
+      // Age the pool so there is an oldest, and replace what died: only
+      // the timed bursts push it over the top
+      int live = particlePool.count;
+      UpdateParticles(SIM_DT);
+      SpawnExplosion((Vector3){0.0f, 2.0f, 0.0f}, ORANGE,
+                     live - particlePool.count);
+    } else {
+      InitParticleSystem();
+    }
+    uint64_t start = GetTimestampNs();
+    SpawnExplosion((Vector3){0.0f, 2.0f, 0.0f}, ORANGE, count);
+    uint64_t ns = GetTimestampNs() - start;
+    if (s >= 0)
+      sampleNs[s] = ns;
+  }
+  Report("SpawnExplosion", full ? "full pool" : "empty pool", count,
+         samples);
+}
+
+// Enemy-sized spheres scattered around a camera in the middle of the
+// arena, tested at one SIMD level
+static void BenchCullSpheres(int count, SimdLevel level) {
+  float *x = malloc(sizeof(float) * (size_t)count * 3);
+  uint8_t *visible = malloc((size_t)count);
+  float *y = x + count, *z = y + count;
+  rngState = 12345u;
+  for (int i = 0; i < count; i++) {
+    x[i] = RandomRange(-ARENA_SIZE, ARENA_SIZE);
+    y[i] = RandomRange(0.0f, WALL_HEIGHT);
+    z[i] = RandomRange(-ARENA_SIZE, ARENA_SIZE);
+  }
+  Camera3D camera = {{0.0f, PLAYER_HEIGHT, 0.0f},
+                     {1.0f, PLAYER_HEIGHT, 1.0f},
+                     {0.0f, 1.0f, 0.0f},
+                     75.0f,
+                     CAMERA_PERSPECTIVE};
+
+  SetSimdLevel(level);
+  for (int s = -BENCH_WARMUP; s < samples; s++) {
+    uint64_t start = GetTimestampNs();
+    BeginCullFrame(camera, 16.0f / 9.0f);
+    CullSpheres(CULL_ENEMIES, x, y, z, ENEMY_CULL_RADIUS, count, visible);
+    uint64_t ns = GetTimestampNs() - start;
+    if (s >= 0)
+      sampleNs[s] = ns;
+  }
+  SetSimdLevel(SIMD_AVX2); // Clamped back to the best available
+  Report("CullSpheres", GetSimdLevelName(level), count, samples);
+  free(x);
+  free(visible);
+}
+
+// Square map with a border, scattered walls and a start cell
+static bool WriteLevelFile(int cells) {
+  FILE *file = fopen(BENCH_LEVEL_FILE, "w");
+  if (!file)
+    return false;
+  rngState = 12345u;
+  for (int z = 0; z < cells; z++) {
+    for (int x = 0; x < cells; x++) {
+      bool border = x == 0 || z == 0 || x == cells - 1 || z == cells - 1;
+      char c = CELL_EMPTY;
+      if (border || RandomRange(0.0f, 1.0f) < 0.15f)
+        c = CELL_WALL;
+      else if (x == cells / 2 && z == cells / 2)
+        c = CELL_START;
+      fputc(c, file);
+    }
+    fputc('\n', file);
+  }
+  fclose(file);
+  return true;
+}
+
+static void BenchLoadLevel(int cells) {
+  if (!WriteLevelFile(cells)) {
+    printf("  (could not write %s)\n", BENCH_LEVEL_FILE);
+    return;
+  }
+
+  int count = samples < LOAD_SAMPLES_MAX ? samples : LOAD_SAMPLES_MAX;
+  for (int s = -1; s < count; s++) {
+    LevelMap level = {0};
+    uint64_t start = GetTimestampNs();
+    LoadLevel(BENCH_LEVEL_FILE, &level);
+    uint64_t ns = GetTimestampNs() - start;
+    UnloadLevel(&level);
+    if (s >= 0)
+      sampleNs[s] = ns;
+  }
+  remove(BENCH_LEVEL_FILE);
+
+  char variant[16];
+  snprintf(variant, sizeof(variant), "%dx%d", cells, cells);
+  Report("LoadLevel", variant, cells * cells, count);
+}
+
+// ==========================================
+// MAIN
+// ==========================================
+
+int main(int argc, char **argv) {
+  samples = argc > 1 ? atoi(argv[1]) : BENCH_SAMPLES;
+  filter = argc > 2 ? argv[2] : NULL;
+  if (samples < 1)
+    samples = BENCH_SAMPLES;
+  sampleNs = malloc(sizeof(uint64_t) * (size_t)samples);
+
+  SetLogLevel(LOG_LEVEL_WARN); // Level loads and spawns would flood the table
+  InitJobSystem(0);
+  InitEnemySystem();
+  InitParticleSystem();
+
+  printf("Kitchen Knight benchmark suite: %d samples per case, %d job "
+         "worker(s)\n",
+         samples, GetJobWorkerCount());
+  printf("%-16s %-14s %8s %9s %9s %9s %9s %10s\n", "case", "variant",
+         "entities", "p50 us", "p95 us", "p99 us", "max us", "ns/entity");
+
+  if (Selected("UpdateEnemies")) {
+    const int counts[] = {1000, 10000, 50000};
+    LevelMap open = MakeOpenLevel(OPEN_LEVEL_CELLS);
+    for (int c = 0; c < 3; c++)
+      BenchEnemies(NULL, "arena", counts[c]);
+    for (int c = 0; c < 3; c++)
+      BenchEnemies(&open, "open 100x100", counts[c]);
+    free(open.data);
+  }
+  if (Selected("UpdateCombat")) {
+    const int counts[] = {32, 64, MAX_PROJECTILES};
+    for (int c = 0; c < 3; c++)
+      BenchProjectiles(counts[c]);
+  }
+  if (Selected("UpdateParticles")) {
+    const int counts[] = {MAX_PARTICLES / 4, MAX_PARTICLES / 2, MAX_PARTICLES};
+    for (int c = 0; c < 3; c++)
+      BenchParticleUpdate(counts[c]);
+  }
+  if (Selected("SpawnExplosion")) {
+    const int counts[] = {16, 64, MAX_PARTICLES};
+    for (int c = 0; c < 3; c++)
+      BenchExplosionSpawn(counts[c], false);
+    for (int c = 0; c < 3; c++)
+      BenchExplosionSpawn(counts[c], true);
+  }
+  if (Selected("CullSpheres")) {
+    const int counts[] = {1000, 10000, MAX_ENEMIES};
+    for (int c = 0; c < 3; c++) {
+      for (int level = SIMD_SCALAR; level <= (int)GetSimdLevel(); level++)
+        BenchCullSpheres(counts[c], (SimdLevel)level);
+    }
+  }
+  if (Selected("LoadLevel")) {
+    const int sizes[] = {32, 64, 128, 256};
+    for (int c = 0; c < 4; c++)
+      BenchLoadLevel(sizes[c]);
+  }
+
+  ShutdownJobSystem();
+  free(sampleNs);
+  return 0;
+}
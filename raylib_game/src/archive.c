@@ -0,0 +1,339 @@
+/**
+ * Kitchen Knight - Asset Archive Implementation
+ * =============================================
+ * Layout, integers little-endian:
+ *   "KKPK" version count root[64]
+ *   count x { name[64] type params[4] offset(u64) size(u64) }
+ *   entry data, each starting on a 64-byte boundary
+ * The index is parsed once at open; lookups are a linear scan, which is
+ * nothing next to a file open at a few dozen entries. If mapping fails the
+ * file is read into memory instead and everything else works the same.
+ */
+
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // mmap on glibc in strict C modes
+#endif
+
+#include "archive.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+// Keep windows.h out of the way of raylib's symbols
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define ARCHIVE_MAGIC "KKPK"
+#define ARCHIVE_VERSION 1u
+#define ARCHIVE_ALIGN 64
+#define HEADER_BYTES (4 + 4 + 4 + ARCHIVE_NAME_MAX)
+#define ENTRY_BYTES (ARCHIVE_NAME_MAX + 4 + 16 + 8 + 8)
+
+static const unsigned char *fileData = NULL;
+static size_t fileSize = 0;
+static bool mapped = false; // fileData is a mapping (else malloc'd)
+static ArchiveEntry *entries = NULL;
+static int entryCount = 0;
+static char root[ARCHIVE_NAME_MAX];
+
+// ==========================================
+// MAPPING
+// ==========================================
+
+static bool MapFile(const char *path) {
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  HANDLE mapping = NULL;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (!mapping)
+    return false;
+  fileData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping); // The view keeps it alive
+  fileSize = (size_t)size.QuadPart;
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  void *view = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+    view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (view == MAP_FAILED)
+    return false;
+  fileData = view;
+  fileSize = (size_t)st.st_size;
+#endif
+  mapped = fileData != NULL;
+  return mapped;
+}
+
+static bool ReadWholeFile(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (!file)
+    return false;
+  unsigned char *data = NULL;
+  long size = -1;
+  if (fseek(file, 0, SEEK_END) == 0)
+    size = ftell(file);
+  if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+    data = malloc((size_t)size);
+    if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+      free(data);
+      data = NULL;
+    }
+  }
+  fclose(file);
+  fileData = data;
+  fileSize = data ? (size_t)size : 0;
+  return data != NULL;
+}
+
+static void ReleaseFile(void) {
+  if (mapped) {
+#if defined(_WIN32)
+    UnmapViewOfFile(fileData);
+#else
+    munmap((void *)fileData, fileSize);
+#endif
+  } else {
+    free((void *)fileData);
+  }
+  fileData = NULL;
+  fileSize = 0;
+  mapped = false;
+}
+
+// ==========================================
+// READING
+// ==========================================
+
+static uint32_t GetU32(const unsigned char *p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+         (uint32_t)p[3] << 24;
+}
+
+static uint64_t GetU64(const unsigned char *p) {
+  return (uint64_t)GetU32(p) | (uint64_t)GetU32(p + 4) << 32;
+}
+
+// Enough bytes behind the entry for what its params describe
+static bool IsEntryComplete(const ArchiveEntry *e) {
+  const uint32_t *p = e->params;
+  switch (e->type) {
+  case ARCHIVE_IMAGE: {
+    // Every mip level LoadTextureFromImage will read
+    if (p[0] == 0 || p[1] == 0 || p[3] > 32)
+      return false;
+    uint64_t bytes = 0;
+    int width = (int)p[0], height = (int)p[1];
+    for (uint32_t level = 0; level < (p[3] ? p[3] : 1); level++) {
+      int levelBytes = GetPixelDataSize(width, height, (int)p[2]);
+      if (levelBytes <= 0)
+        return false;
+      bytes += (uint64_t)levelBytes;
+      width = width > 1 ? width / 2 : 1;
+      height = height > 1 ? height / 2 : 1;
+    }
+    return bytes <= e->size;
+  }
+  case ARCHIVE_WAVE:
+    return (uint64_t)p[0] * p[3] * (p[2] / 8) <= e->size;
+  case ARCHIVE_SPRITE:
+  case ARCHIVE_RAW:
+    return true;
+  }
+  return false;
+}
+
+static bool ParseIndex(void) {
+  if (fileSize < HEADER_BYTES || memcmp(fileData, ARCHIVE_MAGIC, 4) != 0 ||
+      GetU32(fileData + 4) != ARCHIVE_VERSION)
+    return false;
+  uint32_t count = GetU32(fileData + 8);
+  if (count > (fileSize - HEADER_BYTES) / ENTRY_BYTES)
+    return false;
+  memcpy(root, fileData + 12, ARCHIVE_NAME_MAX);
+  if (root[ARCHIVE_NAME_MAX - 1] != '\0')
+    return false;
+
+  entries = calloc(count ? count : 1, sizeof(ArchiveEntry));
+  if (!entries)
+    return false;
+  const unsigned char *p = fileData + HEADER_BYTES;
+  for (uint32_t i = 0; i < count; i++, p += ENTRY_BYTES) {
+    ArchiveEntry *e = &entries[i];
+    memcpy(e->name, p, ARCHIVE_NAME_MAX);
+    e->type = (ArchiveEntryType)GetU32(p + ARCHIVE_NAME_MAX);
+    for (int k = 0; k < 4; k++)
+      e->params[k] = GetU32(p + ARCHIVE_NAME_MAX + 4 + 4 * k);
+    uint64_t offset = GetU64(p + ARCHIVE_NAME_MAX + 20);
+    e->size = GetU64(p + ARCHIVE_NAME_MAX + 28);
+    e->data = fileData + offset;
+    if (e->name[ARCHIVE_NAME_MAX - 1] != '\0' || e->type > ARCHIVE_SPRITE ||
+        offset > fileSize || e->size > fileSize - offset ||
+        !IsEntryComplete(e))
+      return false;
+  }
+  entryCount = (int)count;
+  return true;
+}
+
+bool OpenAssetArchive(const char *path) {
+  CloseAssetArchive();
+  if (!MapFile(path) && !ReadWholeFile(path))
+    return false;
+  if (!ParseIndex()) {
+    printf("[Archive] ERROR: %s is damaged or from another version\n", path);
+    CloseAssetArchive();
+    return false;
+  }
+  printf("[Archive] %s: %d entries, %.1f MB %s\n", path, entryCount,
+         fileSize / (1024.0 * 1024.0), mapped ? "mapped" : "read");
+  return true;
+}
+
+void CloseAssetArchive(void) {
+  free(entries);
+  entries = NULL;
+  entryCount = 0;
+  root[0] = '\0';
+  ReleaseFile();
+}
+
+bool IsAssetArchiveOpen(void) { return fileData != NULL && entries != NULL; }
+
+bool IsArchivedPath(const char *path) {
+  size_t length = strlen(root);
+  return IsAssetArchiveOpen() && length > 0 &&
+         strncmp(path, root, length) == 0;
+}
+
+// ==========================================
+// LOOKUPS
+// ==========================================
+
+const ArchiveEntry *FindArchiveEntry(const char *name, ArchiveEntryType type) {
+  for (int i = 0; i < entryCount; i++)
+    if (entries[i].type == type && strcmp(entries[i].name, name) == 0)
+      return &entries[i];
+  return NULL;
+}
+
+bool GetArchiveImage(const char *name, Image *image) {
+  const ArchiveEntry *e = FindArchiveEntry(name, ARCHIVE_IMAGE);
+  if (!e)
+    return false;
+  *image = (Image){.data = (void *)e->data,
+                   .width = (int)e->params[0],
+                   .height = (int)e->params[1],
+                   .format = (int)e->params[2],
+                   .mipmaps = e->params[3] ? (int)e->params[3] : 1};
+  return true;
+}
+
+bool GetArchiveWave(const char *name, Wave *wave) {
+  const ArchiveEntry *e = FindArchiveEntry(name, ARCHIVE_WAVE);
+  if (!e)
+    return false;
+  *wave = (Wave){.frameCount = e->params[0],
+                 .sampleRate = e->params[1],
+                 .sampleSize = e->params[2],
+                 .channels = e->params[3],
+                 .data = (void *)e->data};
+  return true;
+}
+
+const unsigned char *GetArchiveFile(const char *name, int *size) {
+  const ArchiveEntry *e = FindArchiveEntry(name, ARCHIVE_RAW);
+  if (!e || e->size > INT32_MAX)
+    return NULL;
+  *size = (int)e->size;
+  return e->data;
+}
+
+// ==========================================
+// WRITING
+// ==========================================
+// Byte by byte, so archives move between machines and compilers
+
+static void WriteU32(FILE *file, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void WriteU64(FILE *file, uint64_t value) {
+  WriteU32(file, (uint32_t)value);
+  WriteU32(file, (uint32_t)(value >> 32));
+}
+
+static void WriteName(FILE *file, const char *name) {
+  char padded[ARCHIVE_NAME_MAX] = {0};
+  strncpy(padded, name, ARCHIVE_NAME_MAX - 1);
+  fwrite(padded, 1, sizeof(padded), file);
+}
+
+static uint64_t AlignUp(uint64_t offset) {
+  return (offset + ARCHIVE_ALIGN - 1) / ARCHIVE_ALIGN * ARCHIVE_ALIGN;
+}
+
+bool WriteAssetArchive(const char *path, const char *packedRoot,
+                       const ArchiveEntry *list, int count) {
+  for (int i = 0; i < count; i++) {
+    if (strlen(list[i].name) >= ARCHIVE_NAME_MAX) {
+      printf("[Archive] ERROR: Name too long: %s\n", list[i].name);
+      return false;
+    }
+  }
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    printf("[Archive] ERROR: Can't write %s\n", path);
+    return false;
+  }
+
+  fwrite(ARCHIVE_MAGIC, 1, 4, file);
+  WriteU32(file, ARCHIVE_VERSION);
+  WriteU32(file, (uint32_t)count);
+  WriteName(file, packedRoot);
+
+  uint64_t offset = (uint64_t)HEADER_BYTES + (uint64_t)count * ENTRY_BYTES;
+  for (int i = 0; i < count; i++) {
+    offset = AlignUp(offset);
+    WriteName(file, list[i].name);
+    WriteU32(file, (uint32_t)list[i].type);
+    for (int k = 0; k < 4; k++)
+      WriteU32(file, list[i].params[k]);
+    WriteU64(file, offset);
+    WriteU64(file, list[i].size);
+    offset += list[i].size;
+  }
+
+  static const unsigned char zeros[ARCHIVE_ALIGN] = {0};
+  uint64_t written = (uint64_t)HEADER_BYTES + (uint64_t)count * ENTRY_BYTES;
+  for (int i = 0; i < count; i++) {
+    uint64_t start = AlignUp(written);
+    fwrite(zeros, 1, (size_t)(start - written), file);
+    if (list[i].size > 0)
+      fwrite(list[i].data, 1, (size_t)list[i].size, file);
+    written = start + list[i].size;
+  }
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
@@ -0,0 +1,65 @@
+/**
+ * Kitchen Knight - Asset Archive
+ * ==============================
+ * One file holding the assets directory ready to use: images as raw
+ * pixels in their GPU format, sounds as PCM, the sprite atlas already
+ * packed, and everything else (levels, PVS, music) as the original bytes.
+ * The file is memory-mapped and entries point straight into the mapping,
+ * so a texture uploads from the mapped pages with no decode and no copy.
+ * kk_pack writes it:
+ *
+ *   OpenAssetArchive(ASSET_ARCHIVE_FILE);     // Before loading assets
+ *   Image image;
+ *   if (GetArchiveImage("assets/tile_floor.png", &image))
+ *     texture = LoadTextureFromImage(image);  // Don't unload image
+ *
+ * While it's open, the archive is the whole of the directory it was packed
+ * from: IsArchivedPath paths it lacks are missing, without a disk probe.
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ASSET_ARCHIVE_FILE "assets.kkpak"
+#define ARCHIVE_NAME_MAX 64 // Entry names and the packed root, with NUL
+
+typedef enum {
+  ARCHIVE_RAW,    // Bytes of the original file
+  ARCHIVE_IMAGE,  // params: width, height, pixel format, mipmaps
+  ARCHIVE_WAVE,   // params: frame count, sample rate, sample size, channels
+  ARCHIVE_SPRITE, // params: x, y, width, height in the atlas image
+} ArchiveEntryType;
+
+typedef struct {
+  char name[ARCHIVE_NAME_MAX]; // Path as the game asks for it
+  ArchiveEntryType type;
+  uint32_t params[4];
+  const unsigned char *data; // Into the mapping (writing: caller's bytes)
+  uint64_t size;
+} ArchiveEntry;
+
+// Map the archive; false (and nothing open) if it is missing or damaged
+bool OpenAssetArchive(const char *path);
+// Pointers handed out become invalid; unload what came from it first
+void CloseAssetArchive(void);
+bool IsAssetArchiveOpen(void);
+
+// True if path lies under the directory the open archive was packed from
+bool IsArchivedPath(const char *path);
+
+const ArchiveEntry *FindArchiveEntry(const char *name, ArchiveEntryType type);
+
+// Views of mapped entries: don't unload them
+bool GetArchiveImage(const char *name, Image *image);
+bool GetArchiveWave(const char *name, Wave *wave);
+const unsigned char *GetArchiveFile(const char *name, int *size);
+
+// Write an archive of these entries, packed from the directory root
+bool WriteAssetArchive(const char *path, const char *root,
+                       const ArchiveEntry *entries, int count);
+
+#endif // ARCHIVE_H
@@ -5,38 +5,52 @@
  */
 
 #include "arena.h"
+#include "assets.h"
+#include "level_mesh.h"
+#include "profiler.h"
 #include <stdio.h>
 
 // Colors (matching Python version)
 static const Color FLOOR_COLOR = {80, 140, 80, 255}; // Green
 static const Color WALL_COLOR = {160, 100, 60, 255}; // Brown
 
-static Texture2D floorTexture;
+static const Texture2D *floorTexture = NULL; // Id 0 until it lands
 static Model floorModel;
 static bool arenaAssetsLoaded = false;
+static LevelMesh wallMesh = {0}; // The four walls, baked
 
 // ==========================================
 // INITIALIZATION
 // ==========================================
 
 void InitArena(void) {
-  floorTexture = LoadTexture("assets/tile_floor.png");
-  if (floorTexture.id > 0) {
-    // Create a model for the floor
-    Mesh mesh = GenMeshCube(ARENA_SIZE, 0.1f, ARENA_SIZE);
-    floorModel = LoadModelFromMesh(mesh);
-    // Assign texture to model
-    floorModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = floorTexture;
-
-    arenaAssetsLoaded = true;
-    printf("[Arena] Loaded floor texture and created model\n");
-  }
+  floorTexture = AcquireTexture("assets/tile_floor.png"); // Tiled, no atlas
+
+  // Create a model for the floor; DrawFloor gives it the texture once the
+  // texture has loaded
+  Mesh mesh = GenMeshCube(ARENA_SIZE, 0.1f, ARENA_SIZE);
+  floorModel = LoadModelFromMesh(mesh);
+  arenaAssetsLoaded = true;
+  printf("[Arena] Created floor model\n");
+
+  float half = ARENA_SIZE / 2.0f;
+  float thick = WALL_THICKNESS / 2.0f;
+  BoundingBox walls[4] = {
+      {{-half, 0.0f, half - thick}, {half, WALL_HEIGHT, half + thick}},
+      {{-half, 0.0f, -half - thick}, {half, WALL_HEIGHT, -half + thick}},
+      {{half - thick, 0.0f, -half}, {half + thick, WALL_HEIGHT, half}},
+      {{-half - thick, 0.0f, -half}, {-half + thick, WALL_HEIGHT, half}},
+  };
+  BuildBoxMesh(&wallMesh, walls, 4, true);
 }
 
 void UnloadArena(void) {
+  UnloadLevelMesh(&wallMesh);
   if (arenaAssetsLoaded) {
-    UnloadModel(floorModel);
-    UnloadTexture(floorTexture);
+    UnloadModel(floorModel); // Leaves the texture to the cache
+    ReleaseTexture(floorTexture);
+    floorTexture = NULL;
+    arenaAssetsLoaded = false;
   }
 }
 
@@ -45,11 +59,12 @@ void UnloadArena(void) {
 // ==========================================
 
 void DrawFloor(void) {
-  if (arenaAssetsLoaded) {
+  if (arenaAssetsLoaded && floorTexture->id > 0) {
     // Draw the textured floor model
+    floorModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = *floorTexture;
     DrawModel(floorModel, (Vector3){0.0f, -0.05f, 0.0f}, 1.0f, WHITE);
   } else {
-    // Fallback to plane if texture not loaded
+    // Fallback to plane until the texture has loaded
     DrawPlane((Vector3){0.0f, 0.0f, 0.0f}, (Vector2){ARENA_SIZE, ARENA_SIZE},
               FLOOR_COLOR);
   }
@@ -60,6 +75,11 @@ void DrawFloor(void) {
 // ==========================================
 
 void DrawWalls(void) {
+  if (wallMesh.faceCount > 0) { // Baked in InitArena; cubes otherwise
+    DrawLevelMesh(&wallMesh, WALL_COLOR, DARKGRAY);
+    return;
+  }
+
   float halfArena = ARENA_SIZE / 2.0f; // 25.0
   float wallY = WALL_HEIGHT / 2.0f;    // Center of wall height
 
@@ -93,6 +113,8 @@ void DrawWalls(void) {
 // ==========================================
 
 void DrawArena(void) {
+  PROFILE_BEGIN(zone, "DrawArena");
   DrawFloor();
   DrawWalls();
+  PROFILE_END(zone);
 }
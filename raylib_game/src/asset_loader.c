@@ -0,0 +1,226 @@
+/**
+ * Kitchen Knight - Async Asset Loader Implementation
+ * ==================================================
+ * A ring of loads under one mutex. Loader threads take them in queue
+ * order and decode outside the lock; the main thread finishes whichever
+ * are decoded, so a slow decode doesn't hold up the ones behind it. A slot
+ * is reused only once the head has moved past it.
+ */
+
+#include "asset_loader.h"
+#include "profiler.h"
+#include "sys_thread.h"
+#include "timer.h"
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum {
+  LOAD_QUEUED,
+  LOAD_DECODING, // On a loader thread
+  LOAD_DECODED,  // Waiting for the main thread
+  LOAD_FINISHED, // Slot free once the head passes it
+} LoadState;
+
+typedef struct {
+  AssetDecodeFn decode;
+  AssetFinishFn finish;
+  void *request;
+  bool ok;
+  LoadState state;
+} Load;
+
+#define SLOT(i) (&queue[(i) % ASSET_LOAD_QUEUE_SIZE])
+
+static SysThread *threads[ASSET_LOADER_MAX_THREADS];
+static int threadCount = 0; // 0: loads run on the spot
+static SysMutex *mutex = NULL;
+static SysCond *workCond = NULL; // Loads queued, or quitting
+static SysCond *doneCond = NULL; // A decode finished
+
+// Guarded by mutex
+static Load queue[ASSET_LOAD_QUEUE_SIZE];
+static unsigned head = 0; // Oldest load not finished
+static unsigned next = 0; // Next to decode
+static unsigned tail = 0; // Next free slot
+static bool quitting = false;
+
+// ==========================================
+// LOADER THREADS
+// ==========================================
+
+static void LoaderMain(void *arg) {
+  char name[16];
+  snprintf(name, sizeof(name), "Loader %d", (int)(intptr_t)arg);
+  SetProfileThreadName(name);
+
+  LockSysMutex(mutex);
+  for (;;) {
+    while (!quitting && next == tail)
+      WaitSysCond(workCond, mutex);
+    if (next == tail)
+      break; // Quitting with nothing left to decode
+    Load *load = SLOT(next++);
+    load->state = LOAD_DECODING;
+    UnlockSysMutex(mutex);
+
+    PROFILE_BEGIN(zone, "DecodeAsset");
+    bool ok = load->decode(load->request);
+    PROFILE_END(zone);
+
+    LockSysMutex(mutex);
+    load->ok = ok;
+    load->state = LOAD_DECODED;
+    BroadcastSysCond(doneCond);
+  }
+  UnlockSysMutex(mutex);
+}
+
+// ==========================================
+// LIFECYCLE
+// ==========================================
+
+static void DestroySync(void) {
+  if (doneCond)
+    DestroySysCond(doneCond);
+  if (workCond)
+    DestroySysCond(workCond);
+  if (mutex)
+    DestroySysMutex(mutex);
+  doneCond = NULL;
+  workCond = NULL;
+  mutex = NULL;
+}
+
+bool InitAssetLoader(int count) {
+  ShutdownAssetLoader();
+  if (count <= 0)
+    count = GetCpuCount() - 1;
+  if (count < 1)
+    count = 1;
+  if (count > ASSET_LOADER_MAX_THREADS)
+    count = ASSET_LOADER_MAX_THREADS;
+
+  mutex = CreateSysMutex();
+  workCond = CreateSysCond();
+  doneCond = CreateSysCond();
+  if (!mutex || !workCond || !doneCond) {
+    printf("[Loader] ERROR: Could not create the queue signals\n");
+    DestroySync();
+    return false;
+  }
+  head = next = tail = 0;
+  quitting = false;
+
+  for (int t = 0; t < count; t++) {
+    threads[t] = CreateSysThread(LoaderMain, (void *)(intptr_t)t);
+    if (!threads[t]) {
+      printf("[Loader] WARNING: Started only %d of %d threads\n", t, count);
+      break;
+    }
+    threadCount = t + 1;
+  }
+  if (threadCount == 0) {
+    DestroySync();
+    return false;
+  }
+  printf("[Loader] %d loader thread(s)\n", threadCount);
+  return threadCount == count;
+}
+
+void ShutdownAssetLoader(void) {
+  if (threadCount == 0)
+    return;
+  FinishAssetLoads();
+
+  LockSysMutex(mutex);
+  quitting = true;
+  BroadcastSysCond(workCond);
+  UnlockSysMutex(mutex);
+  for (int t = 0; t < threadCount; t++) {
+    JoinSysThread(threads[t]);
+    threads[t] = NULL;
+  }
+  threadCount = 0;
+  DestroySync();
+}
+
+// ==========================================
+// QUEUE
+// ==========================================
+
+void QueueAssetLoad(AssetDecodeFn decode, AssetFinishFn finish,
+                    void *request) {
+  if (threadCount > 0) {
+    LockSysMutex(mutex);
+    bool queued = tail - head < ASSET_LOAD_QUEUE_SIZE;
+    if (queued) {
+      *SLOT(tail++) = (Load){decode, finish, request, false, LOAD_QUEUED};
+      BroadcastSysCond(workCond);
+    }
+    UnlockSysMutex(mutex);
+    if (queued)
+      return;
+  }
+  finish(request, decode(request));
+}
+
+int PumpAssetLoads(double budgetMs) {
+  if (threadCount == 0)
+    return 0;
+  PROFILE_BEGIN(zone, "PumpAssetLoads");
+  uint64_t start = GetTimestampNs();
+  int finished = 0;
+
+  LockSysMutex(mutex);
+  unsigned i = head;
+  while (i != tail) {
+    Load *load = SLOT(i);
+    if (load->state != LOAD_DECODED) {
+      i++;
+      continue;
+    }
+    load->state = LOAD_FINISHED;
+    UnlockSysMutex(mutex);
+    load->finish(load->request, load->ok);
+    finished++;
+    LockSysMutex(mutex);
+
+    // Finishing may have queued more; rescan from the new head
+    while (head != tail && SLOT(head)->state == LOAD_FINISHED)
+      head++;
+    i = head;
+    if (budgetMs > 0.0 && NsToMs(GetTimestampNs() - start) >= budgetMs)
+      break;
+  }
+  UnlockSysMutex(mutex);
+  PROFILE_END(zone);
+  return finished;
+}
+
+void FinishAssetLoads(void) {
+  if (threadCount == 0)
+    return;
+  LockSysMutex(mutex);
+  while (head != tail) {
+    bool decoded = false;
+    for (unsigned i = head; i != tail && !decoded; i++)
+      decoded = SLOT(i)->state == LOAD_DECODED;
+    if (!decoded) {
+      WaitSysCond(doneCond, mutex);
+      continue;
+    }
+    UnlockSysMutex(mutex);
+    PumpAssetLoads(0.0);
+    LockSysMutex(mutex);
+  }
+  UnlockSysMutex(mutex);
+}
+
+int GetPendingAssetLoads(void) {
+  if (threadCount == 0)
+    return 0;
+  LockSysMutex(mutex);
+  int pending = (int)(tail - head);
+  UnlockSysMutex(mutex);
+  return pending;
+}
@@ -0,0 +1,50 @@
+/**
+ * Kitchen Knight - Async Asset Loader
+ * ===================================
+ * Loads in two halves so startup doesn't wait on I/O. A few background
+ * threads read and decode files into CPU memory; the main thread finishes
+ * them (GPU uploads, audio buffers, anything touching game state) a few
+ * milliseconds' worth per frame. Until a load finishes, whoever asked for
+ * it draws its placeholder; finishing swaps the real thing in place.
+ *
+ *   QueueAssetLoad(DecodeImage, UploadImage, request); // Main thread
+ *   PumpAssetLoads(ASSET_UPLOAD_BUDGET_MS);            // Once per frame
+ *
+ * Without InitAssetLoader (headless runs, tools) a queued load decodes and
+ * finishes on the spot.
+ */
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <stdbool.h>
+
+#define ASSET_LOAD_QUEUE_SIZE 64    // Loads in flight; more run on the spot
+#define ASSET_LOADER_MAX_THREADS 4
+#define ASSET_UPLOAD_BUDGET_MS 2.0  // Main-thread finishing time per frame
+
+// Background thread: read and decode into the request. No raylib calls
+// that need the window or audio device, and no game state.
+typedef bool (*AssetDecodeFn)(void *request);
+// Main thread: upload what decode produced (ok is its result), swap it in
+// and free the request
+typedef void (*AssetFinishFn)(void *request, bool ok);
+
+// threadCount 0 means one per spare CPU, up to ASSET_LOADER_MAX_THREADS
+bool InitAssetLoader(int threadCount);
+// Finishes everything queued, then stops the threads
+void ShutdownAssetLoader(void);
+
+// Main thread only (finish functions may queue more)
+void QueueAssetLoad(AssetDecodeFn decode, AssetFinishFn finish,
+                    void *request);
+
+// Finish decoded loads until budgetMs has gone (at least one when any is
+// ready; 0 means all of them). Returns how many finished.
+int PumpAssetLoads(double budgetMs);
+// Block until every queued load has finished, including ones queued by
+// finishing others
+void FinishAssetLoads(void);
+int GetPendingAssetLoads(void);
+
+#endif // ASSET_LOADER_H
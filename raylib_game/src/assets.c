@@ -0,0 +1,452 @@
+/**
+ * Kitchen Knight - Asset Cache Implementation
+ * ===========================================
+ * A small fixed table keyed by path; the atlas is an entry like any other,
+ * with the atlas itself holding one reference. An atlas baked into the
+ * asset archive is used as is; otherwise packing is shelf packing,
+ * tallest first, into the smallest power-of-two square that fits. Sprites
+ * butt up against each other with no padding: textures are point-sampled
+ * (raylib's default) without mipmaps, so neighbours never bleed in.
+ *
+ * Entries and sprite slots are what callers hold pointers to. Decoding and
+ * packing run on loader threads; the finish callbacks, on the main thread,
+ * upload and fill the entries in, then point waiting sprites at them.
+ */
+
+#include "assets.h"
+#include "archive.h"
+#include "asset_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char *const gameSprites[] = {
+    "assets/toster.png", "assets/blender_sprite.png",
+    "assets/microwave_sprite.png", "assets/spatula_hand.png",
+    "assets/knight.png"};
+const int gameSpriteCount = sizeof(gameSprites) / sizeof(gameSprites[0]);
+
+typedef struct {
+  char path[ASSET_PATH_MAX];
+  Texture2D texture; // Id 0 until the upload lands
+  int refs;
+  bool loading; // Keeps the slot, even at 0 refs, until the load lands
+} CachedTexture;
+
+// A sprite handed out, and the entry it draws from: the atlas, or the
+// sprite's own texture
+typedef struct {
+  char path[ASSET_PATH_MAX];
+  AtlasSprite sprite;
+  int refs;
+  CachedTexture *owner; // Holds one reference; NULL if it couldn't load
+} SpriteSlot;
+
+typedef struct {
+  char path[ASSET_PATH_MAX];
+  Rectangle source;
+} AtlasRegion;
+
+// One load in flight, owned by the loader until it finishes
+typedef struct {
+  CachedTexture *entry;
+  char path[ASSET_PATH_MAX];
+  Image image;
+  bool decoded; // image is ours to unload (else a view of the archive)
+} TextureLoad;
+
+typedef struct {
+  CachedTexture *entry;
+  char paths[ATLAS_MAX_SPRITES][ASSET_PATH_MAX];
+  const char *names[ATLAS_MAX_SPRITES]; // Into paths
+  int count;
+  Image sheet;
+  Rectangle sources[ATLAS_MAX_SPRITES];
+  bool archived; // sheet is a view of the archive
+} AtlasLoad;
+
+static CachedTexture cache[ASSET_CACHE_SIZE];
+static SpriteSlot sprites[ASSET_SPRITE_SLOTS];
+static AtlasRegion regions[ATLAS_MAX_SPRITES]; // Once the atlas has landed
+static int regionCount = 0;
+static CachedTexture *atlas = NULL; // Loading or loaded
+static const Texture2D noTexture = {0};
+static const AtlasSprite noSprite = {0};
+
+// ==========================================
+// CACHE
+// ==========================================
+
+static CachedTexture *FindByPath(const char *path) {
+  for (int i = 0; i < ASSET_CACHE_SIZE; i++)
+    if (cache[i].refs > 0 && strcmp(cache[i].path, path) == 0)
+      return &cache[i];
+  return NULL;
+}
+
+// Takes the first reference; NULL when the table is full or the path is
+// too long to key on
+static CachedTexture *AddEntry(const char *path) {
+  if (strlen(path) >= ASSET_PATH_MAX)
+    return NULL;
+  for (int i = 0; i < ASSET_CACHE_SIZE; i++) {
+    if (cache[i].refs == 0 && !cache[i].loading) {
+      cache[i] = (CachedTexture){.refs = 1};
+      snprintf(cache[i].path, sizeof(cache[i].path), "%s", path);
+      return &cache[i];
+    }
+  }
+  return NULL;
+}
+
+static void ReleaseEntry(CachedTexture *entry) {
+  if (--entry->refs > 0 || entry->loading)
+    return; // A load in flight clears it when it lands
+  if (entry->texture.id > 0)
+    UnloadTexture(entry->texture);
+  *entry = (CachedTexture){0};
+}
+
+// Point the sprites drawing entry's own texture at it, now it has landed
+static void RefreshSprites(const CachedTexture *entry) {
+  for (int s = 0; s < ASSET_SPRITE_SLOTS; s++) {
+    if (sprites[s].refs > 0 && sprites[s].owner == entry)
+      sprites[s].sprite = (AtlasSprite){
+          entry->texture, (Rectangle){0.0f, 0.0f, (float)entry->texture.width,
+                                      (float)entry->texture.height}};
+  }
+}
+
+// Loader thread. Packed pixels upload as they are; paths the archive owns
+// but lacks don't exist.
+static bool DecodeTexture(void *request) {
+  TextureLoad *load = request;
+  if (GetArchiveImage(load->path, &load->image))
+    return true;
+  if (IsArchivedPath(load->path))
+    return false;
+  load->image = LoadImage(load->path);
+  load->decoded = true;
+  return IsImageValid(load->image);
+}
+
+static void FinishTexture(void *request, bool ok) {
+  TextureLoad *load = request;
+  CachedTexture *entry = load->entry;
+  entry->loading = false;
+  if (ok && entry->refs > 0)
+    entry->texture = LoadTextureFromImage(load->image);
+  if (load->decoded)
+    UnloadImage(load->image);
+
+  if (entry->refs == 0)
+    *entry = (CachedTexture){0}; // Released before it landed
+  else if (entry->texture.id == 0)
+    printf("[Assets] WARNING: Couldn't load %s\n", entry->path);
+  else
+    RefreshSprites(entry);
+  free(load);
+}
+
+// A reference to path's entry, queueing the load if it's new
+static CachedTexture *AcquireEntry(const char *path) {
+  CachedTexture *entry = FindByPath(path);
+  if (entry) {
+    entry->refs++;
+    return entry;
+  }
+
+  entry = AddEntry(path);
+  TextureLoad *load = entry ? calloc(1, sizeof(TextureLoad)) : NULL;
+  if (!load) {
+    if (entry)
+      *entry = (CachedTexture){0};
+    printf("[Assets] WARNING: Cache full, %s not loaded\n", path);
+    return NULL;
+  }
+  load->entry = entry;
+  snprintf(load->path, sizeof(load->path), "%s", path);
+  entry->loading = true;
+  QueueAssetLoad(DecodeTexture, FinishTexture, load);
+  return entry;
+}
+
+const Texture2D *AcquireTexture(const char *path) {
+  CachedTexture *entry = AcquireEntry(path);
+  return entry ? &entry->texture : &noTexture;
+}
+
+void ReleaseTexture(const Texture2D *texture) {
+  for (int i = 0; i < ASSET_CACHE_SIZE; i++) {
+    if (cache[i].refs > 0 && &cache[i].texture == texture) {
+      ReleaseEntry(&cache[i]);
+      return;
+    }
+  }
+}
+
+int GetTextureReferenceCount(void) {
+  int refs = 0;
+  for (int i = 0; i < ASSET_CACHE_SIZE; i++)
+    refs += cache[i].refs;
+  return refs;
+}
+
+// ==========================================
+// SPRITES
+// ==========================================
+
+static const Rectangle *FindRegion(const char *path) {
+  for (int i = 0; i < regionCount; i++)
+    if (strcmp(regions[i].path, path) == 0)
+      return &regions[i].source;
+  return NULL;
+}
+
+const AtlasSprite *AcquireSprite(const char *path) {
+  SpriteSlot *slot = NULL;
+  for (int s = 0; s < ASSET_SPRITE_SLOTS; s++) {
+    if (sprites[s].refs > 0 && strcmp(sprites[s].path, path) == 0) {
+      sprites[s].refs++;
+      return &sprites[s].sprite;
+    }
+    if (!slot && sprites[s].refs == 0)
+      slot = &sprites[s];
+  }
+  if (!slot || strlen(path) >= ASSET_PATH_MAX) {
+    printf("[Assets] WARNING: No sprite slot for %s\n", path);
+    return &noSprite;
+  }
+  *slot = (SpriteSlot){.refs = 1};
+  snprintf(slot->path, sizeof(slot->path), "%s", path);
+
+  // An atlas still loading may hold the sprite; FinishAtlas sorts it out
+  const Rectangle *source = FindRegion(path);
+  if (atlas && (atlas->loading || source)) {
+    atlas->refs++;
+    slot->owner = atlas;
+    if (source)
+      slot->sprite = (AtlasSprite){atlas->texture, *source};
+  } else {
+    slot->owner = AcquireEntry(path);
+    if (slot->owner && slot->owner->texture.id > 0)
+      RefreshSprites(slot->owner);
+  }
+  return &slot->sprite;
+}
+
+void ReleaseSprite(const AtlasSprite *sprite) {
+  for (int s = 0; s < ASSET_SPRITE_SLOTS; s++) {
+    if (sprites[s].refs > 0 && &sprites[s].sprite == sprite) {
+      if (--sprites[s].refs == 0) {
+        if (sprites[s].owner)
+          ReleaseEntry(sprites[s].owner);
+        sprites[s] = (SpriteSlot){0};
+      }
+      return;
+    }
+  }
+}
+
+// ==========================================
+// ATLAS
+// ==========================================
+
+// Shelf-pack the images into a size x size square; false if they don't fit
+static bool PackShelves(const Image *images, const int *order, int count,
+                        int size, Rectangle *placed) {
+  int x = 0, y = 0, shelfHeight = 0;
+  for (int k = 0; k < count; k++) {
+    const Image *image = &images[order[k]];
+    if (x + image->width > size) {
+      x = 0;
+      y += shelfHeight;
+      shelfHeight = 0;
+    }
+    if (image->width > size || y + image->height > size)
+      return false;
+    placed[order[k]] = (Rectangle){(float)x, (float)y, (float)image->width,
+                                   (float)image->height};
+    x += image->width;
+    if (image->height > shelfHeight)
+      shelfHeight = image->height;
+  }
+  return true;
+}
+
+bool PackSpriteAtlas(const char *const *paths, int count, Image *sheet,
+                     Rectangle *sources) {
+  *sheet = (Image){0};
+  if (count > ATLAS_MAX_SPRITES)
+    count = ATLAS_MAX_SPRITES;
+  for (int i = 0; i < count; i++)
+    sources[i] = (Rectangle){0};
+
+  // Decode everything first; sprites that fail keep their own fallback
+  Image images[ATLAS_MAX_SPRITES];
+  int input[ATLAS_MAX_SPRITES]; // Index into paths
+  int order[ATLAS_MAX_SPRITES];
+  int loaded = 0;
+  for (int i = 0; i < count; i++) {
+    Image image = LoadImage(paths[i]);
+    if (!IsImageValid(image) || strlen(paths[i]) >= ASSET_PATH_MAX) {
+      printf("[Assets] WARNING: %s left out of the atlas\n", paths[i]);
+      UnloadImage(image);
+      continue;
+    }
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    images[loaded] = image;
+    input[loaded] = i;
+    order[loaded] = loaded;
+    loaded++;
+  }
+
+  // Tallest first keeps the shelves tight
+  for (int i = 1; i < loaded; i++) {
+    int key = order[i];
+    int j = i - 1;
+    for (; j >= 0 && images[order[j]].height < images[key].height; j--)
+      order[j + 1] = order[j];
+    order[j + 1] = key;
+  }
+
+  Rectangle placed[ATLAS_MAX_SPRITES];
+  int size = 256;
+  while (size <= ATLAS_MAX_SIZE &&
+         !PackShelves(images, order, loaded, size, placed))
+    size *= 2;
+
+  bool ok = loaded > 0 && size <= ATLAS_MAX_SIZE;
+  if (ok) {
+    *sheet = GenImageColor(size, size, BLANK);
+    unsigned char *dst = sheet->data;
+    for (int i = 0; i < loaded; i++) {
+      const unsigned char *src = images[i].data;
+      size_t row = (size_t)images[i].width * 4;
+      for (int y = 0; y < images[i].height; y++) {
+        size_t at = ((size_t)(placed[i].y + y) * size + (size_t)placed[i].x);
+        memcpy(dst + at * 4, src + row * y, row);
+      }
+      sources[input[i]] = placed[i];
+    }
+  }
+  for (int i = 0; i < loaded; i++)
+    UnloadImage(images[i]);
+  return ok;
+}
+
+// The atlas kk_pack baked: sprite rectangles from the archive, pixels
+// straight from the mapping
+static bool GetArchivedAtlas(const char *const *paths, int count, Image *sheet,
+                             Rectangle *sources) {
+  if (!GetArchiveImage(ATLAS_KEY, sheet))
+    return false;
+  for (int i = 0; i < count; i++) {
+    const ArchiveEntry *e = FindArchiveEntry(paths[i], ARCHIVE_SPRITE);
+    const uint32_t *p = e ? e->params : NULL;
+    bool inside = p && (uint64_t)p[0] + p[2] <= (uint64_t)sheet->width &&
+                  (uint64_t)p[1] + p[3] <= (uint64_t)sheet->height;
+    sources[i] = inside ? (Rectangle){(float)p[0], (float)p[1], (float)p[2],
+                                      (float)p[3]}
+                        : (Rectangle){0};
+  }
+  return true;
+}
+
+static bool DecodeAtlas(void *request) {
+  AtlasLoad *load = request;
+  load->archived =
+      GetArchivedAtlas(load->names, load->count, &load->sheet, load->sources);
+  return load->archived ||
+         PackSpriteAtlas(load->names, load->count, &load->sheet, load->sources);
+}
+
+static void FinishAtlas(void *request, bool ok) {
+  AtlasLoad *load = request;
+  CachedTexture *entry = load->entry;
+  entry->loading = false;
+  if (ok && entry->refs > 0)
+    entry->texture = LoadTextureFromImage(load->sheet);
+  if (ok && !load->archived)
+    UnloadImage(load->sheet);
+  if (entry->refs == 0) {
+    if (entry->texture.id > 0)
+      UnloadTexture(entry->texture);
+    *entry = (CachedTexture){0}; // Unloaded before it landed
+    free(load);
+    return;
+  }
+  ok = entry->texture.id > 0;
+
+  bool current = entry == atlas;
+  if (ok && current) {
+    for (int i = 0; i < load->count; i++) {
+      if (load->sources[i].width <= 0.0f)
+        continue;
+      snprintf(regions[regionCount].path, sizeof(regions[0].path), "%s",
+               load->paths[i]);
+      regions[regionCount++].source = load->sources[i];
+    }
+    printf("[Assets] %s %d sprites into a %dx%d atlas\n",
+           load->archived ? "Mapped" : "Packed", regionCount,
+           entry->texture.width, entry->texture.height);
+  } else if (current) {
+    printf("[Assets] WARNING: No atlas, sprites load one by one\n");
+  }
+
+  // Sprites that waited: their rectangle, or their own texture after all
+  for (int s = 0; s < ASSET_SPRITE_SLOTS; s++) {
+    SpriteSlot *slot = &sprites[s];
+    if (slot->refs == 0 || slot->owner != entry)
+      continue;
+    const Rectangle *source = NULL;
+    for (int i = 0; ok && i < load->count && !source; i++)
+      if (load->sources[i].width > 0.0f &&
+          strcmp(load->paths[i], slot->path) == 0)
+        source = &load->sources[i];
+    if (source) {
+      slot->sprite = (AtlasSprite){entry->texture, *source};
+      continue;
+    }
+    slot->owner = AcquireEntry(slot->path);
+    if (slot->owner && slot->owner->texture.id > 0)
+      RefreshSprites(slot->owner);
+    ReleaseEntry(entry);
+  }
+  if (!ok && current) {
+    atlas = NULL;
+    ReleaseEntry(entry); // The atlas's own reference
+  }
+  free(load);
+}
+
+void LoadSpriteAtlas(const char *const *paths, int count) {
+  UnloadSpriteAtlas();
+  if (count > ATLAS_MAX_SPRITES)
+    count = ATLAS_MAX_SPRITES;
+
+  CachedTexture *entry = AddEntry(ATLAS_KEY);
+  AtlasLoad *load = entry ? calloc(1, sizeof(AtlasLoad)) : NULL;
+  if (!load) {
+    if (entry)
+      *entry = (CachedTexture){0};
+    printf("[Assets] WARNING: No atlas, sprites load one by one\n");
+    return;
+  }
+  load->entry = entry;
+  load->count = count;
+  for (int i = 0; i < count; i++) {
+    snprintf(load->paths[i], sizeof(load->paths[i]), "%s", paths[i]);
+    load->names[i] = load->paths[i];
+  }
+  entry->loading = true;
+  atlas = entry;
+  QueueAssetLoad(DecodeAtlas, FinishAtlas, load);
+}
+
+void UnloadSpriteAtlas(void) {
+  if (atlas)
+    ReleaseEntry(atlas); // Sprites still out keep it loaded
+  atlas = NULL;
+  regionCount = 0;
+}
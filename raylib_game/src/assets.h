@@ -0,0 +1,70 @@
+/**
+ * Kitchen Knight - Asset Cache
+ * ============================
+ * Textures are loaded once per path and shared by reference count, so two
+ * modules asking for the same file get the same GL texture. Sprites packed
+ * into the atlas at startup all live in one texture; anything drawn from
+ * them (billboards, HUD) binds it once and batches together.
+ *
+ * Loads go through the async loader (asset_loader.h): Acquire returns a
+ * handle at once, with texture id 0 until the upload lands, so callers
+ * draw their fallback until then. The handle stays at the same address
+ * until released; the upload fills it in place.
+ *
+ *   LoadSpriteAtlas(paths, count);              // Startup, needs a window
+ *   const AtlasSprite *s = AcquireSprite("assets/toster.png");
+ *   if (s->texture.id > 0)                      // Each draw
+ *     PushSprite(s->texture, s->source, position, 4.0f, WHITE);
+ *   ReleaseSprite(s);                           // When done with it
+ */
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+#define ASSET_CACHE_SIZE 32   // Distinct textures held at once
+#define ASSET_SPRITE_SLOTS 32 // Distinct sprites handed out at once
+#define ASSET_PATH_MAX 128
+#define ATLAS_MAX_SPRITES 16
+#define ATLAS_MAX_SIZE 8192   // Largest atlas side tried, in pixels
+#define ATLAS_KEY "<sprite atlas>" // Name of the atlas, in cache and archive
+
+typedef struct {
+  Texture2D texture;
+  Rectangle source; // Pixels of texture the sprite covers
+} AtlasSprite;
+
+// Every billboard and HUD sprite the game draws (InitGameAssets, kk_pack)
+extern const char *const gameSprites[];
+extern const int gameSpriteCount;
+
+// Pack these images into one texture (sprites that don't load are left
+// out and fall back to their own texture), or take the atlas from the
+// asset archive. Packing runs on a loader thread; sprites acquired before
+// it lands wait for it. The cache holds the atlas until UnloadSpriteAtlas;
+// sprites acquired from it keep it alive longer.
+void LoadSpriteAtlas(const char *const *paths, int count);
+void UnloadSpriteAtlas(void);
+
+// The CPU half, no window needed: the RGBA atlas image and each path's
+// rectangle in it (zero for those left out). Unload sheet when done.
+bool PackSpriteAtlas(const char *const *paths, int count, Image *sheet,
+                     Rectangle *sources);
+
+// Load path (from the asset archive when it has it), or add a reference
+// to the copy already loaded. Id 0 until it has loaded, and for good if
+// the file can't be.
+const Texture2D *AcquireTexture(const char *path);
+void ReleaseTexture(const Texture2D *texture);
+
+// The path's rectangle of the atlas, or the whole of its own texture if it
+// wasn't packed
+const AtlasSprite *AcquireSprite(const char *path);
+void ReleaseSprite(const AtlasSprite *sprite);
+
+// References still held across the cache (0 once everything is released)
+int GetTextureReferenceCount(void);
+
+#endif // ASSETS_H
@@ -5,7 +5,10 @@
  */
 
 #include "audio.h"
+#include "archive.h"
+#include "asset_loader.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 // --- Audio State ---
 static bool audioInitialized = false;
@@ -16,10 +19,50 @@ static bool musicPlaying = false;
 static Sound sounds[SFX_COUNT];
 static bool soundsLoaded[SFX_COUNT];
 
+// One effect in flight on the async loader
+typedef struct {
+  int index;
+  const char *path;
+  Wave wave;
+  bool decoded; // wave is ours to unload (else a view of the archive)
+} SFXLoad;
+
+// Requests from the simulation, played on the main thread by FlushSFX
+#define SFX_QUEUE_SIZE 32
+static SFXType sfxQueue[SFX_QUEUE_SIZE];
+static int sfxQueueCount = 0;
+
 // ==========================================
 // INITIALIZATION
 // ==========================================
 
+// Loader thread. From the archive's PCM when it's open: no decode, and no
+// probing the disk for effects it doesn't have.
+static bool DecodeSFX(void *request) {
+  SFXLoad *load = request;
+  if (GetArchiveWave(load->path, &load->wave))
+    return true;
+  if (IsArchivedPath(load->path))
+    return false;
+  load->wave = LoadWave(load->path);
+  load->decoded = true;
+  return IsWaveValid(load->wave);
+}
+
+static void FinishSFX(void *request, bool ok) {
+  SFXLoad *load = request;
+  int i = load->index;
+  if (ok && audioInitialized)
+    sounds[i] = LoadSoundFromWave(load->wave);
+  if (load->decoded)
+    UnloadWave(load->wave);
+  if (sounds[i].frameCount > 0) {
+    soundsLoaded[i] = true;
+    printf("[Audio] Loaded SFX: %s\n", load->path);
+  }
+  free(load);
+}
+
 void InitAudioSystem(void) {
   InitAudioDevice();
   audioInitialized = true;
@@ -35,14 +78,16 @@ void InitAudioSystem(void) {
       "assets/sfx_pickup.wav"     // SFX_PICKUP
   };
 
+  // Decoded off the main thread; an effect plays once it has landed
   for (int i = 0; i < SFX_COUNT; i++) {
-    sounds[i] = LoadSound(sfxFiles[i]);
-    if (sounds[i].frameCount > 0) {
-      soundsLoaded[i] = true;
-      printf("[Audio] Loaded SFX: %s\n", sfxFiles[i]);
-    } else {
-      soundsLoaded[i] = false;
-    }
+    sounds[i] = (Sound){0};
+    soundsLoaded[i] = false;
+    SFXLoad *load = calloc(1, sizeof(SFXLoad));
+    if (!load)
+      continue;
+    load->index = i;
+    load->path = sfxFiles[i];
+    QueueAssetLoad(DecodeSFX, FinishSFX, load);
   }
 }
 
@@ -51,6 +96,12 @@ void InitAudioSystem(void) {
 // ==========================================
 
 void PlaySFX(SFXType type) {
+  // A frame never needs more; extra requests are dropped
+  if (sfxQueueCount < SFX_QUEUE_SIZE)
+    sfxQueue[sfxQueueCount++] = type;
+}
+
+static void PlayQueuedSFX(SFXType type) {
   if (!audioInitialized)
     return;
 
@@ -66,6 +117,12 @@ void PlaySFX(SFXType type) {
   }
 }
 
+void FlushSFX(void) {
+  for (int i = 0; i < sfxQueueCount; i++)
+    PlayQueuedSFX(sfxQueue[i]);
+  sfxQueueCount = 0;
+}
+
 // ==========================================
 // MUSIC
 // ==========================================
@@ -78,7 +135,16 @@ void PlayMusic(const char *filename) {
     StopMusic();
   }
 
-  currentMusic = LoadMusicStream(filename);
+  // Music streams decode as they play, so the archive keeps the file as is
+  int size = 0;
+  const unsigned char *data = GetArchiveFile(filename, &size);
+  if (data)
+    currentMusic = LoadMusicStreamFromMemory(GetFileExtension(filename), data,
+                                             size);
+  else if (!IsArchivedPath(filename))
+    currentMusic = LoadMusicStream(filename);
+  else
+    currentMusic = (Music){0};
   if (currentMusic.frameCount > 0) {
     PlayMusicStream(currentMusic);
     musicPlaying = true;
@@ -22,7 +22,8 @@ typedef enum {
 
 // --- Functions ---
 void InitAudioSystem(void);
-void PlaySFX(SFXType type);
+void PlaySFX(SFXType type); // Queued; safe from the simulation thread
+void FlushSFX(void);         // Play queued sounds (main thread, sim idle)
 void UnloadAudioSystem(void);
 
 // Music
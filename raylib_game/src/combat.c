@@ -5,11 +5,16 @@
  */
 
 #include "combat.h"
+#include "assets.h"
 #include "audio.h"
+#include "culling.h"
+#include "logger.h"
 #include "particles.h"
+#include "profiler.h"
 #include "raymath.h"
 #include "enemies/enemy_types.h"
-#include <stdio.h>
+#include "spatial_grid.h"
+#include <string.h>
 
 // --- Global State ---
 static Weapon currentWeapon;
@@ -18,11 +23,18 @@ static Projectile projectilePool[MAX_PROJECTILES];
 // Screen shake state
 static float shakeTimer = 0.0f;
 static float shakeIntensity = 0.0f;
+static Vector2 shakeOffset = {0.0f, 0.0f}; // Rolled by the simulation
 
-// Textures for rendering
-static Texture2D toasterTexture;
-static Texture2D spatulaTexture;
-static bool texturesLoaded = false;
+// Snapshot read by the Draw functions (PublishCombatDrawState)
+static Weapon drawWeapon;
+static Projectile drawProjectiles[MAX_PROJECTILES];
+static int drawProjectileCount = 0;
+static Vector2 drawShakeOffset = {0.0f, 0.0f};
+
+// Sprites for rendering (atlas rectangles when the atlas loaded). Texture
+// id 0 until they land; NULL when assets aren't loaded (headless).
+static const AtlasSprite *toasterSprite = NULL;
+static const AtlasSprite *spatulaSprite = NULL;
 
 // ==========================================
 // INITIALIZATION
@@ -42,46 +54,40 @@ void InitCombat(void) {
   for (int i = 0; i < MAX_PROJECTILES; i++) {
     projectilePool[i].active = false;
   }
+}
 
-  // Load textures
-  toasterTexture = LoadTexture("assets/toster.png");
-  spatulaTexture = LoadTexture("assets/spatula_hand.png");
-
-  if (toasterTexture.id > 0 && spatulaTexture.id > 0) {
-    texturesLoaded = true;
-    printf("[Combat] Loaded textures: toaster and spatula\n");
-  } else if (toasterTexture.id > 0) {
-    texturesLoaded =
-        true; // Still allow toaster if only that loaded for some reason
-    printf("[Combat] Loaded toaster texture but spatula failed\n");
-  }
+void LoadCombatAssets(void) {
+  // Shared with the enemy system through the cache, not loaded again
+  toasterSprite = AcquireSprite("assets/toster.png");
+  spatulaSprite = AcquireSprite("assets/spatula_hand.png");
 }
 
 // ==========================================
 // UPDATE
 // ==========================================
 
-void UpdateCombat(GameState *game, float dt) {
+void UpdateCombat(GameState *game, const InputFrame *input, float dt) {
+  PROFILE_BEGIN(zone, "UpdateCombat");
   // 0. Weapon switching (1-4 keys)
-  if (IsKeyPressed(KEY_ONE)) {
+  if (IsInputPressed(input, INPUT_WEAPON_1)) {
     currentWeapon.type = WEAPON_SPATULA;
     currentWeapon.damage = 10;
     currentWeapon.range = 4.0f;
     currentWeapon.cooldownTime = 0.4f;
     currentWeapon.isRanged = false;
-  } else if (IsKeyPressed(KEY_TWO)) {
+  } else if (IsInputPressed(input, INPUT_WEAPON_2)) {
     currentWeapon.type = WEAPON_FRYING_PAN;
     currentWeapon.damage = 25;
     currentWeapon.range = 3.0f;
     currentWeapon.cooldownTime = 0.8f;
     currentWeapon.isRanged = false;
-  } else if (IsKeyPressed(KEY_THREE)) {
+  } else if (IsInputPressed(input, INPUT_WEAPON_3)) {
     currentWeapon.type = WEAPON_KETCHUP;
     currentWeapon.damage = 8;
     currentWeapon.range = 15.0f;
     currentWeapon.cooldownTime = 0.2f;
     currentWeapon.isRanged = true;
-  } else if (IsKeyPressed(KEY_FOUR)) {
+  } else if (IsInputPressed(input, INPUT_WEAPON_4)) {
     currentWeapon.type = WEAPON_EGG_LAUNCHER;
     currentWeapon.damage = 40;
     currentWeapon.range = 20.0f;
@@ -98,7 +104,7 @@ void UpdateCombat(GameState *game, float dt) {
   }
 
   // 2. Attack input
-  if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) &&
+  if (IsInputPressed(input, INPUT_ATTACK) &&
       currentWeapon.state == WEAPON_IDLE) {
 
     // Play attack sound
@@ -114,32 +120,24 @@ void UpdateCombat(GameState *game, float dt) {
     if (!currentWeapon.isRanged) {
       // Melee: Raycast hit detection against legacy enemy
       if (CheckMeleeHit(game)) {
-        printf("[Combat] HIT! Legacy enemy HP: %d -> %d\n", game->enemyHP,
-               game->enemyHP - currentWeapon.damage);
+        LOG_DEBUG("[Combat] HIT! Legacy enemy HP: %d -> %d\n",
+                  game->enemyHP, game->enemyHP - currentWeapon.damage);
         game->enemyHP -= currentWeapon.damage;
         if (game->enemyHP <= 0) {
           game->enemyActive = false;
-          printf("[Combat] LEGACY ENEMY DESTROYED!\n");
+          LOG_INFO("[Combat] LEGACY ENEMY DESTROYED!\n");
         }
       }
 
-      // Melee: Raycast hit detection against pool
-      for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!(enemyPool[i].flags & ENEMY_FLAG_ACTIVE))
-          continue;
-
-        Ray attackRay = {.position = game->camera.position,
-                         .direction = Vector3Normalize(Vector3Subtract(
-                             game->camera.target, game->camera.position))};
-        RayCollision col = GetRayCollisionSphere(
-            attackRay, enemyPool[i].position, enemyPool[i].radius);
-
-        if (col.hit && col.distance <= currentWeapon.range) {
-          DamageEnemy(i, currentWeapon.damage);
-          // Only hit the first one for melee (or closest)
-          // For simplicity, we break here after one hit
-          break;
-        }
+      // Melee: closest pool enemy along the aim ray (grid walk)
+      Ray attackRay = {.position = game->camera.position,
+                       .direction = Vector3Normalize(Vector3Subtract(
+                           game->camera.target, game->camera.position))};
+      int hitIndex;
+      float hitDistance;
+      if (RaycastEnemies(attackRay, currentWeapon.range, &hitIndex,
+                         &hitDistance)) {
+        DamageEnemy(GetEnemyHandle(hitIndex), currentWeapon.damage);
       }
     } else {
       // Ranged: Spawn projectile
@@ -163,18 +161,11 @@ void UpdateCombat(GameState *game, float dt) {
       projectilePool[i].active = false;
     }
 
-    // Check collision with enemy from pool
-    for (int j = 0; j < MAX_ENEMIES; j++) {
-      if (!(enemyPool[j].flags & ENEMY_FLAG_ACTIVE))
-        continue;
-
-      float dist =
-          Vector3Distance(projectilePool[i].position, enemyPool[j].position);
-      if (dist < enemyPool[j].radius) {
-        DamageEnemy(j, projectilePool[i].damage);
-        projectilePool[i].active = false;
-        break; // Projectile destroyed
-      }
+    // Check collision with enemy from pool (only the cells around it)
+    int hit;
+    if (QueryEnemiesInRadius(projectilePool[i].position, 0.0f, &hit, 1) > 0) {
+      DamageEnemy(GetEnemyHandle(hit), projectilePool[i].damage);
+      projectilePool[i].active = false; // Projectile destroyed
     }
 
     // Check collision with legacy enemy
@@ -186,15 +177,23 @@ void UpdateCombat(GameState *game, float dt) {
 
         if (game->enemyHP <= 0) {
           game->enemyActive = false;
-          printf("[Combat] LEGACY ENEMY DESTROYED by projectile!\n");
+          LOG_INFO("[Combat] LEGACY ENEMY DESTROYED by projectile!\n");
         }
       }
     }
   }
 
-  // 4. Screen shake decay
+  // 4. Screen shake decay (the offset is rolled here, not while drawing, so
+  // raylib's random generator is only used by the simulation)
   if (shakeTimer > 0)
     shakeTimer -= dt;
+  shakeOffset = (Vector2){0.0f, 0.0f};
+  if (shakeTimer > 0) {
+    float scale = shakeIntensity / 100.0f;
+    shakeOffset.x = (float)GetRandomValue(-100, 100) * scale;
+    shakeOffset.y = (float)GetRandomValue(-100, 100) * scale;
+  }
+  PROFILE_END(zone);
 }
 
 // ==========================================
@@ -223,6 +222,7 @@ void SpawnProjectile(Vector3 pos, Vector3 dir, int damage) {
   for (int i = 0; i < MAX_PROJECTILES; i++) {
     if (!projectilePool[i].active) {
       projectilePool[i] = (Projectile){.position = pos,
+                                       .prevPosition = pos,
                                        .velocity = Vector3Scale(dir, 30.0f),
                                        .radius = 0.3f,
                                        .damage = damage,
@@ -237,28 +237,46 @@ void SpawnProjectile(Vector3 pos, Vector3 dir, int damage) {
 // SCREEN SHAKE
 // ==========================================
 
-Vector2 GetScreenShakeOffset(void) {
-  if (shakeTimer <= 0)
-    return (Vector2){0, 0};
-  return (Vector2){(float)(GetRandomValue(-100, 100)) / 100.0f * shakeIntensity,
-                   (float)(GetRandomValue(-100, 100)) / 100.0f *
-                       shakeIntensity};
-}
+Vector2 GetScreenShakeOffset(void) { return drawShakeOffset; }
 
 // ==========================================
 // RENDERING
 // ==========================================
 
+void SaveCombatInterpolationState(void) {
+  for (int i = 0; i < MAX_PROJECTILES; i++) {
+    projectilePool[i].prevPosition = projectilePool[i].position;
+  }
+}
+
+void PublishCombatDrawState(float alpha) {
+  drawWeapon = currentWeapon;
+  memcpy(drawProjectiles, projectilePool, sizeof(drawProjectiles));
+  drawProjectileCount = 0;
+  for (int i = 0; i < MAX_PROJECTILES; i++) {
+    Projectile *p = &drawProjectiles[i];
+    p->position = Vector3Lerp(p->prevPosition, p->position, alpha);
+    drawProjectileCount += p->active;
+  }
+  drawShakeOffset = shakeOffset;
+}
+
+int GetProjectileDrawCount(void) { return drawProjectileCount; }
+
 void DrawCombat3D(const GameState *game) {
   // Draw enemy
-  if (game->enemyActive) {
-    if (texturesLoaded) {
+  if (game->enemyActive && IsSphereVisible(CULL_ENEMIES, game->enemyPos,
+                                           ENEMY_CULL_RADIUS)) {
+    if (toasterSprite && toasterSprite->texture.id > 0) {
       // Enable alpha blending for transparency
       BeginBlendMode(BLEND_ALPHA);
-      DrawBillboard(game->camera, toasterTexture, game->enemyPos, 4.0f, WHITE);
+      Rectangle source = toasterSprite->source;
+      Vector2 size = {4.0f * source.width / source.height, 4.0f};
+      DrawBillboardRec(game->camera, toasterSprite->texture, source,
+                       game->enemyPos, size, WHITE);
       EndBlendMode();
     } else {
-      // Fallback: Draw cube if texture not loaded
+      // Fallback: Draw cube until the texture has loaded
       DrawCube(game->enemyPos, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH, ORANGE);
       DrawCubeWires(game->enemyPos, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH,
                     BLACK);
@@ -267,26 +285,29 @@ void DrawCombat3D(const GameState *game) {
 
   // Draw projectiles
   for (int i = 0; i < MAX_PROJECTILES; i++) {
-    if (projectilePool[i].active) {
-      DrawSphere(projectilePool[i].position, 0.3f, RED);
+    if (drawProjectiles[i].active &&
+        IsSphereVisible(CULL_PROJECTILES, drawProjectiles[i].position,
+                        0.3f)) {
+      DrawSphere(drawProjectiles[i].position, 0.3f, RED);
     }
   }
 }
 
 void DrawCombatUI(const GameState *game) {
+  PROFILE_BEGIN(zone, "DrawCombatUI");
   int cx = GetScreenWidth() / 2;
   int cy = GetScreenHeight() / 2;
 
   // Crosshair (color based on weapon)
   Color crosshairColor = GREEN;
-  if (currentWeapon.isRanged)
+  if (drawWeapon.isRanged)
     crosshairColor = SKYBLUE;
   DrawCircle(cx, cy, 4, crosshairColor);
   DrawCircleLines(cx, cy, 8, crosshairColor);
 
   // Cooldown bar below crosshair
-  if (currentWeapon.currentCooldown > 0) {
-    float ratio = currentWeapon.currentCooldown / currentWeapon.cooldownTime;
+  if (drawWeapon.currentCooldown > 0) {
+    float ratio = drawWeapon.currentCooldown / drawWeapon.cooldownTime;
     DrawRectangle(cx - 25, cy + 40, 50, 6, DARKGRAY);
     DrawRectangle(cx - 25, cy + 40, (int)(50 * (1.0f - ratio)), 6, YELLOW);
   }
@@ -294,24 +315,26 @@ void DrawCombatUI(const GameState *game) {
   // Weapon indicator (bottom center)
   const char *weaponNames[] = {"SPATULA", "FRYING PAN", "KETCHUP",
                                "EGG LAUNCHER"};
-  const char *name = weaponNames[currentWeapon.type];
+  const char *name = weaponNames[drawWeapon.type];
   int textWidth = MeasureText(name, 20);
   DrawText(name, cx - textWidth / 2, GetScreenHeight() - 100, 20, WHITE);
   DrawText("[1] [2] [3] [4]", cx - 60, GetScreenHeight() - 75, 16, GRAY);
 
   // Draw weapon sprite if it's the spatula
-  if (currentWeapon.type == WEAPON_SPATULA && texturesLoaded &&
-      spatulaTexture.id > 0) {
+  if (drawWeapon.type == WEAPON_SPATULA && spatulaSprite &&
+      spatulaSprite->texture.id > 0) {
+    Rectangle source = spatulaSprite->source;
     float scale = 0.5f;
-    int posX = GetScreenWidth() - (int)(spatulaTexture.width * scale) - 20;
-    int posY = GetScreenHeight() - (int)(spatulaTexture.height * scale);
+    int posX = GetScreenWidth() - (int)(source.width * scale) - 20;
+    int posY = GetScreenHeight() - (int)(source.height * scale);
 
     // Subtle bobbing animation
     float bobOffset = sinf(GetTime() * 5.0f) * 10.0f;
 
-    DrawTextureEx(spatulaTexture,
-                  (Vector2){(float)posX, (float)posY + bobOffset}, 0.0f, scale,
-                  WHITE);
+    Rectangle dest = {(float)posX, (float)posY + bobOffset,
+                      source.width * scale, source.height * scale};
+    DrawTexturePro(spatulaSprite->texture, source, dest, (Vector2){0.0f, 0.0f},
+                   0.0f, WHITE);
   }
 
   // Player health bar (top left)
@@ -328,15 +351,15 @@ void DrawCombatUI(const GameState *game) {
   } else {
     DrawText("ENEMY DEFEATED!", 20, 50, 20, GREEN);
   }
+  PROFILE_END(zone);
 }
 
 // ==========================================
 // CLEANUP
 // ==========================================
 
-void UnloadCombat(void) {
-  if (texturesLoaded) {
-    UnloadTexture(toasterTexture);
-    UnloadTexture(spatulaTexture);
-  }
+void UnloadCombatAssets(void) {
+  ReleaseSprite(toasterSprite);
+  ReleaseSprite(spatulaSprite);
+  toasterSprite = spatulaSprite = NULL;
 }
@@ -8,6 +8,7 @@
 #define COMBAT_H
 
 #include "game.h"
+#include "input.h"
 #include "raylib.h"
 #include <stdbool.h>
 
@@ -39,6 +40,7 @@ typedef struct {
 
 typedef struct {
   Vector3 position;
+  Vector3 prevPosition; // Before the last fixed step, for drawing
   Vector3 velocity;
   float radius;
   int damage;
@@ -47,11 +49,18 @@ typedef struct {
 } Projectile;
 
 // --- Functions ---
-void InitCombat(void);
-void UpdateCombat(GameState *game, float dt);
+void InitCombat(void);       // Weapon and projectiles only, no window needed
+void LoadCombatAssets(void); // Textures (needs a window)
+void UpdateCombat(GameState *game, const InputFrame *input, float dt);
+void SaveCombatInterpolationState(void); // Before the frame's last step
+// Copy weapon, projectile and shake state for the Draw functions, with
+// projectiles alpha of the way into the last step. Call while the
+// simulation is idle; drawing never reads the live state.
+void PublishCombatDrawState(float alpha);
+int GetProjectileDrawCount(void); // Active projectiles in the snapshot
 void DrawCombat3D(const GameState *game);
 void DrawCombatUI(const GameState *game);
-void UnloadCombat(void);
+void UnloadCombatAssets(void);
 
 // Hit detection
 bool CheckMeleeHit(GameState *game);
@@ -0,0 +1,381 @@
+/**
+ * Kitchen Knight - Visibility Culling Implementation
+ * ==================================================
+ * The six planes come straight out of view * projection (Gribb and
+ * Hartmann), normalized so a sphere is outside once its center is more
+ * than its radius behind any plane. Batches test 4 (SSE2) or 8 (AVX2)
+ * spheres per iteration against every plane and the distance cutoff; the
+ * scalar path is the reference and handles the tails. The PVS check is a
+ * lookup of the center's cell in the camera cell's decoded row, applied
+ * after the frustum since most things fail that first.
+ */
+
+#include "culling.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "simd.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  float x, y, z, w; // Inside where x*px + y*py + z*pz + w >= 0
+} Plane;
+
+static Plane planes[6]; // Left, right, bottom, top, near, far
+static Vector3 eye;
+static bool cullingEnabled = true;
+static CullStats stats[CULL_CATEGORY_COUNT];
+
+static float cullDistance[CULL_CATEGORY_COUNT] = {
+    [CULL_PARTICLES] = 100.0f, // A pixel or two by then
+};
+
+// Level visibility: the row of the camera's cell, decoded when it changes
+static const LevelPVS *pvs = NULL;
+static const LevelMap *pvsMap = NULL;
+static uint8_t *pvsVisible = NULL; // One byte per cell
+static int pvsCell = -1;           // Decoded row, or -1
+static bool pvsActive = false;     // Camera inside the map this frame
+
+static const char *categoryNames[CULL_CATEGORY_COUNT] = {
+    "level", "enemies", "projectiles", "particles"};
+
+// ==========================================
+// FRAME SETUP
+// ==========================================
+
+void BeginCullFrame(Camera3D camera, float aspect) {
+  // Same projection as BeginMode3D
+  Matrix projection;
+  if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+    double top = camera.fovy / 2.0;
+    double right = top * aspect;
+    projection = MatrixOrtho(-right, right, -top, top, RL_CULL_DISTANCE_NEAR,
+                             RL_CULL_DISTANCE_FAR);
+  } else {
+    projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect,
+                                   RL_CULL_DISTANCE_NEAR,
+                                   RL_CULL_DISTANCE_FAR);
+  }
+  Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+  Matrix m = MatrixMultiply(view, projection);
+
+  // Rows of the clip transform as applied to a column vector; each plane
+  // is the w row plus or minus the x, y or z row
+  const float rows[4][4] = {{m.m0, m.m4, m.m8, m.m12},
+                            {m.m1, m.m5, m.m9, m.m13},
+                            {m.m2, m.m6, m.m10, m.m14},
+                            {m.m3, m.m7, m.m11, m.m15}};
+  for (int i = 0; i < 6; i++) {
+    const float *row = rows[i / 2];
+    float sign = (i & 1) ? -1.0f : 1.0f;
+    Plane p = {rows[3][0] + sign * row[0], rows[3][1] + sign * row[1],
+               rows[3][2] + sign * row[2], rows[3][3] + sign * row[3]};
+    float length = sqrtf(p.x * p.x + p.y * p.y + p.z * p.z);
+    if (length > 0.0f) {
+      p.x /= length;
+      p.y /= length;
+      p.z /= length;
+      p.w /= length;
+    }
+    planes[i] = p;
+  }
+  eye = camera.position;
+  memset(stats, 0, sizeof(stats));
+
+  pvsActive = false;
+  int x, z;
+  if (pvs && WorldToCell(pvsMap, eye, &x, &z)) {
+    int cell = z * pvsMap->width + x;
+    if (cell != pvsCell) {
+      DecodePVSRow(pvs, cell, pvsVisible);
+      pvsCell = cell;
+    }
+    pvsActive = true;
+  }
+}
+
+void SetCullPVS(const LevelPVS *levelPVS, const LevelMap *map) {
+  free(pvsVisible);
+  pvsVisible = NULL;
+  pvs = NULL;
+  pvsMap = NULL;
+  pvsCell = -1;
+  pvsActive = false;
+  if (!levelPVS || !map || levelPVS->width != map->width ||
+      levelPVS->height != map->height)
+    return;
+  pvsVisible = malloc((size_t)map->width * map->height);
+  if (pvsVisible) {
+    pvs = levelPVS;
+    pvsMap = map;
+  }
+}
+
+void SetCullingEnabled(bool enabled) { cullingEnabled = enabled; }
+
+bool IsCullingEnabled(void) { return cullingEnabled; }
+
+void SetCullDistance(CullCategory category, float distance) {
+  cullDistance[category] = distance > 0.0f ? distance : 0.0f;
+}
+
+float GetCullDistance(CullCategory category) { return cullDistance[category]; }
+
+// ==========================================
+// SINGLE TESTS
+// ==========================================
+
+static inline bool Tally(CullCategory category, bool visible) {
+  stats[category].visible += visible;
+  stats[category].culled += !visible;
+  return visible;
+}
+
+// Squared reach of the cutoff for a sphere of this radius (no cutoff is
+// an infinite reach)
+static inline float CutoffSq(CullCategory category, float radius) {
+  float limit = cullDistance[category];
+  if (limit <= 0.0f)
+    return INFINITY;
+  return (limit + radius) * (limit + radius);
+}
+
+// Anything outside the map might be seen from anywhere
+static inline bool InPVS(float x, float z) {
+  int cx, cz;
+  if (!pvsActive || !WorldToCell(pvsMap, (Vector3){x, 0.0f, z}, &cx, &cz))
+    return true;
+  return pvsVisible[cz * pvsMap->width + cx];
+}
+
+// Frustum survivors the PVS hides are taken back out
+static inline bool TallyPVS(CullCategory category, bool visible) {
+  stats[category].hidden += !visible;
+  return visible;
+}
+
+static bool BoxInPVS(BoundingBox box) {
+  if (!pvsActive)
+    return true;
+  int x0, z0, x1, z1;
+  WorldToCell(pvsMap, box.min, &x0, &z0);
+  WorldToCell(pvsMap, box.max, &x1, &z1);
+  if (x1 < 0 || z1 < 0 || x0 >= pvsMap->width || z0 >= pvsMap->height)
+    return true; // Wholly outside the map
+  x0 = x0 < 0 ? 0 : x0;
+  z0 = z0 < 0 ? 0 : z0;
+  x1 = x1 < pvsMap->width ? x1 : pvsMap->width - 1;
+  z1 = z1 < pvsMap->height ? z1 : pvsMap->height - 1;
+  for (int z = z0; z <= z1; z++)
+    for (int x = x0; x <= x1; x++)
+      if (pvsVisible[z * pvsMap->width + x])
+        return true;
+  return false;
+}
+
+static bool SphereInside(Vector3 c, float radius, float reachSq) {
+  for (int i = 0; i < 6; i++) {
+    const Plane *p = &planes[i];
+    if (p->x * c.x + p->y * c.y + p->z * c.z + p->w < -radius)
+      return false;
+  }
+  return Vector3DistanceSqr(c, eye) <= reachSq;
+}
+
+bool IsSphereVisible(CullCategory category, Vector3 center, float radius) {
+  if (!cullingEnabled)
+    return Tally(category, true);
+  if (!SphereInside(center, radius, CutoffSq(category, radius)))
+    return Tally(category, false);
+  return Tally(category, TallyPVS(category, InPVS(center.x, center.z)));
+}
+
+bool IsBoxVisible(CullCategory category, BoundingBox box) {
+  if (!cullingEnabled)
+    return Tally(category, true);
+
+  // Outside once the corner farthest along a plane's normal is behind it
+  for (int i = 0; i < 6; i++) {
+    const Plane *p = &planes[i];
+    float x = p->x >= 0.0f ? box.max.x : box.min.x;
+    float y = p->y >= 0.0f ? box.max.y : box.min.y;
+    float z = p->z >= 0.0f ? box.max.z : box.min.z;
+    if (p->x * x + p->y * y + p->z * z + p->w < 0.0f)
+      return Tally(category, false);
+  }
+  Vector3 nearest = {Clamp(eye.x, box.min.x, box.max.x),
+                     Clamp(eye.y, box.min.y, box.max.y),
+                     Clamp(eye.z, box.min.z, box.max.z)};
+  if (Vector3DistanceSqr(nearest, eye) > CutoffSq(category, 0.0f))
+    return Tally(category, false);
+  return Tally(category, TallyPVS(category, BoxInPVS(box)));
+}
+
+// ==========================================
+// BATCHES
+// ==========================================
+
+static int CullSpheresScalar(const float *x, const float *y, const float *z,
+                             float radius, float reachSq, int begin, int end,
+                             uint8_t *visible) {
+  int n = 0;
+  for (int i = begin; i < end; i++) {
+    visible[i] = SphereInside((Vector3){x[i], y[i], z[i]}, radius, reachSq);
+    n += visible[i];
+  }
+  return n;
+}
+
+#if KK_HAVE_SSE2
+
+// Writes the lanes of a movemask as 0/1 bytes, returns how many were set
+static inline int StoreMask(uint8_t *dst, int mask, int lanes) {
+  int n = 0;
+  for (int lane = 0; lane < lanes; lane++) {
+    dst[lane] = (uint8_t)((mask >> lane) & 1);
+    n += dst[lane];
+  }
+  return n;
+}
+
+static int CullSpheresSSE2(const float *x, const float *y, const float *z,
+                           float radius, float reachSq, int *begin, int end,
+                           uint8_t *visible) {
+  const __m128 negRadius = _mm_set1_ps(-radius);
+  const __m128 reach = _mm_set1_ps(reachSq);
+  const __m128 ex = _mm_set1_ps(eye.x);
+  const __m128 ey = _mm_set1_ps(eye.y);
+  const __m128 ez = _mm_set1_ps(eye.z);
+  int n = 0;
+  int i = *begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 vx = _mm_loadu_ps(x + i);
+    __m128 vy = _mm_loadu_ps(y + i);
+    __m128 vz = _mm_loadu_ps(z + i);
+
+    __m128 dx = _mm_sub_ps(vx, ex);
+    __m128 dy = _mm_sub_ps(vy, ey);
+    __m128 dz = _mm_sub_ps(vz, ez);
+    __m128 dist2 = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    __m128 inside = _mm_cmple_ps(dist2, reach);
+    for (int k = 0; k < 6; k++) {
+      const Plane *p = &planes[k];
+      __m128 d = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(p->x)),
+                     _mm_mul_ps(vy, _mm_set1_ps(p->y))),
+          _mm_add_ps(_mm_mul_ps(vz, _mm_set1_ps(p->z)), _mm_set1_ps(p->w)));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+    }
+    n += StoreMask(visible + i, _mm_movemask_ps(inside), 4);
+  }
+  *begin = i;
+  return n;
+}
+
+static KK_TARGET_AVX2 int CullSpheresAVX2(const float *x, const float *y,
+                                          const float *z, float radius,
+                                          float reachSq, int *begin, int end,
+                                          uint8_t *visible) {
+  const __m256 negRadius = _mm256_set1_ps(-radius);
+  const __m256 reach = _mm256_set1_ps(reachSq);
+  const __m256 ex = _mm256_set1_ps(eye.x);
+  const __m256 ey = _mm256_set1_ps(eye.y);
+  const __m256 ez = _mm256_set1_ps(eye.z);
+  int n = 0;
+  int i = *begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 vx = _mm256_loadu_ps(x + i);
+    __m256 vy = _mm256_loadu_ps(y + i);
+    __m256 vz = _mm256_loadu_ps(z + i);
+
+    __m256 dx = _mm256_sub_ps(vx, ex);
+    __m256 dy = _mm256_sub_ps(vy, ey);
+    __m256 dz = _mm256_sub_ps(vz, ez);
+    __m256 dist2 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+        _mm256_mul_ps(dz, dz));
+    __m256 inside = _mm256_cmp_ps(dist2, reach, _CMP_LE_OQ);
+    for (int k = 0; k < 6; k++) {
+      const Plane *p = &planes[k];
+      __m256 d = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(vx, _mm256_set1_ps(p->x)),
+                        _mm256_mul_ps(vy, _mm256_set1_ps(p->y))),
+          _mm256_add_ps(_mm256_mul_ps(vz, _mm256_set1_ps(p->z)),
+                        _mm256_set1_ps(p->w)));
+      inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GE_OQ));
+    }
+    n += StoreMask(visible + i, _mm256_movemask_ps(inside), 8);
+  }
+  *begin = i;
+  return n;
+}
+
+#endif // KK_HAVE_SSE2
+
+int CullSpheres(CullCategory category, const float *x, const float *y,
+                const float *z, float radius, int count, uint8_t *visible) {
+  if (!cullingEnabled) {
+    memset(visible, 1, (size_t)count);
+    stats[category].visible += count;
+    return count;
+  }
+
+  float reachSq = CutoffSq(category, radius);
+  int i = 0;
+  int n = 0;
+#if KK_HAVE_SSE2
+  switch (GetSimdLevel()) {
+  case SIMD_AVX2:
+    n = CullSpheresAVX2(x, y, z, radius, reachSq, &i, count, visible);
+    break;
+  case SIMD_SSE2:
+    n = CullSpheresSSE2(x, y, z, radius, reachSq, &i, count, visible);
+    break;
+  default:
+    break;
+  }
+#endif
+  n += CullSpheresScalar(x, y, z, radius, reachSq, i, count, visible);
+  if (pvsActive) {
+    for (int k = 0; k < count; k++) {
+      if (visible[k] && !InPVS(x[k], z[k])) {
+        visible[k] = 0;
+        stats[category].hidden++;
+        n--;
+      }
+    }
+  }
+  stats[category].visible += n;
+  stats[category].culled += count - n;
+  return n;
+}
+
+// ==========================================
+// STATS
+// ==========================================
+
+CullStats GetCullStats(CullCategory category) { return stats[category]; }
+
+const char *GetCullCategoryName(CullCategory category) {
+  return categoryNames[category];
+}
+
+void DrawCullStats(int x, int y, int width) {
+  char line[192];
+  int used = snprintf(line, sizeof(line), "Culling %s%s (F5), visible/total:",
+                      cullingEnabled ? "on" : "off", pvsActive ? " +PVS" : "");
+  for (int c = 0; c < CULL_CATEGORY_COUNT && used < (int)sizeof(line); c++) {
+    used += snprintf(line + used, sizeof(line) - used, " %s %d/%d",
+                     categoryNames[c], stats[c].visible,
+                     stats[c].visible + stats[c].culled);
+    if (stats[c].hidden > 0 && used < (int)sizeof(line))
+      used += snprintf(line + used, sizeof(line) - used, " (%d pvs)",
+                       stats[c].hidden);
+  }
+  DrawRectangle(x, y, width, 16, ColorAlpha(BLACK, 0.7f));
+  DrawText(line, x + 4, y + 3, 10, RAYWHITE);
+}
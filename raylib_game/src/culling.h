@@ -0,0 +1,68 @@
+/**
+ * Kitchen Knight - Visibility Culling
+ * ===================================
+ * Frustum and distance tests run before anything is submitted for
+ * drawing. BeginCullFrame takes the frustum from the camera exactly as
+ * BeginMode3D builds it; each draw path then tests its bounding spheres or
+ * boxes under its own category, which carries an optional far cutoff and
+ * this frame's visible/culled counts. With a level PVS set, anything in a
+ * cell the camera's cell can't see is culled before the frustum test.
+ *
+ *   BeginCullFrame(camera, aspect);                     // Once per frame
+ *   if (IsSphereVisible(CULL_PROJECTILES, pos, 0.3f)) ...
+ *   CullSpheres(CULL_ENEMIES, x, y, z, 3.0f, n, visible); // SIMD batch
+ */
+
+#ifndef CULLING_H
+#define CULLING_H
+
+#include "pvs.h"
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+  CULL_LEVEL,
+  CULL_ENEMIES,
+  CULL_PROJECTILES,
+  CULL_PARTICLES,
+  CULL_CATEGORY_COUNT
+} CullCategory;
+
+typedef struct {
+  int visible;
+  int culled;
+  int hidden; // Of the culled, how many by the PVS
+} CullStats;
+
+// Frustum of camera at the given viewport aspect, and a fresh set of counts
+void BeginCullFrame(Camera3D camera, float aspect);
+
+// Off passes everything (still counted as visible), for comparison
+void SetCullingEnabled(bool enabled);
+bool IsCullingEnabled(void);
+
+// Draw nothing farther than distance from the camera; 0 for no cutoff
+void SetCullDistance(CullCategory category, float distance);
+float GetCullDistance(CullCategory category);
+
+// Also cull by the level's potentially visible set; NULL turns it off.
+// Both are borrowed until the next call, so clear it before unloading.
+void SetCullPVS(const LevelPVS *pvs, const LevelMap *map);
+
+bool IsSphereVisible(CullCategory category, Vector3 center, float radius);
+bool IsBoxVisible(CullCategory category, BoundingBox box);
+
+// Spheres of one radius with centers in x/y/z. Writes 1 (visible) or 0 per
+// sphere and returns how many are visible. 4 or 8 at a time with SIMD.
+int CullSpheres(CullCategory category, const float *x, const float *y,
+                const float *z, float radius, int count, uint8_t *visible);
+
+// Counts since BeginCullFrame
+CullStats GetCullStats(CullCategory category);
+const char *GetCullCategoryName(CullCategory category);
+
+// One line of visible/total counts per category, under the profiler
+void DrawCullStats(int x, int y, int width);
+
+#endif // CULLING_H
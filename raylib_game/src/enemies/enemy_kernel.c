@@ -0,0 +1,599 @@
+/**
+ * Kitchen Knight - Enemy AI Kernel Implementation
+ * ===============================================
+ * The old per-enemy state machine, rewritten as masked lane operations so
+ * 4 (SSE2) or 8 (AVX2) enemies advance per iteration. The scalar version is
+ * the reference: it is used for tails, non-x86 builds, and must stay in
+ * lock-step with the vector versions (same operations, same order).
+ */
+
+#include "enemy_kernel.h"
+#include "../simd.h"
+#include <math.h>
+#include <string.h>
+
+#define DETECT_RANGE_SQ (ENEMY_DETECT_RANGE * ENEMY_DETECT_RANGE)
+
+// ==========================================
+// SCALAR
+// ==========================================
+
+static void UpdateEnemyRangeScalar(EnemyPool *pool, int begin, int end,
+                                   const EnemyKernelParams *k) {
+  for (int i = begin; i < end; i++) {
+    uint8_t flags = pool->flags[i];
+    uint8_t state = pool->state[i];
+    if (!(flags & ENEMY_FLAG_ACTIVE) || state == AI_DEAD)
+      continue;
+
+    float dt = k->dt;
+    if (k->lod) {
+      // Off-tick slots only bank their frame time; ticking slots spend it
+      // and are re-banded from their current distance
+      uint8_t band = pool->lodBand[i];
+      float accum = pool->lodAccum[i] + k->dt;
+      if (!IsEnemyLODTick(k->lod, i, band)) {
+        pool->lodAccum[i] = accum;
+        k->lod->bandCount[band]++;
+        continue;
+      }
+      float bx = k->playerX - pool->posX[i];
+      float by = k->playerY - pool->posY[i];
+      float bz = k->playerZ - pool->posZ[i];
+      uint8_t next = GetEnemyLODBand(k->lod, bx * bx + by * by + bz * bz);
+      pool->lodBand[i] = next;
+      pool->lodAccum[i] = 0.0f;
+      k->lod->bandCount[next]++;
+      k->lod->bandTicked[band]++;
+      dt = accum;
+    }
+
+    float timer = pool->stateTimer[i];
+    float cooldown = pool->currentCooldown[i];
+
+    // Hurt: count down the stun and skip everything else
+    if (flags & ENEMY_FLAG_HURT) {
+      timer -= dt;
+      if (timer <= 0) {
+        flags &= ~ENEMY_FLAG_HURT;
+        state = AI_CHASE;
+      }
+      pool->stateTimer[i] = timer;
+      pool->flags[i] = flags;
+      pool->state[i] = state;
+      continue;
+    }
+
+    float x = pool->posX[i];
+    float z = pool->posZ[i];
+    float dx = k->playerX - x;
+    float dy = k->playerY - pool->posY[i];
+    float dz = k->playerZ - z;
+    float dist2 = dx * dx + dy * dy + dz * dz;
+
+    if (state == AI_IDLE && dist2 < DETECT_RANGE_SQ)
+      state = AI_CHASE;
+
+    if (state == AI_CHASE) {
+      float range = pool->attackRange[i];
+      if (dist2 <= range * range) {
+        state = AI_ATTACK;
+        timer = ENEMY_ATTACK_WINDUP;
+      }
+    }
+
+    if (state == AI_CHASE) {
+      float dirX = 0.0f, dirZ = 0.0f;
+      if (k->steerX) {
+        dirX = k->steerX[i];
+        dirZ = k->steerZ[i];
+      } else {
+        float len = sqrtf(dx * dx + dz * dz);
+        if (len != 0.0f) {
+          float inv = 1.0f / len;
+          dirX = dx * inv;
+          dirZ = dz * inv;
+        }
+      }
+      float step = pool->speed[i] * dt;
+      x = fminf(fmaxf(x + dirX * step, k->minX), k->maxX);
+      z = fminf(fmaxf(z + dirZ * step, k->minZ), k->maxZ);
+      pool->posX[i] = x;
+      pool->posZ[i] = z;
+    }
+
+    if (state == AI_ATTACK) {
+      timer -= dt;
+      if (timer <= 0) {
+        // TODO: Execute attack (projectile for toaster, charge for blender)
+        state = AI_CHASE;
+        cooldown = pool->attackCooldown[i];
+      }
+    }
+
+    if (cooldown > 0)
+      cooldown -= dt;
+
+    pool->stateTimer[i] = timer;
+    pool->currentCooldown[i] = cooldown;
+    pool->state[i] = state;
+  }
+}
+
+#if KK_HAVE_SSE2
+
+// ==========================================
+// SSE2 (4 lanes)
+// ==========================================
+
+static inline __m128 Select4(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128i Select4i(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i LoadBytes4(const uint8_t *src) {
+  int32_t packed;
+  memcpy(&packed, src, sizeof(packed));
+  __m128i zero = _mm_setzero_si128();
+  __m128i v = _mm_cvtsi32_si128(packed);
+  return _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+}
+
+static inline void StoreBytes4(uint8_t *dst, __m128i v) {
+  v = _mm_packs_epi32(v, v);
+  v = _mm_packus_epi16(v, v);
+  int32_t packed = _mm_cvtsi128_si32(v);
+  memcpy(dst, &packed, sizeof(packed));
+}
+
+// LOD tick mask for slots i..i+3 given their bands
+static inline __m128i LODTick4(const EnemyLODFrame *lod, int i,
+                               __m128i band) {
+  __m128i lane = _mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3));
+  __m128i phase = _mm_add_epi32(_mm_set1_epi32((int32_t)lod->frame),
+                                _mm_srli_epi32(lane, ENEMY_LOD_STAGGER_SHIFT));
+  __m128i tick = _mm_setzero_si128();
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+    __m128i onBeat =
+        _mm_cmpeq_epi32(_mm_and_si128(phase, _mm_set1_epi32(lod->tickMask[b])),
+                        _mm_setzero_si128());
+    tick = _mm_or_si128(
+        tick, _mm_and_si128(onBeat, _mm_cmpeq_epi32(band, _mm_set1_epi32(b))));
+  }
+  return tick;
+}
+
+static inline __m128i LODBand4(const EnemyLODFrame *lod, __m128 dist2) {
+  __m128i band = _mm_setzero_si128();
+  for (int b = 0; b < ENEMY_LOD_BANDS - 1; b++) {
+    __m128 beyond = _mm_cmpge_ps(dist2, _mm_set1_ps(lod->bandEdge2[b]));
+    band = _mm_sub_epi32(band, _mm_castps_si128(beyond)); // -1 per edge
+  }
+  return band;
+}
+
+// Per-lane counters: add 1 to counts[band] for lanes in mask
+static inline void LODCount4(__m128i *counts, __m128i band, __m128i mask) {
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+    __m128i hit = _mm_and_si128(mask, _mm_cmpeq_epi32(band, _mm_set1_epi32(b)));
+    counts[b] = _mm_sub_epi32(counts[b], hit);
+  }
+}
+
+static inline int SumLanes4(__m128i v) {
+  int32_t lanes[4];
+  _mm_storeu_si128((__m128i *)lanes, v);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+static int UpdateEnemyRangeSSE2(EnemyPool *pool, int begin, int end,
+                                const EnemyKernelParams *k) {
+  const __m128 frameDt = _mm_set1_ps(k->dt);
+  const __m128 px = _mm_set1_ps(k->playerX);
+  const __m128 py = _mm_set1_ps(k->playerY);
+  const __m128 pz = _mm_set1_ps(k->playerZ);
+  const __m128 minX = _mm_set1_ps(k->minX), maxX = _mm_set1_ps(k->maxX);
+  const __m128 minZ = _mm_set1_ps(k->minZ), maxZ = _mm_set1_ps(k->maxZ);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 detect2 = _mm_set1_ps(DETECT_RANGE_SQ);
+  const __m128 windup = _mm_set1_ps(ENEMY_ATTACK_WINDUP);
+  const __m128i flagActive = _mm_set1_epi32(ENEMY_FLAG_ACTIVE);
+  const __m128i flagHurt = _mm_set1_epi32(ENEMY_FLAG_HURT);
+  const __m128i sIdle = _mm_set1_epi32(AI_IDLE);
+  const __m128i sChase = _mm_set1_epi32(AI_CHASE);
+  const __m128i sAttack = _mm_set1_epi32(AI_ATTACK);
+  const __m128i sDead = _mm_set1_epi32(AI_DEAD);
+  EnemyLODFrame *lod = k->lod;
+  __m128i bandCount[ENEMY_LOD_BANDS], bandTicked[ENEMY_LOD_BANDS];
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++)
+    bandCount[b] = bandTicked[b] = _mm_setzero_si128();
+
+  int i = begin;
+  for (; i + 4 <= end; i += 4) {
+    int32_t anyFlags;
+    memcpy(&anyFlags, &pool->flags[i], sizeof(anyFlags));
+    if (anyFlags == 0)
+      continue; // Whole block is free slots
+
+    __m128i flags = LoadBytes4(&pool->flags[i]);
+    __m128i state = LoadBytes4(&pool->state[i]);
+    __m128i active =
+        _mm_andnot_si128(_mm_cmpeq_epi32(state, sDead),
+                         _mm_cmpeq_epi32(_mm_and_si128(flags, flagActive),
+                                         flagActive));
+
+    // LOD: bank frame time off-tick, spend it on tick
+    __m128i present = active;
+    __m128i band = _mm_setzero_si128();
+    __m128 dt = frameDt;
+    if (lod) {
+      // All-near blocks with nothing banked tick every frame at the
+      // frame's dt, which is what the scalar path's accum + dt comes to
+      int32_t bands;
+      memcpy(&bands, &pool->lodBand[i], sizeof(bands));
+      __m128 oldAccum = _mm_loadu_ps(&pool->lodAccum[i]);
+      bool anyBanked = _mm_movemask_ps(_mm_cmpneq_ps(oldAccum, zero)) != 0;
+      if (bands != 0 || lod->tickMask[0] != 0 || anyBanked) {
+        band = LoadBytes4(&pool->lodBand[i]);
+        active = _mm_and_si128(present, LODTick4(lod, i, band));
+        __m128 accum = _mm_add_ps(oldAccum, frameDt);
+        __m128 tickF = _mm_castsi128_ps(active);
+        __m128 banked =
+            Select4(_mm_castsi128_ps(present), accum, oldAccum);
+        _mm_storeu_ps(&pool->lodAccum[i], Select4(tickF, zero, banked));
+        dt = _mm_and_ps(tickF, accum);
+        if (_mm_movemask_ps(tickF) == 0) {
+          LODCount4(bandCount, band, present);
+          continue; // Whole block is off-tick
+        }
+      }
+    }
+
+    __m128 timer = _mm_loadu_ps(&pool->stateTimer[i]);
+    __m128 cooldown = _mm_loadu_ps(&pool->currentCooldown[i]);
+    __m128i hurt = _mm_and_si128(
+        active,
+        _mm_cmpeq_epi32(_mm_and_si128(flags, flagHurt), flagHurt));
+    __m128i live = _mm_andnot_si128(hurt, active);
+
+    // Hurt lanes: stun countdown
+    __m128 hurtF = _mm_castsi128_ps(hurt);
+    __m128 t1 = _mm_sub_ps(timer, dt);
+    timer = Select4(hurtF, t1, timer);
+    __m128i hurtDone =
+        _mm_and_si128(hurt, _mm_castps_si128(_mm_cmple_ps(t1, zero)));
+    flags = Select4i(hurtDone, _mm_andnot_si128(flagHurt, flags), flags);
+    state = Select4i(hurtDone, sChase, state);
+
+    // Distance to player
+    __m128 x = _mm_loadu_ps(&pool->posX[i]);
+    __m128 z = _mm_loadu_ps(&pool->posZ[i]);
+    __m128 dx = _mm_sub_ps(px, x);
+    __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(&pool->posY[i]));
+    __m128 dz = _mm_sub_ps(pz, z);
+    __m128 dist2 = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+    // Re-band ticking lanes from their distance before moving
+    if (lod) {
+      __m128i newBand = Select4i(active, LODBand4(lod, dist2), band);
+      StoreBytes4(&pool->lodBand[i], newBand);
+      LODCount4(bandCount, newBand, present);
+      LODCount4(bandTicked, band, active);
+    }
+
+    // Idle -> chase
+    __m128i wake = _mm_and_si128(
+        _mm_and_si128(live, _mm_cmpeq_epi32(state, sIdle)),
+        _mm_castps_si128(_mm_cmplt_ps(dist2, detect2)));
+    state = Select4i(wake, sChase, state);
+
+    // Chase -> attack
+    __m128 range = _mm_loadu_ps(&pool->attackRange[i]);
+    __m128i chase = _mm_and_si128(live, _mm_cmpeq_epi32(state, sChase));
+    __m128i toAttack = _mm_and_si128(
+        chase, _mm_castps_si128(_mm_cmple_ps(dist2, _mm_mul_ps(range, range))));
+    state = Select4i(toAttack, sAttack, state);
+    timer = Select4(_mm_castsi128_ps(toAttack), windup, timer);
+    chase = _mm_andnot_si128(toAttack, chase);
+
+    // Chase movement (direct or flow field) + arena clamp
+    __m128 len =
+        _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)));
+    __m128 moving = _mm_cmpneq_ps(len, zero);
+    __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), len);
+    __m128 dirX = _mm_and_ps(moving, _mm_mul_ps(dx, inv));
+    __m128 dirZ = _mm_and_ps(moving, _mm_mul_ps(dz, inv));
+    if (k->steerX) {
+      dirX = _mm_loadu_ps(&k->steerX[i]);
+      dirZ = _mm_loadu_ps(&k->steerZ[i]);
+    }
+    __m128 step = _mm_mul_ps(_mm_loadu_ps(&pool->speed[i]), dt);
+    __m128 nx = _mm_min_ps(
+        _mm_max_ps(_mm_add_ps(x, _mm_mul_ps(dirX, step)), minX), maxX);
+    __m128 nz = _mm_min_ps(
+        _mm_max_ps(_mm_add_ps(z, _mm_mul_ps(dirZ, step)), minZ), maxZ);
+    __m128 chaseF = _mm_castsi128_ps(chase);
+    _mm_storeu_ps(&pool->posX[i], Select4(chaseF, nx, x));
+    _mm_storeu_ps(&pool->posZ[i], Select4(chaseF, nz, z));
+
+    // Attack windup
+    __m128i attack = _mm_and_si128(live, _mm_cmpeq_epi32(state, sAttack));
+    __m128 t2 = _mm_sub_ps(timer, dt);
+    timer = Select4(_mm_castsi128_ps(attack), t2, timer);
+    __m128i attackDone =
+        _mm_and_si128(attack, _mm_castps_si128(_mm_cmple_ps(t2, zero)));
+    state = Select4i(attackDone, sChase, state);
+    cooldown = Select4(_mm_castsi128_ps(attackDone),
+                       _mm_loadu_ps(&pool->attackCooldown[i]), cooldown);
+
+    // Cooldown tick
+    __m128 tick =
+        _mm_and_ps(_mm_castsi128_ps(live), _mm_cmpgt_ps(cooldown, zero));
+    cooldown = Select4(tick, _mm_sub_ps(cooldown, dt), cooldown);
+
+    _mm_storeu_ps(&pool->stateTimer[i], timer);
+    _mm_storeu_ps(&pool->currentCooldown[i], cooldown);
+    StoreBytes4(&pool->flags[i], flags);
+    StoreBytes4(&pool->state[i], state);
+  }
+
+  if (lod) {
+    for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+      lod->bandCount[b] += SumLanes4(bandCount[b]);
+      lod->bandTicked[b] += SumLanes4(bandTicked[b]);
+    }
+  }
+  return i;
+}
+
+// ==========================================
+// AVX2 (8 lanes)
+// ==========================================
+
+static inline KK_TARGET_AVX2 __m256i LoadBytes8(const uint8_t *src) {
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+}
+
+static inline KK_TARGET_AVX2 void StoreBytes8(uint8_t *dst, __m256i v) {
+  __m128i lo = _mm256_castsi256_si128(v);
+  __m128i hi = _mm256_extracti128_si256(v, 1);
+  __m128i packed = _mm_packs_epi32(lo, hi);
+  packed = _mm_packus_epi16(packed, packed);
+  _mm_storel_epi64((__m128i *)dst, packed);
+}
+
+static inline KK_TARGET_AVX2 __m256i LODTick8(const EnemyLODFrame *lod, int i,
+                                              __m256i band) {
+  __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(i),
+                                  _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  __m256i phase =
+      _mm256_add_epi32(_mm256_set1_epi32((int32_t)lod->frame),
+                       _mm256_srli_epi32(lane, ENEMY_LOD_STAGGER_SHIFT));
+  // Per-lane tick mask looked up by band (bands 0..3 index the table)
+  __m256i masks = _mm256_permutevar8x32_epi32(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128((const __m128i *)lod->tickMask)),
+      band);
+  return _mm256_cmpeq_epi32(_mm256_and_si256(phase, masks),
+                            _mm256_setzero_si256());
+}
+
+static inline KK_TARGET_AVX2 __m256i LODBand8(const EnemyLODFrame *lod,
+                                              __m256 dist2) {
+  __m256i band = _mm256_setzero_si256();
+  for (int b = 0; b < ENEMY_LOD_BANDS - 1; b++) {
+    __m256 beyond =
+        _mm256_cmp_ps(dist2, _mm256_set1_ps(lod->bandEdge2[b]), _CMP_GE_OQ);
+    band = _mm256_sub_epi32(band, _mm256_castps_si256(beyond));
+  }
+  return band;
+}
+
+static inline KK_TARGET_AVX2 void LODCount8(__m256i *counts, __m256i band,
+                                            __m256i mask) {
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+    __m256i hit = _mm256_and_si256(
+        mask, _mm256_cmpeq_epi32(band, _mm256_set1_epi32(b)));
+    counts[b] = _mm256_sub_epi32(counts[b], hit);
+  }
+}
+
+static inline KK_TARGET_AVX2 int SumLanes8(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  return SumLanes4(sum);
+}
+
+static KK_TARGET_AVX2 int UpdateEnemyRangeAVX2(EnemyPool *pool, int begin,
+                                               int end,
+                                               const EnemyKernelParams *k) {
+  const __m256 frameDt = _mm256_set1_ps(k->dt);
+  const __m256 px = _mm256_set1_ps(k->playerX);
+  const __m256 py = _mm256_set1_ps(k->playerY);
+  const __m256 pz = _mm256_set1_ps(k->playerZ);
+  const __m256 minX = _mm256_set1_ps(k->minX), maxX = _mm256_set1_ps(k->maxX);
+  const __m256 minZ = _mm256_set1_ps(k->minZ), maxZ = _mm256_set1_ps(k->maxZ);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 detect2 = _mm256_set1_ps(DETECT_RANGE_SQ);
+  const __m256 windup = _mm256_set1_ps(ENEMY_ATTACK_WINDUP);
+  const __m256i flagActive = _mm256_set1_epi32(ENEMY_FLAG_ACTIVE);
+  const __m256i flagHurt = _mm256_set1_epi32(ENEMY_FLAG_HURT);
+  const __m256i sIdle = _mm256_set1_epi32(AI_IDLE);
+  const __m256i sChase = _mm256_set1_epi32(AI_CHASE);
+  const __m256i sAttack = _mm256_set1_epi32(AI_ATTACK);
+  const __m256i sDead = _mm256_set1_epi32(AI_DEAD);
+  EnemyLODFrame *lod = k->lod;
+  __m256i bandCount[ENEMY_LOD_BANDS], bandTicked[ENEMY_LOD_BANDS];
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++)
+    bandCount[b] = bandTicked[b] = _mm256_setzero_si256();
+
+  int i = begin;
+  for (; i + 8 <= end; i += 8) {
+    int64_t anyFlags;
+    memcpy(&anyFlags, &pool->flags[i], sizeof(anyFlags));
+    if (anyFlags == 0)
+      continue; // Whole block is free slots
+
+    __m256i flags = LoadBytes8(&pool->flags[i]);
+    __m256i state = LoadBytes8(&pool->state[i]);
+    __m256i active = _mm256_andnot_si256(
+        _mm256_cmpeq_epi32(state, sDead),
+        _mm256_cmpeq_epi32(_mm256_and_si256(flags, flagActive), flagActive));
+
+    // LOD: bank frame time off-tick, spend it on tick
+    __m256i present = active;
+    __m256i band = _mm256_setzero_si256();
+    __m256 dt = frameDt;
+    if (lod) {
+      // All-near blocks with nothing banked tick every frame at the
+      // frame's dt, which is what the scalar path's accum + dt comes to
+      int64_t bands;
+      memcpy(&bands, &pool->lodBand[i], sizeof(bands));
+      __m256 oldAccum = _mm256_loadu_ps(&pool->lodAccum[i]);
+      bool anyBanked =
+          _mm256_movemask_ps(_mm256_cmp_ps(oldAccum, zero, _CMP_NEQ_UQ)) != 0;
+      if (bands != 0 || lod->tickMask[0] != 0 || anyBanked) {
+        band = LoadBytes8(&pool->lodBand[i]);
+        active = _mm256_and_si256(present, LODTick8(lod, i, band));
+        __m256 accum = _mm256_add_ps(oldAccum, frameDt);
+        __m256 tickF = _mm256_castsi256_ps(active);
+        __m256 banked =
+            _mm256_blendv_ps(oldAccum, accum, _mm256_castsi256_ps(present));
+        _mm256_storeu_ps(&pool->lodAccum[i],
+                         _mm256_blendv_ps(banked, zero, tickF));
+        dt = _mm256_and_ps(tickF, accum);
+        if (_mm256_movemask_ps(tickF) == 0) {
+          LODCount8(bandCount, band, present);
+          continue; // Whole block is off-tick
+        }
+      }
+    }
+
+    __m256 timer = _mm256_loadu_ps(&pool->stateTimer[i]);
+    __m256 cooldown = _mm256_loadu_ps(&pool->currentCooldown[i]);
+    __m256i hurt = _mm256_and_si256(
+        active,
+        _mm256_cmpeq_epi32(_mm256_and_si256(flags, flagHurt), flagHurt));
+    __m256i live = _mm256_andnot_si256(hurt, active);
+
+    // Hurt lanes: stun countdown
+    __m256 t1 = _mm256_sub_ps(timer, dt);
+    timer = _mm256_blendv_ps(timer, t1, _mm256_castsi256_ps(hurt));
+    __m256i hurtDone = _mm256_and_si256(
+        hurt, _mm256_castps_si256(_mm256_cmp_ps(t1, zero, _CMP_LE_OQ)));
+    flags = _mm256_blendv_epi8(flags, _mm256_andnot_si256(flagHurt, flags),
+                               hurtDone);
+    state = _mm256_blendv_epi8(state, sChase, hurtDone);
+
+    // Distance to player
+    __m256 x = _mm256_loadu_ps(&pool->posX[i]);
+    __m256 z = _mm256_loadu_ps(&pool->posZ[i]);
+    __m256 dx = _mm256_sub_ps(px, x);
+    __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(&pool->posY[i]));
+    __m256 dz = _mm256_sub_ps(pz, z);
+    __m256 dist2 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+        _mm256_mul_ps(dz, dz));
+
+    // Re-band ticking lanes from their distance before moving
+    if (lod) {
+      __m256i newBand = _mm256_blendv_epi8(band, LODBand8(lod, dist2), active);
+      StoreBytes8(&pool->lodBand[i], newBand);
+      LODCount8(bandCount, newBand, present);
+      LODCount8(bandTicked, band, active);
+    }
+
+    // Idle -> chase
+    __m256i wake = _mm256_and_si256(
+        _mm256_and_si256(live, _mm256_cmpeq_epi32(state, sIdle)),
+        _mm256_castps_si256(_mm256_cmp_ps(dist2, detect2, _CMP_LT_OQ)));
+    state = _mm256_blendv_epi8(state, sChase, wake);
+
+    // Chase -> attack
+    __m256 range = _mm256_loadu_ps(&pool->attackRange[i]);
+    __m256i chase = _mm256_and_si256(live, _mm256_cmpeq_epi32(state, sChase));
+    __m256i toAttack = _mm256_and_si256(
+        chase, _mm256_castps_si256(_mm256_cmp_ps(
+                   dist2, _mm256_mul_ps(range, range), _CMP_LE_OQ)));
+    state = _mm256_blendv_epi8(state, sAttack, toAttack);
+    timer = _mm256_blendv_ps(timer, windup, _mm256_castsi256_ps(toAttack));
+    chase = _mm256_andnot_si256(toAttack, chase);
+
+    // Chase movement (direct or flow field) + arena clamp
+    __m256 len = _mm256_sqrt_ps(
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz)));
+    __m256 moving = _mm256_cmp_ps(len, zero, _CMP_NEQ_UQ);
+    __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.0f), len);
+    __m256 dirX = _mm256_and_ps(moving, _mm256_mul_ps(dx, inv));
+    __m256 dirZ = _mm256_and_ps(moving, _mm256_mul_ps(dz, inv));
+    if (k->steerX) {
+      dirX = _mm256_loadu_ps(&k->steerX[i]);
+      dirZ = _mm256_loadu_ps(&k->steerZ[i]);
+    }
+    __m256 step = _mm256_mul_ps(_mm256_loadu_ps(&pool->speed[i]), dt);
+    __m256 nx = _mm256_min_ps(
+        _mm256_max_ps(_mm256_add_ps(x, _mm256_mul_ps(dirX, step)), minX), maxX);
+    __m256 nz = _mm256_min_ps(
+        _mm256_max_ps(_mm256_add_ps(z, _mm256_mul_ps(dirZ, step)), minZ), maxZ);
+    __m256 chaseF = _mm256_castsi256_ps(chase);
+    _mm256_storeu_ps(&pool->posX[i], _mm256_blendv_ps(x, nx, chaseF));
+    _mm256_storeu_ps(&pool->posZ[i], _mm256_blendv_ps(z, nz, chaseF));
+
+    // Attack windup
+    __m256i attack = _mm256_and_si256(live, _mm256_cmpeq_epi32(state, sAttack));
+    __m256 t2 = _mm256_sub_ps(timer, dt);
+    timer = _mm256_blendv_ps(timer, t2, _mm256_castsi256_ps(attack));
+    __m256i attackDone = _mm256_and_si256(
+        attack, _mm256_castps_si256(_mm256_cmp_ps(t2, zero, _CMP_LE_OQ)));
+    state = _mm256_blendv_epi8(state, sChase, attackDone);
+    cooldown = _mm256_blendv_ps(cooldown,
+                                _mm256_loadu_ps(&pool->attackCooldown[i]),
+                                _mm256_castsi256_ps(attackDone));
+
+    // Cooldown tick
+    __m256 tick = _mm256_and_ps(_mm256_castsi256_ps(live),
+                                _mm256_cmp_ps(cooldown, zero, _CMP_GT_OQ));
+    cooldown = _mm256_blendv_ps(cooldown, _mm256_sub_ps(cooldown, dt), tick);
+
+    _mm256_storeu_ps(&pool->stateTimer[i], timer);
+    _mm256_storeu_ps(&pool->currentCooldown[i], cooldown);
+    StoreBytes8(&pool->flags[i], flags);
+    StoreBytes8(&pool->state[i], state);
+  }
+
+  if (lod) {
+    for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+      lod->bandCount[b] += SumLanes8(bandCount[b]);
+      lod->bandTicked[b] += SumLanes8(bandTicked[b]);
+    }
+  }
+  return i;
+}
+
+#endif // KK_HAVE_SSE2
+
+// ==========================================
+// DISPATCH
+// ==========================================
+
+void UpdateEnemyRange(EnemyPool *pool, int begin, int end,
+                      const EnemyKernelParams *params) {
+  int i = begin;
+#if KK_HAVE_SSE2
+  switch (GetSimdLevel()) {
+  case SIMD_AVX2:
+    i = UpdateEnemyRangeAVX2(pool, i, end, params);
+    break;
+  case SIMD_SSE2:
+    i = UpdateEnemyRangeSSE2(pool, i, end, params);
+    break;
+  default:
+    break;
+  }
+#endif
+  UpdateEnemyRangeScalar(pool, i, end, params);
+}
@@ -0,0 +1,34 @@
+/**
+ * Kitchen Knight - Enemy AI Kernel
+ * ================================
+ * Branch-free chase/attack/hurt update over the SoA enemy pool.
+ */
+
+#ifndef ENEMY_KERNEL_H
+#define ENEMY_KERNEL_H
+
+#include "enemy_lod.h"
+#include "enemy_types.h"
+
+// Per-frame inputs shared by every lane
+typedef struct {
+  float playerX, playerY, playerZ;
+  float dt;
+  // Movement clamp (world units)
+  float minX, maxX;
+  float minZ, maxZ;
+  // Optional per-slot unit chase directions (flow field). NULL means chase
+  // straight at the player.
+  const float *steerX;
+  const float *steerZ;
+  // Optional AI level of detail: slots only run on their band's tick, with
+  // the frame time accumulated since the last one. NULL runs every slot.
+  EnemyLODFrame *lod;
+} EnemyKernelParams;
+
+// Update slots [begin, end). Dispatches to AVX2, SSE2 or scalar code
+// depending on GetSimdLevel(); all paths produce identical results.
+void UpdateEnemyRange(EnemyPool *pool, int begin, int end,
+                      const EnemyKernelParams *params);
+
+#endif // ENEMY_KERNEL_H
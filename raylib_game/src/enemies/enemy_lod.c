@@ -0,0 +1,85 @@
+/**
+ * Kitchen Knight - Enemy AI Level of Detail Implementation
+ * ========================================================
+ * Configuration and stats. The schedule itself (tick test, accumulated dt,
+ * re-banding from the current distance) runs inside the enemy kernel, so
+ * it costs no extra pass over the pool.
+ */
+
+#include "enemy_lod.h"
+#include <string.h>
+
+// Weight of the newest frame in the smoothed cost
+#define COST_SMOOTHING 0.05
+
+static EnemyLODConfig lodConfig = {
+    .enabled = true,
+    .bandDistance = {ENEMY_LOD_NEAR, ENEMY_LOD_MID, ENEMY_LOD_FAR},
+    .tickInterval = {1, 2, 4, 8},
+};
+static EnemyLODStats lodStats;
+static uint32_t lodFrame = 0;
+
+// ==========================================
+// CONFIGURATION
+// ==========================================
+
+EnemyLODConfig GetEnemyLODConfig(void) { return lodConfig; }
+
+void SetEnemyLODConfig(const EnemyLODConfig *config) {
+  lodConfig = *config;
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+    int interval = 1;
+    while (interval < config->tickInterval[b] && interval < 256)
+      interval <<= 1;
+    lodConfig.tickInterval[b] = interval;
+  }
+  lodFrame = 0; // Restart the stagger so runs with one config repeat exactly
+}
+
+// ==========================================
+// SCHEDULING
+// ==========================================
+
+bool BeginEnemyLODFrame(EnemyLODFrame *frame) {
+  memset(frame, 0, sizeof(*frame));
+  if (!lodConfig.enabled)
+    return false;
+
+  frame->frame = lodFrame++;
+  for (int b = 0; b < ENEMY_LOD_BANDS - 1; b++)
+    frame->bandEdge2[b] = lodConfig.bandDistance[b] * lodConfig.bandDistance[b];
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++)
+    frame->tickMask[b] = lodConfig.tickInterval[b] - 1;
+  return true;
+}
+
+void EndEnemyLODFrame(const EnemyLODFrame *frame, uint64_t frameNs) {
+  if (frame) {
+    memcpy(lodStats.bandCount, frame->bandCount, sizeof(lodStats.bandCount));
+    memcpy(lodStats.bandTicked, frame->bandTicked,
+           sizeof(lodStats.bandTicked));
+  } else {
+    memset(lodStats.bandCount, 0, sizeof(lodStats.bandCount));
+    memset(lodStats.bandTicked, 0, sizeof(lodStats.bandTicked));
+    lodStats.bandCount[0] = activeEnemyCount;
+    lodStats.bandTicked[0] = activeEnemyCount;
+  }
+
+  lodStats.ticked = 0;
+  for (int b = 0; b < ENEMY_LOD_BANDS; b++)
+    lodStats.ticked += lodStats.bandTicked[b];
+
+  lodStats.frameNs = frameNs;
+  if (lodStats.avgFrameNs == 0.0)
+    lodStats.avgFrameNs = (double)frameNs;
+  else
+    lodStats.avgFrameNs +=
+        ((double)frameNs - lodStats.avgFrameNs) * COST_SMOOTHING;
+}
+
+// ==========================================
+// STATS
+// ==========================================
+
+const EnemyLODStats *GetEnemyLODStats(void) { return &lodStats; }
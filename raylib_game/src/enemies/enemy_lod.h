@@ -0,0 +1,80 @@
+/**
+ * Kitchen Knight - Enemy AI Level of Detail
+ * =========================================
+ * Distance bands that tick far-away enemies every Nth frame with their
+ * accumulated frame time, staggered so each frame does a similar amount
+ * of AI work. The enemy kernel applies the schedule while it updates.
+ */
+
+#ifndef ENEMY_LOD_H
+#define ENEMY_LOD_H
+
+#include "enemy_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ENEMY_LOD_BANDS 4
+
+// Default band edges (distance to player, world units). The nearest band
+// covers the detection and attack ranges, so every state change that
+// matters to the player still happens at full rate.
+#define ENEMY_LOD_NEAR ENEMY_DETECT_RANGE
+#define ENEMY_LOD_MID 40.0f
+#define ENEMY_LOD_FAR 80.0f
+
+// Slots are staggered in groups of 8 (one AVX2 block), so whole blocks go
+// idle together and the kernel can skip them
+#define ENEMY_LOD_STAGGER_SHIFT 3
+
+typedef struct {
+  bool enabled;
+  float bandDistance[ENEMY_LOD_BANDS - 1]; // Upper edge of bands 0..2
+  int tickInterval[ENEMY_LOD_BANDS];       // Frames per tick, power of two
+} EnemyLODConfig;
+
+// Per-frame schedule handed to the kernel, which also fills in the counts
+typedef struct {
+  uint32_t frame;
+  float bandEdge2[ENEMY_LOD_BANDS - 1]; // Squared band edges
+  int32_t tickMask[ENEMY_LOD_BANDS];    // Interval - 1
+  int bandCount[ENEMY_LOD_BANDS];       // Live enemies per band (after)
+  int bandTicked[ENEMY_LOD_BANDS];      // Ticked this frame, by band before
+} EnemyLODFrame;
+
+typedef struct {
+  int bandCount[ENEMY_LOD_BANDS];  // Live enemies per band
+  int bandTicked[ENEMY_LOD_BANDS]; // Of those, updated this frame
+  int ticked;                      // Total updated this frame
+  uint64_t frameNs;                // Last UpdateEnemies cost
+  double avgFrameNs;               // Smoothed UpdateEnemies cost
+} EnemyLODStats;
+
+// --- Configuration ---
+EnemyLODConfig GetEnemyLODConfig(void);
+// Rounds intervals up to powers of two and restarts the tick stagger
+void SetEnemyLODConfig(const EnemyLODConfig *config);
+
+// --- Scheduling ---
+// Start a frame. Returns false when LOD is disabled (every slot runs).
+bool BeginEnemyLODFrame(EnemyLODFrame *frame);
+// Publish the kernel's counts; pass NULL when Begin returned false
+void EndEnemyLODFrame(const EnemyLODFrame *frame, uint64_t frameNs);
+
+// A slot ticks when (frame + slot / 8) is a multiple of its band interval
+static inline bool IsEnemyLODTick(const EnemyLODFrame *frame, int slot,
+                                  uint8_t band) {
+  uint32_t phase = frame->frame + ((uint32_t)slot >> ENEMY_LOD_STAGGER_SHIFT);
+  return (phase & (uint32_t)frame->tickMask[band]) == 0;
+}
+
+static inline uint8_t GetEnemyLODBand(const EnemyLODFrame *frame,
+                                      float dist2) {
+  return (uint8_t)((dist2 >= frame->bandEdge2[0]) +
+                   (dist2 >= frame->bandEdge2[1]) +
+                   (dist2 >= frame->bandEdge2[2]));
+}
+
+// --- Stats ---
+const EnemyLODStats *GetEnemyLODStats(void);
+
+#endif // ENEMY_LOD_H
@@ -6,54 +6,110 @@
 
 #include "enemy_types.h"
 #include "../game.h"
+#include "../assets.h"
+#include "../culling.h"
+#include "../flow_field.h"
+#include "../jobs.h"
+#include "../logger.h"
+#include "../profiler.h"
+#include "../sprite_batch.h"
+#include "../timer.h"
+#include "enemy_kernel.h"
+#include "enemy_lod.h"
 #include "raymath.h"
 #include <math.h>
-#include <stdio.h>
+#include <string.h>
 
 // --- Global Pool ---
-Enemy enemyPool[MAX_ENEMIES];
+EnemyPool enemyPool;
 int activeEnemyCount = 0;
-
-// --- Textures ---
-static Texture2D toasterTexture;
-static Texture2D blenderTexture;
-static Texture2D microwaveTexture;
-static bool texturesLoaded = false;
-
-// --- Helpers ---
-static float Clampf(float value, float min, float max) {
-  if (value < min)
-    return min;
-  if (value > max)
-    return max;
-  return value;
-}
+int enemyHighWater = 0;
+static int freeHead = -1; // First slot of the free chain
+
+_Static_assert(MAX_ENEMIES <= (1 << ENEMY_HANDLE_SLOT_BITS),
+               "enemy slots must fit in a handle");
+
+// --- Sprites (one per EnemyType, all from the atlas when it loaded) ---
+#define ENEMY_SPRITE_COUNT 3
+static const char *enemySpritePaths[ENEMY_SPRITE_COUNT] = {
+    "assets/toster.png", "assets/blender_sprite.png",
+    "assets/microwave_sprite.png"};
+static const AtlasSprite *enemySprites[ENEMY_SPRITE_COUNT]; // NULL headless
+
+// --- Draw Snapshot ---
+// DrawEnemies reads only this, so it can run while the next update moves
+// the pool
+typedef struct {
+  Vector3 position;
+  Color color; // Already flashed red when hurt
+  uint8_t type;
+} EnemyDrawItem;
+static EnemyDrawItem drawItems[MAX_ENEMIES];
+static int drawItemCount = 0;
+// Item positions again as arrays, for the SIMD culling batch
+static float drawX[MAX_ENEMIES], drawY[MAX_ENEMIES], drawZ[MAX_ENEMIES];
+static uint8_t drawVisible[MAX_ENEMIES];
+
+// --- Navigation ---
+static const LevelMap *navLevel = NULL;
+static FlowField playerFlow;
+static float steerX[MAX_ENEMIES];
+static float steerZ[MAX_ENEMIES];
+static int32_t enemyCell[MAX_ENEMIES]; // Level cell per slot, -1 if none
+static int32_t agentCells[MAX_ENEMIES]; // Cells of live enemies, packed
+
+// --- Parallel Update ---
+// Slots (or active-list entries) per job chunk; a multiple of 8 so the
+// kernel's SIMD blocks are the same as in one serial sweep
+#define ENEMY_JOB_GRAIN 1024
+
+// Each worker runs the kernel with its own LOD counters, summed afterwards
+typedef struct {
+  _Alignas(64) EnemyKernelParams params;
+  EnemyLODFrame lod;
+} EnemyWorkerScratch;
+static EnemyWorkerScratch workerScratch[JOB_MAX_WORKERS];
+
+typedef struct {
+  Vector3 playerPos;
+  const EnemyLODFrame *lod;
+} SteeringJob;
 
 // ==========================================
 // INITIALIZATION
 // ==========================================
 
-void InitEnemySystem(void) {
+void ResetEnemyPool(void) {
+  // Outstanding handles die with their enemies
+  for (int k = 0; k < activeEnemyCount; k++)
+    enemyPool.generation[enemyPool.activeList[k]]++;
+
   // Clear all enemies
+  memset(enemyPool.flags, 0, sizeof(enemyPool.flags)); // Inactive
+  memset(enemyPool.state, AI_DEAD, sizeof(enemyPool.state));
+  activeEnemyCount = 0;
+  enemyHighWater = 0;
+
+  // Chain every slot in order so spawns fill the pool from the bottom
   for (int i = 0; i < MAX_ENEMIES; i++) {
-    enemyPool[i].flags = 0; // Inactive
-    enemyPool[i].state = AI_DEAD;
+    if (enemyPool.generation[i] == 0)
+      enemyPool.generation[i] = 1; // Keeps handle 0 invalid
+    enemyPool.nextFree[i] = i + 1 < MAX_ENEMIES ? i + 1 : -1;
   }
-  activeEnemyCount = 0;
+  freeHead = 0;
+}
+
+void InitEnemySystem(void) { ResetEnemyPool(); }
+
+void LoadEnemyAssets(void) {
+  for (int t = 0; t < ENEMY_SPRITE_COUNT; t++)
+    enemySprites[t] = AcquireSprite(enemySpritePaths[t]); // Loads async
+}
 
-  // Load textures
-  toasterTexture = LoadTexture("assets/toster.png");
-  blenderTexture = LoadTexture("assets/blender_sprite.png");
-  microwaveTexture = LoadTexture("assets/microwave_sprite.png");
-
-  if (toasterTexture.id > 0 || blenderTexture.id > 0 ||
-      microwaveTexture.id > 0) {
-    texturesLoaded = true;
-    printf("[EnemySystem] Textures loaded (Toaster: %s, Blender: %s, "
-           "Microwave: %s)\n",
-           toasterTexture.id > 0 ? "OK" : "FAIL",
-           blenderTexture.id > 0 ? "OK" : "FAIL",
-           microwaveTexture.id > 0 ? "OK" : "FAIL");
+void UnloadEnemyAssets(void) {
+  for (int t = 0; t < ENEMY_SPRITE_COUNT; t++) {
+    ReleaseSprite(enemySprites[t]);
+    enemySprites[t] = NULL;
   }
 }
 
@@ -95,199 +151,370 @@ void GetEnemyDefaults(EnemyType type, int *hp, float *speed, float *attackRange,
 // SPAWN
 // ==========================================
 
-int SpawnEnemy(EnemyType type, Vector3 pos) {
-  // Find inactive slot
-  for (int i = 0; i < MAX_ENEMIES; i++) {
-    if (!(enemyPool[i].flags & ENEMY_FLAG_ACTIVE)) {
-      // Get defaults for this type
-      int hp;
-      float speed, attackRange;
-      Color color;
-      GetEnemyDefaults(type, &hp, &speed, &attackRange, &color);
-
-      enemyPool[i] = (Enemy){.type = type,
-                             .state = AI_IDLE,
-                             .position = pos,
-                             .radius = ENEMY_WIDTH / 2.0f,
-                             .hp = hp,
-                             .maxHP = hp,
-                             .flags = ENEMY_FLAG_ACTIVE,
-                             .stateTimer = 0.0f,
-                             .color = color,
-                             .attackRange = attackRange,
-                             .attackCooldown = 1.0f,
-                             .currentCooldown = 0.0f,
-                             .speed = speed};
-
-      activeEnemyCount++;
-      printf("[EnemySystem] Spawned enemy type %d at (%.1f, %.1f, %.1f) - slot "
-             "%d\n",
-             type, pos.x, pos.y, pos.z, i);
-      return i;
-    }
+static inline EnemyHandle MakeHandle(int slot) {
+  return ((uint32_t)enemyPool.generation[slot] << ENEMY_HANDLE_SLOT_BITS) |
+         (uint32_t)slot;
+}
+
+// Pop the free chain and put the slot on the active list; -1 if full
+static int AllocEnemySlot(void) {
+  int i = freeHead;
+  if (i < 0)
+    return -1;
+  freeHead = enemyPool.nextFree[i];
+
+  enemyPool.activeIndex[i] = activeEnemyCount;
+  enemyPool.activeList[activeEnemyCount++] = i;
+  if (i >= enemyHighWater)
+    enemyHighWater = i + 1;
+  return i;
+}
+
+// Swap-remove from the active list, retire the slot's handles and push it
+// on the free chain
+static void FreeEnemySlot(int i) {
+  int last = enemyPool.activeList[--activeEnemyCount];
+  int at = enemyPool.activeIndex[i];
+  enemyPool.activeList[at] = last;
+  enemyPool.activeIndex[last] = at;
+
+  if (++enemyPool.generation[i] == 0)
+    enemyPool.generation[i] = 1;
+  enemyPool.nextFree[i] = freeHead;
+  freeHead = i;
+}
+
+static void InitEnemySlot(int i, EnemyType type, Vector3 pos) {
+  // Get defaults for this type
+  int hp;
+  float speed, attackRange;
+  Color color;
+  GetEnemyDefaults(type, &hp, &speed, &attackRange, &color);
+
+  enemyPool.type[i] = (uint8_t)type;
+  enemyPool.state[i] = AI_IDLE;
+  enemyPool.posX[i] = pos.x;
+  enemyPool.posY[i] = pos.y;
+  enemyPool.posZ[i] = pos.z;
+  enemyPool.prevX[i] = pos.x;
+  enemyPool.prevY[i] = pos.y;
+  enemyPool.prevZ[i] = pos.z;
+  enemyPool.radius[i] = ENEMY_WIDTH / 2.0f;
+  enemyPool.hp[i] = hp;
+  enemyPool.maxHP[i] = hp;
+  enemyPool.flags[i] = ENEMY_FLAG_ACTIVE;
+  enemyPool.stateTimer[i] = 0.0f;
+  enemyPool.color[i] = color;
+  enemyPool.attackRange[i] = attackRange;
+  enemyPool.attackCooldown[i] = 1.0f;
+  enemyPool.currentCooldown[i] = 0.0f;
+  enemyPool.speed[i] = speed;
+  enemyPool.lodBand[i] = 0; // Re-banded on its first tick
+  enemyPool.lodAccum[i] = 0.0f;
+}
+
+EnemyHandle SpawnEnemy(EnemyType type, Vector3 pos) {
+  int i = AllocEnemySlot();
+  if (i < 0) {
+    LOG_WARN("[EnemySystem] WARNING: No free slots for enemy spawn!\n");
+    return ENEMY_HANDLE_NONE;
   }
 
-  printf("[EnemySystem] WARNING: No free slots for enemy spawn!\n");
-  return -1;
+  InitEnemySlot(i, type, pos);
+  LOG_DEBUG("[EnemySystem] Spawned enemy type %d at (%.1f, %.1f, %.1f) - "
+            "slot %d\n",
+            type, pos.x, pos.y, pos.z, i);
+  return MakeHandle(i);
+}
+
+int SpawnEnemyWave(EnemyType type, const Vector3 *positions, int count) {
+  int spawned = 0;
+  for (; spawned < count; spawned++) {
+    int i = AllocEnemySlot();
+    if (i < 0)
+      break;
+    InitEnemySlot(i, type, positions[spawned]);
+  }
+
+  LOG_INFO("[EnemySystem] Spawned wave of %d/%d enemies (type %d)\n",
+           spawned, count, type);
+  return spawned;
 }
 
 // ==========================================
 // UPDATE
 // ==========================================
 
-static void UpdateSingleEnemy(Enemy *enemy, const GameState *game, float dt) {
-  if (!(enemy->flags & ENEMY_FLAG_ACTIVE))
-    return;
-  if (enemy->state == AI_DEAD)
-    return;
+void SetEnemyLevel(const LevelMap *level) {
+  UnloadFlowField(&playerFlow);
+  navLevel = NULL;
+  if (level && level->data &&
+      InitFlowField(&playerFlow, level->width, level->height))
+    navLevel = level;
+}
 
-  // Handle hurt state (brief stun)
-  if (enemy->flags & ENEMY_FLAG_HURT) {
-    enemy->stateTimer -= dt;
-    if (enemy->stateTimer <= 0) {
-      enemy->flags &= ~ENEMY_FLAG_HURT;
-      enemy->state = AI_CHASE;
+// Level cell of every live enemy; returns the packed agent count
+static int GatherEnemyCells(void) {
+  int count = 0;
+  for (int k = 0; k < activeEnemyCount; k++) {
+    int i = enemyPool.activeList[k];
+    enemyCell[i] = -1;
+
+    int cellX, cellZ;
+    if (WorldToCell(navLevel, GetEnemyPosition(i), &cellX, &cellZ)) {
+      enemyCell[i] = cellZ * navLevel->width + cellX;
+      agentCells[count++] = enemyCell[i];
     }
-    return; // Skip movement while hurt
   }
+  return count;
+}
 
-  // Calculate distance to player
-  float dist = Vector3Distance(enemy->position, game->playerPos);
+// Turn the flow field into a unit chase direction per slot: head for the
+// centre of the next cell on the path, or straight at the player once in
+// the player's cell. Enemies with no path hold position. Slots off their
+// LOD tick are skipped. Runs over a range of the active list.
+static void ComputeFlowSteering(void *ctx, int begin, int end, int worker) {
+  (void)worker;
+  Vector3 playerPos = ((const SteeringJob *)ctx)->playerPos;
+  const EnemyLODFrame *lod = ((const SteeringJob *)ctx)->lod;
+  for (int k = begin; k < end; k++) {
+    int i = enemyPool.activeList[k];
+    steerX[i] = 0.0f;
+    steerZ[i] = 0.0f;
+    if (enemyCell[i] < 0)
+      continue;
+    if (lod && !IsEnemyLODTick(lod, i, enemyPool.lodBand[i]))
+      continue;
 
-  // State transitions
-  if (enemy->state == AI_IDLE) {
-    if (dist < 20.0f) { // Detection range
-      enemy->state = AI_CHASE;
+    Vector3 pos = GetEnemyPosition(i);
+    int cellX = enemyCell[i] % navLevel->width;
+    int cellZ = enemyCell[i] / navLevel->width;
+    int nextX, nextZ;
+    Vector3 target;
+    if (cellX == playerFlow.goalX && cellZ == playerFlow.goalZ) {
+      target = playerPos;
+    } else if (GetFlowStep(&playerFlow, cellX, cellZ, &nextX, &nextZ)) {
+      target = GridToWorld(nextX, nextZ, navLevel->width, navLevel->height);
+    } else {
+      continue;
     }
-  }
 
-  if (enemy->state == AI_CHASE) {
-    if (dist <= enemy->attackRange) {
-      enemy->state = AI_ATTACK;
-      enemy->stateTimer = 0.5f; // Attack windup
+    float dx = target.x - pos.x;
+    float dz = target.z - pos.z;
+    float len = sqrtf(dx * dx + dz * dz);
+    if (len != 0.0f) {
+      steerX[i] = dx / len;
+      steerZ[i] = dz / len;
     }
   }
+}
 
-  // Movement (chase state)
-  if (enemy->state == AI_CHASE) {
-    Vector3 dir = Vector3Subtract(game->playerPos, enemy->position);
-    dir.y = 0; // Keep on ground
-    dir = Vector3Normalize(dir);
-
-    enemy->position =
-        Vector3Add(enemy->position, Vector3Scale(dir, enemy->speed * dt));
+static void UpdateEnemyChunk(void *ctx, int begin, int end, int worker) {
+  (void)ctx;
+  UpdateEnemyRange(&enemyPool, begin, end, &workerScratch[worker].params);
+}
 
-    // Keep within arena
-    float halfArena = (ARENA_SIZE / 2.0f) - 1.0f;
-    enemy->position.x = Clampf(enemy->position.x, -halfArena, halfArena);
-    enemy->position.z = Clampf(enemy->position.z, -halfArena, halfArena);
+void UpdateEnemies(GameState *game, float dt) {
+  PROFILE_BEGIN(zone, "UpdateEnemies");
+  uint64_t start = GetTimestampNs();
+
+  // Kills leave the high-water mark alone to stay O(1); trim it here
+  while (enemyHighWater > 0 &&
+         !(enemyPool.flags[enemyHighWater - 1] & ENEMY_FLAG_ACTIVE))
+    enemyHighWater--;
+
+  // Keep within arena (or the loaded level's extents)
+  float halfX = (ARENA_SIZE / 2.0f) - 1.0f;
+  float halfZ = halfX;
+  if (navLevel) {
+    halfX = (navLevel->width * MAP_CELL_SIZE) / 2.0f - 1.0f;
+    halfZ = (navLevel->height * MAP_CELL_SIZE) / 2.0f - 1.0f;
   }
-
-  // Attack state
-  if (enemy->state == AI_ATTACK) {
-    enemy->stateTimer -= dt;
-    if (enemy->stateTimer <= 0) {
-      // TODO: Execute attack (projectile for toaster, charge for blender)
-      enemy->state = AI_CHASE;
-      enemy->currentCooldown = enemy->attackCooldown;
-    }
+  EnemyKernelParams params = {.playerX = game->playerPos.x,
+                              .playerY = game->playerPos.y,
+                              .playerZ = game->playerPos.z,
+                              .dt = dt,
+                              .minX = -halfX,
+                              .maxX = halfX,
+                              .minZ = -halfZ,
+                              .maxZ = halfZ};
+
+  // Far enemies tick every few frames with their banked dt
+  EnemyLODFrame lodFrame;
+  if (BeginEnemyLODFrame(&lodFrame))
+    params.lod = &lodFrame;
+
+  if (navLevel) {
+    // Re-plan only when the player crosses into another open cell: repair
+    // out to the farthest enemy, or rebuild if that covers most of the map
+    int agentCount = GatherEnemyCells();
+    int goalX, goalZ;
+    if (WorldToCell(navLevel, game->playerPos, &goalX, &goalZ) &&
+        GetCell(navLevel, goalX, goalZ) != CELL_WALL)
+      RetargetFlowField(&playerFlow, navLevel, goalX, goalZ, agentCells,
+                        agentCount);
+
+    SteeringJob steering = {game->playerPos, params.lod};
+    ParallelFor(0, activeEnemyCount, ENEMY_JOB_GRAIN, ComputeFlowSteering,
+                &steering);
+    params.steerX = steerX;
+    params.steerZ = steerZ;
   }
 
-  // Attack cooldown
-  if (enemy->currentCooldown > 0) {
-    enemy->currentCooldown -= dt;
+  // Slots are independent, so any split gives the serial result; only the
+  // LOD counters are shared and those are kept per worker
+  int workers = GetJobWorkerCount();
+  for (int w = 0; w < workers; w++) {
+    workerScratch[w].params = params;
+    if (params.lod) {
+      workerScratch[w].lod = lodFrame;
+      workerScratch[w].params.lod = &workerScratch[w].lod;
+    }
   }
-}
-
-void UpdateEnemies(GameState *game, float dt) {
-  for (int i = 0; i < MAX_ENEMIES; i++) {
-    UpdateSingleEnemy(&enemyPool[i], game, dt);
+  ParallelFor(0, enemyHighWater, ENEMY_JOB_GRAIN, UpdateEnemyChunk, NULL);
+  if (params.lod) {
+    for (int w = 0; w < workers; w++) {
+      for (int b = 0; b < ENEMY_LOD_BANDS; b++) {
+        lodFrame.bandCount[b] += workerScratch[w].lod.bandCount[b];
+        lodFrame.bandTicked[b] += workerScratch[w].lod.bandTicked[b];
+      }
+    }
   }
+  EndEnemyLODFrame(params.lod, GetTimestampNs() - start);
+  PROFILE_END(zone);
 }
 
 // ==========================================
 // DAMAGE
 // ==========================================
 
-void DamageEnemy(int index, int damage) {
-  if (index < 0 || index >= MAX_ENEMIES)
-    return;
-  if (!(enemyPool[index].flags & ENEMY_FLAG_ACTIVE))
+void DamageEnemy(EnemyHandle handle, int damage) {
+  int index = GetEnemySlot(handle);
+  if (index < 0)
     return;
 
-  Enemy *enemy = &enemyPool[index];
-  enemy->hp -= damage;
-  enemy->flags |= ENEMY_FLAG_HURT;
-  enemy->state = AI_HURT;
-  enemy->stateTimer = 0.2f; // Hurt stun duration
+  enemyPool.hp[index] -= damage;
+  enemyPool.flags[index] |= ENEMY_FLAG_HURT;
+  enemyPool.state[index] = AI_HURT;
+  enemyPool.stateTimer[index] = ENEMY_HURT_STUN;
+  enemyPool.lodBand[index] = 0; // React (and recover) at full rate
+  enemyPool.lodAccum[index] = 0.0f; // Far-band banked time is dropped
 
-  printf("[EnemySystem] Enemy %d took %d damage, HP: %d/%d\n", index, damage,
-         enemy->hp, enemy->maxHP);
+  LOG_DEBUG("[EnemySystem] Enemy %d took %d damage, HP: %d/%d\n", index,
+            damage, enemyPool.hp[index], enemyPool.maxHP[index]);
 
-  if (enemy->hp <= 0) {
-    KillEnemy(index);
+  if (enemyPool.hp[index] <= 0) {
+    KillEnemy(handle);
   }
 }
 
-void KillEnemy(int index) {
-  if (index < 0 || index >= MAX_ENEMIES)
+void KillEnemy(EnemyHandle handle) {
+  int index = GetEnemySlot(handle);
+  if (index < 0)
     return;
 
-  enemyPool[index].flags &= ~ENEMY_FLAG_ACTIVE;
-  enemyPool[index].state = AI_DEAD;
-  activeEnemyCount--;
+  enemyPool.flags[index] &= ~ENEMY_FLAG_ACTIVE;
+  enemyPool.state[index] = AI_DEAD;
+  FreeEnemySlot(index);
 
-  printf("[EnemySystem] Enemy %d destroyed! Active: %d\n", index,
-         activeEnemyCount);
+  LOG_DEBUG("[EnemySystem] Enemy %d destroyed! Active: %d\n", index,
+            activeEnemyCount);
 
   // TODO: Spawn particles at enemy position
 }
 
+// ==========================================
+// ACCESSORS
+// ==========================================
+
+EnemyHandle GetEnemyHandle(int index) {
+  if (index < 0 || index >= MAX_ENEMIES ||
+      !(enemyPool.flags[index] & ENEMY_FLAG_ACTIVE))
+    return ENEMY_HANDLE_NONE;
+  return MakeHandle(index);
+}
+
+int GetEnemySlot(EnemyHandle handle) {
+  int index = (int)(handle & ENEMY_HANDLE_SLOT_MASK);
+  if (handle == ENEMY_HANDLE_NONE || index >= MAX_ENEMIES)
+    return -1;
+  if ((handle >> ENEMY_HANDLE_SLOT_BITS) != enemyPool.generation[index] ||
+      !(enemyPool.flags[index] & ENEMY_FLAG_ACTIVE))
+    return -1;
+  return index;
+}
+
+bool IsEnemyAlive(EnemyHandle handle) {
+  int index = GetEnemySlot(handle);
+  return index >= 0 && enemyPool.state[index] != AI_DEAD;
+}
+
+Vector3 GetEnemyPosition(int index) {
+  return (Vector3){enemyPool.posX[index], enemyPool.posY[index],
+                   enemyPool.posZ[index]};
+}
+
 // ==========================================
 // RENDERING
 // ==========================================
 
-void DrawEnemies(const GameState *game) {
-  for (int i = 0; i < MAX_ENEMIES; i++) {
-    if (!(enemyPool[i].flags & ENEMY_FLAG_ACTIVE))
-      continue;
-    if (enemyPool[i].state == AI_DEAD)
+void SaveEnemyInterpolationState(void) {
+  // Whole span in three block copies; dead slots come along for free
+  size_t bytes = (size_t)enemyHighWater * sizeof(float);
+  memcpy(enemyPool.prevX, enemyPool.posX, bytes);
+  memcpy(enemyPool.prevY, enemyPool.posY, bytes);
+  memcpy(enemyPool.prevZ, enemyPool.posZ, bytes);
+}
+
+void PublishEnemyDrawState(float alpha) {
+  drawItemCount = 0;
+  for (int k = 0; k < activeEnemyCount; k++) {
+    int i = enemyPool.activeList[k];
+    if (enemyPool.state[i] == AI_DEAD)
       continue;
 
-    Enemy *enemy = &enemyPool[i];
+    EnemyDrawItem *item = &drawItems[drawItemCount++];
+    Vector3 prev = {enemyPool.prevX[i], enemyPool.prevY[i],
+                    enemyPool.prevZ[i]};
+    item->position = Vector3Lerp(prev, GetEnemyPosition(i), alpha);
+    item->type = enemyPool.type[i];
+    drawX[drawItemCount - 1] = item->position.x;
+    drawY[drawItemCount - 1] = item->position.y;
+    drawZ[drawItemCount - 1] = item->position.z;
 
     // Flash red when hurt
-    Color drawColor = enemy->color;
-    if (enemy->flags & ENEMY_FLAG_HURT) {
-      drawColor = RED;
+    item->color = enemyPool.color[i];
+    if (enemyPool.flags[i] & ENEMY_FLAG_HURT) {
+      item->color = RED;
     }
+  }
+}
 
-    if (texturesLoaded) {
-      Texture2D *tex = NULL;
-      if (enemy->type == ENEMY_TOASTER && toasterTexture.id > 0)
-        tex = &toasterTexture;
-      else if (enemy->type == ENEMY_BLENDER && blenderTexture.id > 0)
-        tex = &blenderTexture;
-      else if (enemy->type == ENEMY_MICROWAVE && microwaveTexture.id > 0)
-        tex = &microwaveTexture;
-
-      if (tex) {
-        BeginBlendMode(BLEND_ALPHA);
-        DrawBillboard(game->camera, *tex, enemy->position, 4.0f, drawColor);
-        EndBlendMode();
-      } else {
-        // Fallback cube rendering if texture failed
-        DrawCube(enemy->position, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH,
-                 drawColor);
-        DrawCubeWires(enemy->position, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH,
-                      BLACK);
-      }
+int GetEnemyDrawCount(void) { return drawItemCount; }
+
+// Sprites go through the batcher: one draw call for the whole atlas
+void DrawEnemies(const GameState *game) {
+  PROFILE_BEGIN(zone, "DrawEnemies");
+  CullSpheres(CULL_ENEMIES, drawX, drawY, drawZ, ENEMY_CULL_RADIUS,
+              drawItemCount, drawVisible);
+  BeginSpriteBatch(game->camera);
+  for (int k = 0; k < drawItemCount; k++) {
+    if (!drawVisible[k])
+      continue;
+    Vector3 position = drawItems[k].position;
+    EnemyType type = (EnemyType)drawItems[k].type;
+    Color drawColor = drawItems[k].color;
+
+    const AtlasSprite *sprite =
+        (int)type < ENEMY_SPRITE_COUNT ? enemySprites[type] : NULL;
+    if (sprite && sprite->texture.id > 0) {
+      PushSprite(sprite->texture, sprite->source, position, 4.0f, drawColor);
     } else {
-      // Fallback cube rendering
-      DrawCube(enemy->position, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH,
-               drawColor);
-      DrawCubeWires(enemy->position, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH,
-                    BLACK);
+      // Fallback cube until the sprite has loaded (or if it can't)
+      DrawCube(position, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH, drawColor);
+      DrawCubeWires(position, ENEMY_WIDTH, ENEMY_HEIGHT, ENEMY_DEPTH, BLACK);
     }
   }
+  EndSpriteBatch();
+  PROFILE_END(zone);
 }
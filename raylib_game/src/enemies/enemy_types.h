@@ -34,37 +34,95 @@ typedef enum {
 #define ENEMY_FLAG_BURNING 0x04
 #define ENEMY_FLAG_STUNNED 0x08
 
-// --- Enemy Struct ---
-typedef struct {
-  EnemyType type;
-  AIState state;
-  Vector3 position;
-  float radius;
-  int hp;
-  int maxHP;
-  uint8_t flags; // ENEMY_FLAG_ACTIVE | ENEMY_FLAG_HURT etc.
-  float stateTimer;
-  Color color;
-  // Type-specific
-  float attackRange;
-  float attackCooldown;
-  float currentCooldown;
-  // Movement speed (type-dependent)
-  float speed;
-} Enemy;
+// --- AI Tuning ---
+#define ENEMY_DETECT_RANGE 20.0f  // Idle enemies wake up inside this radius
+#define ENEMY_ATTACK_WINDUP 0.5f  // Seconds between entering attack and firing
+#define ENEMY_HURT_STUN 0.2f      // Seconds of stun after taking damage
+
+// --- Drawing ---
+#define ENEMY_CULL_RADIUS 3.0f // Bounds of a 4-unit billboard, about square
 
 // --- Pool ---
-#define MAX_ENEMIES 64
-extern Enemy enemyPool[MAX_ENEMIES];
+// Horde waves need tens of thousands of slots. Keep this a multiple of 8 so
+// the AVX2 kernel never straddles the end of the arrays.
+#define MAX_ENEMIES 65536
+
+// --- Handles ---
+// Generational reference to a pool slot: the low 16 bits are the slot, the
+// high 16 bits the slot's generation when the handle was made. Killing an
+// enemy bumps its slot's generation, so a kept handle stops resolving
+// instead of pointing at whatever spawns there next. 0 is never valid.
+typedef uint32_t EnemyHandle;
+#define ENEMY_HANDLE_NONE 0u
+#define ENEMY_HANDLE_SLOT_BITS 16
+#define ENEMY_HANDLE_SLOT_MASK ((1u << ENEMY_HANDLE_SLOT_BITS) - 1u)
+
+// Structure-of-arrays pool, indexed by slot. The hot block is everything the
+// per-frame AI kernel reads or writes; the cold block is only touched on
+// spawn, damage and draw.
+typedef struct {
+  // Hot
+  float posX[MAX_ENEMIES];
+  float posY[MAX_ENEMIES];
+  float posZ[MAX_ENEMIES];
+  float speed[MAX_ENEMIES];
+  float stateTimer[MAX_ENEMIES];
+  float currentCooldown[MAX_ENEMIES];
+  float attackRange[MAX_ENEMIES];
+  float attackCooldown[MAX_ENEMIES];
+  uint8_t state[MAX_ENEMIES]; // AIState
+  uint8_t flags[MAX_ENEMIES]; // ENEMY_FLAG_ACTIVE | ENEMY_FLAG_HURT etc.
+  uint8_t lodBand[MAX_ENEMIES]; // AI level of detail (enemy_lod.h)
+  float lodAccum[MAX_ENEMIES];  // Step time since the last AI tick
+
+  // Cold
+  uint8_t type[MAX_ENEMIES]; // EnemyType
+  float radius[MAX_ENEMIES];
+  int hp[MAX_ENEMIES];
+  int maxHP[MAX_ENEMIES];
+  Color color[MAX_ENEMIES];
+  float prevX[MAX_ENEMIES]; // Position before the last fixed step, for
+  float prevY[MAX_ENEMIES]; // drawing between steps
+  float prevZ[MAX_ENEMIES];
+
+  // Allocation. Slots never move (the kernel sweeps them in SIMD blocks);
+  // free slots are chained through nextFree and live slots are also kept
+  // packed in activeList for loops that only want the living.
+  uint16_t generation[MAX_ENEMIES];
+  int32_t nextFree[MAX_ENEMIES];   // Next free slot, -1 ends the chain
+  int32_t activeList[MAX_ENEMIES]; // Live slots, activeEnemyCount entries
+  int32_t activeIndex[MAX_ENEMIES]; // Slot's position in activeList
+} EnemyPool;
+
+extern EnemyPool enemyPool;
 extern int activeEnemyCount;
+extern int enemyHighWater; // One past the highest slot in use (trimmed once
+                           // per update, so it may briefly overshoot)
 
 // --- Functions ---
-void InitEnemySystem(void);
-int SpawnEnemy(EnemyType type, Vector3 pos);
+void InitEnemySystem(void);   // Pool only, no window needed
+void LoadEnemyAssets(void);   // Sprites (needs a window)
+void UnloadEnemyAssets(void);
+void ResetEnemyPool(void); // Clears all slots, no asset loading
+EnemyHandle SpawnEnemy(EnemyType type, Vector3 pos); // NONE if pool is full
+int SpawnEnemyWave(EnemyType type, const Vector3 *positions, int count);
 void UpdateEnemies(GameState *game, float dt);
+void SetEnemyLevel(const LevelMap *level); // NULL = open arena, direct chase
+void SaveEnemyInterpolationState(void); // Before the frame's last step
+// Snapshot for DrawEnemies (sim idle), alpha of the way into the last step
+void PublishEnemyDrawState(float alpha);
+int GetEnemyDrawCount(void); // Live enemies in the snapshot
 void DrawEnemies(const GameState *game);
-void DamageEnemy(int index, int damage);
-void KillEnemy(int index);
+void DamageEnemy(EnemyHandle handle, int damage); // Stale handles are ignored
+void KillEnemy(EnemyHandle handle);
+
+// Handles
+EnemyHandle GetEnemyHandle(int index); // Current occupant of a live slot
+int GetEnemySlot(EnemyHandle handle);  // -1 if dead or recycled
+bool IsEnemyAlive(EnemyHandle handle);
+
+// Slot accessors
+Vector3 GetEnemyPosition(int index);
 
 // Get enemy default stats by type
 void GetEnemyDefaults(EnemyType type, int *hp, float *speed, float *attackRange,
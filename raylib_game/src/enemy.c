@@ -78,9 +78,7 @@ EnemyAction GetAIAction(const GameState *game) {
 // UPDATE
 // ==========================================
 
-void UpdateEnemy(GameState *game) {
-  float dt = GetFrameTime();
-
+void UpdateEnemy(GameState *game, float dt) {
   // Get AI action
   EnemyAction action = GetAIAction(game);
 
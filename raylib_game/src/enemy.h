@@ -22,7 +22,7 @@ typedef enum {
 void InitEnemy(GameState *game);
 
 // Update enemy AI and movement
-void UpdateEnemy(GameState *game);
+void UpdateEnemy(GameState *game, float dt);
 
 // Draw the enemy cube
 void DrawEnemy(const GameState *game);
@@ -0,0 +1,437 @@
+/**
+ * Kitchen Knight - Flow Field Implementation
+ * ==========================================
+ * Dijkstra from the goal outward using Dial's bucket queue: step costs are
+ * small integers, so the priority queue is a ring of buckets indexed by
+ * cost and every push/pop is O(1). Each cell records the direction of the
+ * neighbour it was reached from, which is its next step toward the goal.
+ */
+
+#include "flow_field.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A repair pays a heap operation and eight rhs recomputations per settled
+// cell, measured at ~15x the per-cell cost of the bucket-queue build
+#define REPAIR_COST_RATIO 16
+
+// Direction table: even codes are straight, odd codes diagonal, and
+// (d + 4) & 7 is the opposite direction
+static const int dirOffsetX[FLOW_DIR_COUNT] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int dirOffsetZ[FLOW_DIR_COUNT] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// ==========================================
+// LIFECYCLE
+// ==========================================
+
+bool InitFlowField(FlowField *field, int width, int height) {
+  memset(field, 0, sizeof(*field));
+  size_t cells = (size_t)width * (size_t)height;
+  field->cost = malloc(cells * sizeof(uint32_t));
+  field->dir = malloc(cells);
+  field->rhs = malloc(cells * sizeof(uint32_t));
+  field->heap = malloc(cells * sizeof(int32_t));
+  field->heapKey = malloc(cells * sizeof(uint32_t));
+  field->heapIndex = malloc(cells * sizeof(int32_t));
+  if (!field->cost || !field->dir || !field->rhs || !field->heap ||
+      !field->heapKey || !field->heapIndex) {
+    printf("[FlowField] Failed to allocate %dx%d field\n", width, height);
+    UnloadFlowField(field);
+    return false;
+  }
+
+  field->width = width;
+  field->height = height;
+  field->goalX = -1;
+  field->goalZ = -1;
+  memset(field->dir, FLOW_DIR_NONE, cells);
+  memset(field->heapIndex, 0xFF, cells * sizeof(int32_t)); // All -1
+  for (size_t i = 0; i < cells; i++)
+    field->cost[i] = field->rhs[i] = FLOW_COST_UNREACHABLE;
+  return true;
+}
+
+void UnloadFlowField(FlowField *field) {
+  free(field->cost);
+  free(field->dir);
+  free(field->rhs);
+  free(field->heap);
+  free(field->heapKey);
+  free(field->heapIndex);
+  for (int b = 0; b < FLOW_BUCKET_COUNT; b++)
+    free(field->buckets[b].cells);
+  memset(field, 0, sizeof(*field));
+  field->goalX = -1;
+  field->goalZ = -1;
+}
+
+// ==========================================
+// BUILDING
+// ==========================================
+
+static inline bool IsOpen(const LevelMap *map, int x, int z) {
+  return x >= 0 && x < map->width && z >= 0 && z < map->height &&
+         map->data[z * map->width + x] != CELL_WALL;
+}
+
+static bool PushCell(FlowBucket *bucket, int32_t cell) {
+  if (bucket->count == bucket->capacity) {
+    int capacity = bucket->capacity ? bucket->capacity * 2 : 256;
+    int32_t *cells = realloc(bucket->cells, sizeof(int32_t) * capacity);
+    if (!cells)
+      return false; // Out of memory: the cell keeps its cost, not expanded
+    bucket->cells = cells;
+    bucket->capacity = capacity;
+  }
+  bucket->cells[bucket->count++] = cell;
+  return true;
+}
+
+void BuildFlowField(FlowField *field, const LevelMap *map, int goalX,
+                    int goalZ) {
+  uint64_t start = GetTimestampNs();
+  int width = field->width;
+  size_t cells = (size_t)width * (size_t)field->height;
+
+  for (size_t i = 0; i < cells; i++)
+    field->cost[i] = FLOW_COST_UNREACHABLE;
+  memset(field->dir, FLOW_DIR_NONE, cells);
+  field->goalX = goalX;
+  field->goalZ = goalZ;
+
+  if (IsOpen(map, goalX, goalZ)) {
+    int32_t goal = goalZ * width + goalX;
+    field->cost[goal] = 0;
+    int pending = PushCell(&field->buckets[0], goal) ? 1 : 0;
+
+    for (uint32_t d = 0; pending > 0; d++) {
+      FlowBucket *bucket = &field->buckets[d % FLOW_BUCKET_COUNT];
+      // Relaxing pushes to d + 10 or d + 14, never back into this bucket
+      for (int k = 0; k < bucket->count; k++) {
+        int32_t cell = bucket->cells[k];
+        if (field->cost[cell] != d)
+          continue; // Stale entry, a cheaper path was found later
+
+        int x = cell % width;
+        int z = cell / width;
+        for (int dir = 0; dir < FLOW_DIR_COUNT; dir++) {
+          int nx = x + dirOffsetX[dir];
+          int nz = z + dirOffsetZ[dir];
+          if (!IsOpen(map, nx, nz))
+            continue;
+
+          bool diagonal = dir & 1;
+          if (diagonal && (!IsOpen(map, nx, z) || !IsOpen(map, x, nz)))
+            continue; // Would clip a wall corner
+
+          uint32_t cost =
+              d + (diagonal ? FLOW_COST_DIAGONAL : FLOW_COST_STRAIGHT);
+          int32_t next = nz * width + nx;
+          if (cost < field->cost[next]) {
+            field->cost[next] = cost;
+            field->dir[next] = (uint8_t)((dir + 4) & 7); // Back toward cell
+            if (PushCell(&field->buckets[cost % FLOW_BUCKET_COUNT], next))
+              pending++;
+          }
+        }
+      }
+      pending -= bucket->count;
+      bucket->count = 0;
+    }
+  }
+
+  // A fresh build is fully consistent: nothing left for repairs to do
+  memcpy(field->rhs, field->cost, cells * sizeof(uint32_t));
+  field->reachableCells = 0;
+  for (size_t i = 0; i < cells; i++)
+    field->reachableCells += field->cost[i] != FLOW_COST_UNREACHABLE;
+  for (int i = 0; i < field->heapCount; i++)
+    field->heapIndex[field->heap[i]] = -1;
+  field->heapCount = 0;
+
+  field->buildCount++;
+  field->lastBuildNs = GetTimestampNs() - start;
+}
+
+bool UpdateFlowFieldGoal(FlowField *field, const LevelMap *map, int goalX,
+                         int goalZ) {
+  if (goalX == field->goalX && goalZ == field->goalZ)
+    return false;
+  BuildFlowField(field, map, goalX, goalZ);
+  return true;
+}
+
+// ==========================================
+// INCREMENTAL REPAIR
+// ==========================================
+// Lifelong Planning A* with a zero heuristic, searching outward from the
+// goal like the full build. Moving the goal only changes the rhs of the old
+// and new goal cells; a wall edit changes the 3x3 block around it (corner
+// cutting rules included). The repair then re-settles just the cells whose
+// cost actually changes, in cost order.
+
+static inline uint32_t CellKey(const FlowField *field, int32_t cell) {
+  uint32_t g = field->cost[cell];
+  uint32_t rhs = field->rhs[cell];
+  return g < rhs ? g : rhs;
+}
+
+static void HeapSwap(FlowField *field, int a, int b) {
+  int32_t cellA = field->heap[a];
+  int32_t cellB = field->heap[b];
+  uint32_t keyA = field->heapKey[a];
+  field->heap[a] = cellB;
+  field->heapKey[a] = field->heapKey[b];
+  field->heap[b] = cellA;
+  field->heapKey[b] = keyA;
+  field->heapIndex[cellB] = a;
+  field->heapIndex[cellA] = b;
+}
+
+static void HeapSiftUp(FlowField *field, int i) {
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (field->heapKey[parent] <= field->heapKey[i])
+      break;
+    HeapSwap(field, i, parent);
+    i = parent;
+  }
+}
+
+static void HeapSiftDown(FlowField *field, int i) {
+  for (;;) {
+    int left = i * 2 + 1;
+    int smallest = i;
+    if (left < field->heapCount &&
+        field->heapKey[left] < field->heapKey[smallest])
+      smallest = left;
+    if (left + 1 < field->heapCount &&
+        field->heapKey[left + 1] < field->heapKey[smallest])
+      smallest = left + 1;
+    if (smallest == i)
+      break;
+    HeapSwap(field, i, smallest);
+    i = smallest;
+  }
+}
+
+static void HeapRemove(FlowField *field, int32_t cell) {
+  int i = field->heapIndex[cell];
+  int last = --field->heapCount;
+  field->heapIndex[cell] = -1;
+  if (i == last)
+    return;
+
+  // Move the last entry into the hole and restore heap order around it
+  int32_t moved = field->heap[last];
+  field->heap[i] = moved;
+  field->heapKey[i] = field->heapKey[last];
+  field->heapIndex[moved] = i;
+  HeapSiftUp(field, i);
+  HeapSiftDown(field, field->heapIndex[moved]);
+}
+
+// Queue, re-key or dequeue a cell after its cost or rhs changed
+static void HeapUpdate(FlowField *field, int32_t cell) {
+  bool consistent = field->cost[cell] == field->rhs[cell];
+  int i = field->heapIndex[cell];
+
+  if (consistent) {
+    if (i >= 0)
+      HeapRemove(field, cell);
+    return;
+  }
+
+  uint32_t key = CellKey(field, cell);
+  if (i < 0) {
+    i = field->heapCount++;
+    field->heap[i] = cell;
+    field->heapIndex[cell] = i;
+    field->heapKey[i] = key;
+    HeapSiftUp(field, i);
+  } else {
+    uint32_t old = field->heapKey[i];
+    field->heapKey[i] = key;
+    if (key < old)
+      HeapSiftUp(field, i);
+    else
+      HeapSiftDown(field, i);
+  }
+}
+
+// Recompute rhs (best neighbour cost + step) and the direction toward it
+static void UpdateCell(FlowField *field, const LevelMap *map, int x, int z) {
+  if (x < 0 || x >= field->width || z < 0 || z >= field->height)
+    return;
+
+  int32_t cell = z * field->width + x;
+  uint32_t best = FLOW_COST_UNREACHABLE;
+  uint8_t bestDir = FLOW_DIR_NONE;
+
+  if (x == field->goalX && z == field->goalZ && IsOpen(map, x, z)) {
+    best = 0;
+  } else if (IsOpen(map, x, z)) {
+    for (int dir = 0; dir < FLOW_DIR_COUNT; dir++) {
+      int nx = x + dirOffsetX[dir];
+      int nz = z + dirOffsetZ[dir];
+      if (!IsOpen(map, nx, nz))
+        continue;
+
+      bool diagonal = dir & 1;
+      if (diagonal && (!IsOpen(map, nx, z) || !IsOpen(map, x, nz)))
+        continue;
+
+      uint32_t g = field->cost[nz * field->width + nx];
+      if (g == FLOW_COST_UNREACHABLE)
+        continue;
+      uint32_t cost = g + (diagonal ? FLOW_COST_DIAGONAL : FLOW_COST_STRAIGHT);
+      if (cost < best) {
+        best = cost;
+        bestDir = (uint8_t)dir;
+      }
+    }
+  }
+
+  field->rhs[cell] = best;
+  field->dir[cell] = bestDir;
+  field->lastRepairTouched++;
+  HeapUpdate(field, cell);
+}
+
+static void UpdateBlock(FlowField *field, const LevelMap *map, int x, int z) {
+  for (int nz = z - 1; nz <= z + 1; nz++) {
+    for (int nx = x - 1; nx <= x + 1; nx++)
+      UpdateCell(field, map, nx, nz);
+  }
+}
+
+void MoveFlowFieldGoal(FlowField *field, const LevelMap *map, int goalX,
+                       int goalZ) {
+  int oldX = field->goalX;
+  int oldZ = field->goalZ;
+  field->goalX = goalX;
+  field->goalZ = goalZ;
+  UpdateCell(field, map, oldX, oldZ);
+  UpdateCell(field, map, goalX, goalZ);
+}
+
+void NotifyFlowFieldCellChanged(FlowField *field, const LevelMap *map, int x,
+                                int z) {
+  UpdateBlock(field, map, x, z);
+}
+
+// Pop and settle every queued cell with key <= bound
+static void SettleUpTo(FlowField *field, const LevelMap *map, uint32_t bound) {
+  int width = field->width;
+  while (field->heapCount > 0 && field->heapKey[0] <= bound) {
+    int32_t cell = field->heap[0];
+    int x = cell % width;
+    int z = cell / width;
+    HeapRemove(field, cell);
+    field->lastRepairExpanded++;
+
+    if (field->cost[cell] > field->rhs[cell]) {
+      // Cheaper path found: lock it in
+      field->cost[cell] = field->rhs[cell];
+    } else {
+      // Path got worse: invalidate, then re-derive from the neighbours
+      field->cost[cell] = FLOW_COST_UNREACHABLE;
+    }
+    UpdateBlock(field, map, x, z);
+  }
+}
+
+void RepairFlowField(FlowField *field, const LevelMap *map,
+                     const int32_t *agentCells, int agentCount) {
+  uint64_t start = GetTimestampNs();
+  field->lastRepairTouched = 0;
+  field->lastRepairExpanded = 0;
+
+  if (!agentCells) {
+    SettleUpTo(field, map, FLOW_COST_UNREACHABLE);
+  } else {
+    // Settling everything up to an agent's key makes that agent's cell and
+    // its whole downhill path consistent. Agents still inconsistent after a
+    // pass had larger keys than the bound, so raise it and go again.
+    uint32_t bound = 0;
+    for (int a = 0; a < agentCount; a++) {
+      uint32_t key = CellKey(field, agentCells[a]);
+      if (key != FLOW_COST_UNREACHABLE && key > bound)
+        bound = key;
+    }
+    for (;;) {
+      SettleUpTo(field, map, bound);
+      uint32_t next = bound;
+      for (int a = 0; a < agentCount; a++) {
+        int32_t cell = agentCells[a];
+        if (field->cost[cell] != field->rhs[cell] &&
+            CellKey(field, cell) > next)
+          next = CellKey(field, cell);
+      }
+      if (next == bound)
+        break;
+      bound = next;
+    }
+  }
+
+  field->repairCount++;
+  field->lastRepairNs = GetTimestampNs() - start;
+}
+
+bool RetargetFlowField(FlowField *field, const LevelMap *map, int goalX,
+                       int goalZ, const int32_t *agentCells, int agentCount) {
+  if (goalX == field->goalX && goalZ == field->goalZ) {
+    // Agents may have walked past the settled horizon of the last repair
+    if (field->heapCount == 0)
+      return false;
+    RepairFlowField(field, map, agentCells, agentCount);
+    return true;
+  }
+
+  // The repair settles roughly the disc out to the farthest agent
+  uint32_t horizon = 0;
+  for (int a = 0; a < agentCount; a++) {
+    uint32_t key = CellKey(field, agentCells[a]);
+    if (key != FLOW_COST_UNREACHABLE && key > horizon)
+      horizon = key;
+  }
+  double radius = (double)horizon / FLOW_COST_STRAIGHT + 1.0;
+  double repairCells = 3.14159 * radius * radius;
+
+  if (field->goalX < 0 ||
+      repairCells * REPAIR_COST_RATIO > (double)field->reachableCells) {
+    BuildFlowField(field, map, goalX, goalZ);
+  } else {
+    MoveFlowFieldGoal(field, map, goalX, goalZ);
+    RepairFlowField(field, map, agentCells, agentCount);
+  }
+  return true;
+}
+
+// ==========================================
+// QUERIES
+// ==========================================
+
+bool GetFlowStep(const FlowField *field, int x, int z, int *nextX,
+                 int *nextZ) {
+  if (x < 0 || x >= field->width || z < 0 || z >= field->height)
+    return false;
+  uint8_t dir = field->dir[z * field->width + x];
+  if (dir == FLOW_DIR_NONE)
+    return false;
+  *nextX = x + dirOffsetX[dir];
+  *nextZ = z + dirOffsetZ[dir];
+  return true;
+}
+
+void GetFlowDirOffset(uint8_t dir, int *dx, int *dz) {
+  if (dir >= FLOW_DIR_COUNT) {
+    *dx = 0;
+    *dz = 0;
+    return;
+  }
+  *dx = dirOffsetX[dir];
+  *dz = dirOffsetZ[dir];
+}
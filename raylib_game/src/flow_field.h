@@ -0,0 +1,110 @@
+/**
+ * Kitchen Knight - Flow Field
+ * ===========================
+ * Shared pathfinding toward one goal cell (the player) over a LevelMap.
+ * One integration pass serves every enemy with an O(1) direction lookup.
+ */
+
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include "map_loader.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Step costs (8-connected, diagonal ~ sqrt(2))
+#define FLOW_COST_STRAIGHT 10
+#define FLOW_COST_DIAGONAL 14
+#define FLOW_COST_UNREACHABLE UINT32_MAX
+
+// Direction codes stored per cell; FLOW_DIR_NONE marks the goal, walls and
+// cells with no path
+#define FLOW_DIR_COUNT 8
+#define FLOW_DIR_NONE 0xFF
+
+// Bucket ring for Dial's algorithm; must exceed the largest step cost so a
+// bucket is never refilled while it is being drained
+#define FLOW_BUCKET_COUNT 16
+
+typedef struct {
+  int32_t *cells;
+  int count;
+  int capacity;
+} FlowBucket;
+
+typedef struct {
+  int width;
+  int height;
+  int goalX; // -1 until the first build
+  int goalZ;
+  uint32_t *cost; // Integrated cost to the goal
+  uint8_t *dir;   // Step toward the goal (index into the direction table)
+
+  // Scratch for the bucket queue
+  FlowBucket buckets[FLOW_BUCKET_COUNT];
+
+  // Incremental repair (LPA*): rhs is the one-step lookahead cost, and
+  // cells where it differs from cost sit in a binary heap keyed by
+  // min(cost, rhs)
+  uint32_t *rhs;
+  int32_t *heap;
+  uint32_t *heapKey;
+  int32_t *heapIndex; // Position in heap, -1 if not queued
+  int heapCount;
+
+  // Stats
+  int reachableCells; // As of the last full build
+  int buildCount;
+  uint64_t lastBuildNs;
+  int repairCount;
+  int lastRepairTouched;  // rhs recomputations
+  int lastRepairExpanded; // Cells popped from the heap
+  uint64_t lastRepairNs;
+} FlowField;
+
+// --- Lifecycle ---
+bool InitFlowField(FlowField *field, int width, int height);
+void UnloadFlowField(FlowField *field);
+
+// --- Building ---
+// Full Dijkstra integration from the goal cell. Diagonal steps are only
+// allowed when both adjacent orthogonal cells are open (no corner cutting).
+void BuildFlowField(FlowField *field, const LevelMap *map, int goalX,
+                    int goalZ);
+
+// Rebuild only if the goal moved to another cell. Returns true on rebuild.
+bool UpdateFlowFieldGoal(FlowField *field, const LevelMap *map, int goalX,
+                         int goalZ);
+
+// --- Incremental Repair ---
+// Move the goal without rebuilding. Only the old and new goal cells are
+// marked; the change propagates on the next RepairFlowField.
+void MoveFlowFieldGoal(FlowField *field, const LevelMap *map, int goalX,
+                       int goalZ);
+
+// Call after editing map->data at (x, z) (e.g. a wall opening or closing)
+void NotifyFlowFieldCellChanged(FlowField *field, const LevelMap *map, int x,
+                                int z);
+
+// Propagate pending changes. With agent cells (z * width + x), stops once
+// every agent's cell is settled, leaving cells farther out queued for a
+// later repair; pass NULL to settle the whole field.
+void RepairFlowField(FlowField *field, const LevelMap *map,
+                     const int32_t *agentCells, int agentCount);
+
+// Move the goal and settle the agents' cells, choosing between a bounded
+// repair and a full rebuild by the estimated area each would cover. Also
+// settles agents that wandered past an earlier repair's horizon. Returns
+// false if there was nothing to do.
+bool RetargetFlowField(FlowField *field, const LevelMap *map, int goalX,
+                       int goalZ, const int32_t *agentCells, int agentCount);
+
+// --- Queries ---
+// Next cell on the path from (x, z). False at the goal or with no path.
+bool GetFlowStep(const FlowField *field, int x, int z, int *nextX,
+                 int *nextZ);
+
+// Offsets for a direction code
+void GetFlowDirOffset(uint8_t dir, int *dx, int *dz);
+
+#endif // FLOW_FIELD_H
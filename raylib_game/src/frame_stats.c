@@ -0,0 +1,192 @@
+/**
+ * Kitchen Knight - Frame Timing Statistics Implementation
+ * =======================================================
+ * Times are kept in microseconds. Below 32 us each value has its own
+ * bucket; above, every power of two is split into 32 linear buckets, so a
+ * bucket is never more than ~3% wide. A ring of the raw samples lets the
+ * oldest frame leave its bucket when a new one arrives, which keeps the
+ * window exact and each record O(1).
+ */
+
+#include "frame_stats.h"
+#include "profiler.h"
+#include "timer.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SUB_BITS 5
+#define SUB_COUNT (1 << SUB_BITS)
+#define MAX_US_BITS 26 // ~67 s; longer frames land in the last bucket
+#define MAX_US ((1u << MAX_US_BITS) - 1)
+#define BUCKET_COUNT ((MAX_US_BITS - SUB_BITS + 1) << SUB_BITS)
+
+#define HITCH_MAX_ZONES 24      // Zone totals written per hitch
+#define HITCH_MAX_CAPTURES 1000 // Later hitches are only counted
+
+typedef struct {
+  uint32_t samples[FRAME_STATS_WINDOW]; // Microseconds, ring
+  uint16_t buckets[BUCKET_COUNT];
+} FrameHistogram;
+
+static FrameHistogram histograms[FRAME_TIME_COUNT];
+static int windowCount = 0; // Samples in every histogram
+static int windowNext = 0;  // Ring slot for the next sample
+
+static double budgetMs = 0.0;
+static char hitchPath[256];
+static FILE *hitchFile = NULL;
+static int hitchCount = 0;
+static uint32_t frameIndex = 0;
+static uint64_t startNs = 0;
+
+// ==========================================
+// HISTOGRAM
+// ==========================================
+
+static int BucketOf(uint32_t us) {
+  if (us < SUB_COUNT)
+    return (int)us;
+  int msb = SUB_BITS;
+  while (msb + 1 < MAX_US_BITS && (us >> (msb + 1)))
+    msb++;
+  int shift = msb - SUB_BITS;
+  return ((shift + 1) << SUB_BITS) + (int)((us >> shift) - SUB_COUNT);
+}
+
+// Middle of the range of values that land in the bucket
+static double BucketMidUs(int bucket) {
+  if (bucket < SUB_COUNT)
+    return bucket;
+  int shift = (bucket >> SUB_BITS) - 1;
+  uint32_t low = (uint32_t)((bucket & (SUB_COUNT - 1)) + SUB_COUNT) << shift;
+  return low + ((1u << shift) - 1) / 2.0;
+}
+
+static uint32_t ToUs(uint64_t ns) {
+  uint64_t us = ns / 1000;
+  return us > MAX_US ? MAX_US : (uint32_t)us;
+}
+
+static void AddSample(FrameHistogram *histogram, uint64_t ns) {
+  if (windowCount == FRAME_STATS_WINDOW)
+    histogram->buckets[BucketOf(histogram->samples[windowNext])]--;
+  uint32_t us = ToUs(ns);
+  histogram->samples[windowNext] = us;
+  histogram->buckets[BucketOf(us)]++;
+}
+
+FrameTimeSummary GetFrameTimeSummary(FrameTimeKind kind) {
+  FrameTimeSummary summary = {0};
+  if (kind < 0 || kind >= FRAME_TIME_COUNT || windowCount == 0)
+    return summary;
+  const FrameHistogram *histogram = &histograms[kind];
+
+  uint32_t maxUs = 0;
+  for (int i = 0; i < windowCount; i++) {
+    if (histogram->samples[i] > maxUs)
+      maxUs = histogram->samples[i];
+  }
+
+  // Walk the buckets once, filling each percentile as its rank is passed
+  const double ranks[3] = {0.50, 0.95, 0.99};
+  double *outputs[3] = {&summary.p50, &summary.p95, &summary.p99};
+  int next = 0;
+  int seen = 0;
+  for (int b = 0; b < BUCKET_COUNT && next < 3; b++) {
+    seen += histogram->buckets[b];
+    while (next < 3 && seen >= ranks[next] * windowCount) {
+      double us = BucketMidUs(b);
+      *outputs[next++] = (us < maxUs ? us : maxUs) / 1e3;
+    }
+  }
+  summary.max = maxUs / 1e3;
+  summary.frames = windowCount;
+  return summary;
+}
+
+// ==========================================
+// HITCH CAPTURE
+// ==========================================
+
+static void CaptureHitch(const FrameSample *sample, uint32_t frame) {
+  if (!hitchFile) {
+    hitchFile = fopen(hitchPath, "w");
+    if (!hitchFile) {
+      printf("[FrameStats] ERROR: Could not create %s, capture off\n",
+             hitchPath);
+      budgetMs = 0.0;
+      return;
+    }
+    fprintf(hitchFile, "Kitchen Knight hitch log: frames over %.2f ms\n\n",
+            budgetMs);
+    printf("[FrameStats] Capturing frames over %.2f ms to %s\n", budgetMs,
+           hitchPath);
+  }
+
+  fprintf(hitchFile, "Frame %u at %.2f s: %.2f ms\n", frame,
+          NsToSeconds(GetTimestampNs() - startNs), NsToMs(sample->frameNs));
+  fprintf(hitchFile, "  update %.2f ms, publish %.2f ms, draw %.2f ms\n",
+          NsToMs(sample->updateNs), NsToMs(sample->publishNs),
+          NsToMs(sample->drawNs));
+  fprintf(hitchFile, "  entities: %d enemies, %d projectiles, %d particles\n",
+          sample->enemies, sample->projectiles, sample->particles);
+
+  ProfileZoneTotal zones[HITCH_MAX_ZONES];
+  int zoneCount = GetProfileFrameTotals(zones, HITCH_MAX_ZONES);
+  if (zoneCount == 0)
+    fprintf(hitchFile, "  zones: none recorded (profiler off)\n");
+  for (int i = 0; i < zoneCount; i++) {
+    fprintf(hitchFile, "  %-24s %8.3f ms  x%d\n", zones[i].name,
+            NsToMs(zones[i].totalNs), zones[i].calls);
+  }
+  fprintf(hitchFile, "\n");
+  fflush(hitchFile); // Keep what was captured if the game crashes
+}
+
+// ==========================================
+// LIFECYCLE
+// ==========================================
+
+void InitFrameStats(double budget, const char *path) {
+  ShutdownFrameStats();
+  memset(histograms, 0, sizeof(histograms));
+  windowCount = 0;
+  windowNext = 0;
+  hitchCount = 0;
+  frameIndex = 0;
+  startNs = GetTimestampNs();
+  budgetMs = path ? budget : 0.0;
+  snprintf(hitchPath, sizeof(hitchPath), "%s", path ? path : "");
+}
+
+void ShutdownFrameStats(void) {
+  if (!hitchFile)
+    return;
+  fclose(hitchFile);
+  hitchFile = NULL;
+  printf("[FrameStats] Captured %d hitch(es) to %s\n",
+         hitchCount < HITCH_MAX_CAPTURES ? hitchCount : HITCH_MAX_CAPTURES,
+         hitchPath);
+}
+
+bool RecordFrameStats(const FrameSample *sample) {
+  AddSample(&histograms[FRAME_TIME_FRAME], sample->frameNs);
+  AddSample(&histograms[FRAME_TIME_UPDATE], sample->updateNs);
+  AddSample(&histograms[FRAME_TIME_DRAW], sample->drawNs);
+  windowNext = (windowNext + 1) % FRAME_STATS_WINDOW;
+  if (windowCount < FRAME_STATS_WINDOW)
+    windowCount++;
+  uint32_t frame = frameIndex++;
+
+  if (budgetMs <= 0.0 || NsToMs(sample->frameNs) <= budgetMs)
+    return false;
+  if (hitchCount++ < HITCH_MAX_CAPTURES)
+    CaptureHitch(sample, frame);
+  return true;
+}
+
+bool IsHitchCaptureEnabled(void) { return budgetMs > 0.0; }
+
+double GetFrameBudgetMs(void) { return budgetMs; }
+
+int GetHitchCount(void) { return hitchCount; }
@@ -0,0 +1,59 @@
+/**
+ * Kitchen Knight - Frame Timing Statistics
+ * ========================================
+ * Rolling log-linear (HDR-style) histograms of frame, update and draw times
+ * over the last FRAME_STATS_WINDOW frames, for live p50/p95/p99/max. Any
+ * frame over the budget is written to a hitch log with its profiler zone
+ * totals and entity counts, so stalls can be studied after the session.
+ *
+ *   RecordFrameStats(&sample);   // Once per frame, after BeginProfileFrame
+ *   FrameTimeSummary frame = GetFrameTimeSummary(FRAME_TIME_FRAME);
+ */
+
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FRAME_STATS_WINDOW 1200 // Frames kept (20 s at 60 FPS)
+
+typedef enum {
+  FRAME_TIME_FRAME,  // Loop top to loop top, frame-rate wait included
+  FRAME_TIME_UPDATE, // Simulation
+  FRAME_TIME_DRAW,   // Draw calls, without EndDrawing's wait
+  FRAME_TIME_COUNT
+} FrameTimeKind;
+
+typedef struct {
+  double p50, p95, p99, max; // Milliseconds
+  int frames;                // Samples in the window
+} FrameTimeSummary;
+
+// One finished frame
+typedef struct {
+  uint64_t frameNs;
+  uint64_t updateNs;
+  uint64_t publishNs; // Snapshot for drawing
+  uint64_t drawNs;
+  int enemies;
+  int projectiles;
+  int particles;
+} FrameSample;
+
+// budgetMs <= 0 turns hitch capture off. The log is only created once a
+// frame goes over budget. Capture reads the profiler's zones, so keep the
+// profiler enabled while IsHitchCaptureEnabled().
+void InitFrameStats(double budgetMs, const char *hitchPath);
+void ShutdownFrameStats(void);
+
+// Call right after BeginProfileFrame, so the collected zones belong to the
+// frame being recorded. Returns true if it went over budget.
+bool RecordFrameStats(const FrameSample *sample);
+
+FrameTimeSummary GetFrameTimeSummary(FrameTimeKind kind);
+bool IsHitchCaptureEnabled(void);
+double GetFrameBudgetMs(void);
+int GetHitchCount(void); // Since InitFrameStats
+
+#endif // FRAME_STATS_H
@@ -6,23 +6,60 @@
 
 #include "game.h"
 #include "arena.h"
+#include "asset_loader.h"
+#include "assets.h"
 #include "audio.h"
 #include "combat.h"
+#include "culling.h"
 #include "enemies/enemy_types.h"
 #include "enemy.h"
+#include "jobs.h"
+#include "particle_renderer.h"
 #include "particles.h"
 #include "player.h"
+#include "profiler.h"
+#include "raymath.h"
+#include "spatial_grid.h"
+#include "sprite_batch.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// A level file read on a loader thread, applied once it lands
+typedef struct {
+  GameState *game;
+  char filename[512];
+  unsigned char *text;
+  int size;
+} LevelLoad;
 
 // ==========================================
 // INITIALIZATION
 // ==========================================
 
-void InitGame(GameState *game) {
-  // Initialize audio system
-  InitAudioSystem();
+// Remember where everything is so the frame can be drawn between this and
+// the next step
+static void SaveInterpolationState(GameState *game) {
+  game->prevCamera = game->camera;
+  game->prevPlayerPos = game->playerPos;
+  game->prevEnemyPos = game->enemyPos;
+  SaveEnemyInterpolationState();
+  SaveCombatInterpolationState();
+  SaveParticleInterpolationState();
+}
 
-  // Initialize arena assets
-  InitArena();
+// Start stepping afresh, with nothing to blend from
+static void ResetFixedStep(GameState *game) {
+  game->simAccumulator = 0.0;
+  game->interpAlpha = 0.0f;
+  game->pendingPressed = 0;
+  game->pendingMouse = (Vector2){0.0f, 0.0f};
+  SaveInterpolationState(game);
+}
+
+void InitGame(GameState *game) {
+  // Worker pool for the enemy and particle updates (one per CPU)
+  InitJobSystem(0);
 
   // Initialize enemy pool system
   InitEnemySystem();
@@ -56,62 +93,204 @@ void InitGame(GameState *game) {
 
   // Initialize combat system
   InitCombat();
+
+  ResetFixedStep(game);
+}
+
+void InitGameAssets(void) {
+  // Files decode in the background from here on; each module draws its
+  // fallback until its assets land
+  InitAssetLoader(0);
+  InitAudioSystem();
+  LoadSpriteAtlas(gameSprites, gameSpriteCount);
+  InitArena();
+  InitSpriteBatch(MAX_ENEMIES);
+  InitParticleRenderer(MAX_PARTICLES);
+  LoadEnemyAssets();
+  LoadCombatAssets();
+}
+
+// Everything LoadGameLevel does once the file is in memory (text NULL if
+// it couldn't be read)
+static bool ApplyGameLevel(GameState *game, const char *filename,
+                           const unsigned char *text, int size) {
+  // Level spawns replace the default arena enemies
+  ResetEnemyPool();
+  UnloadLevel(&game->level);
+  if (!text || !ParseLevel(filename, text, size, &game->level)) {
+    SetEnemyLevel(NULL);
+    return false;
+  }
+
+  // Enemies navigate the level with a shared flow field
+  SetEnemyLevel(&game->level);
+
+  // Static walls draw from one baked mesh, culled by the level's PVS
+  // (headless runs have no window)
+  if (IsWindowReady()) {
+    BakeLevelMesh(&game->level);
+    LoadLevelVisibility(&game->level, filename);
+  }
+
+  // Move the player to the level start
+  game->playerPos = game->level.playerStart;
+  game->camera.position = game->playerPos;
+  game->camera.target = (Vector3){game->playerPos.x, game->playerPos.y,
+                                  game->playerPos.z + 1.0f};
+  game->playerYaw = 0.0f;
+  game->playerPitch = 0.0f;
+  ResetFixedStep(game);
+  return true;
+}
+
+bool LoadGameLevel(GameState *game, const char *filename) {
+  int size = 0;
+  unsigned char *text = ReadLevelFile(filename, &size);
+  bool ok = ApplyGameLevel(game, filename, text, size);
+  UnloadFileData(text);
+  return ok;
+}
+
+static bool DecodeLevel(void *request) {
+  LevelLoad *load = request;
+  load->text = ReadLevelFile(load->filename, &load->size);
+  return load->text != NULL;
+}
+
+static void FinishLevel(void *request, bool ok) {
+  LevelLoad *load = request;
+  ApplyGameLevel(load->game, load->filename, ok ? load->text : NULL,
+                 load->size);
+  load->game->levelLoading = false;
+  UnloadFileData(load->text);
+  free(load);
+}
+
+void QueueGameLevel(GameState *game, const char *filename) {
+  LevelLoad *load = calloc(1, sizeof(LevelLoad));
+  if (!load) {
+    LoadGameLevel(game, filename);
+    return;
+  }
+  load->game = game;
+  snprintf(load->filename, sizeof(load->filename), "%s", filename);
+  game->levelLoading = true;
+  QueueAssetLoad(DecodeLevel, FinishLevel, load);
 }
 
 // ==========================================
 // UPDATE
 // ==========================================
 
-void UpdateGame(GameState *game) {
+void UpdateGame(GameState *game, const InputFrame *input) {
+  // Frame-level input: act on it even while paused
+  if (IsInputPressed(input, INPUT_PAUSE)) {
+    game->isPaused = !game->isPaused;
+  }
+  if (IsInputPressed(input, INPUT_QUIT)) {
+    game->isRunning = false;
+  }
   if (game->isPaused)
     return;
+  PROFILE_BEGIN(zone, "UpdateGame");
+
+  // Presses and mouse motion carry over until a step consumes them, so a
+  // frame too short for a step loses nothing
+  game->pendingPressed |= input->pressed;
+  game->pendingMouse.x += input->mouseDelta.x;
+  game->pendingMouse.y += input->mouseDelta.y;
+
+  // Spiral-of-death clamp: never owe more than SIM_MAX_STEPS
+  game->simAccumulator += input->dt;
+  if (game->simAccumulator > SIM_MAX_STEPS * (double)SIM_DT)
+    game->simAccumulator = SIM_MAX_STEPS * (double)SIM_DT;
+
+  int steps = (int)(game->simAccumulator / SIM_DT);
+  for (int s = 0; s < steps; s++) {
+    InputFrame step = {.dt = SIM_DT, .held = input->held};
+    if (s == 0) {
+      step.mouseDelta = game->pendingMouse;
+      step.pressed = game->pendingPressed;
+      game->pendingMouse = (Vector2){0.0f, 0.0f};
+      game->pendingPressed = 0;
+    }
+
+    // Only the last step's starting point is needed for drawing
+    if (s == steps - 1)
+      SaveInterpolationState(game);
+    StepGame(game, &step);
+    game->simAccumulator -= SIM_DT;
+  }
+  game->interpAlpha = (float)(game->simAccumulator / SIM_DT);
+  PROFILE_END(zone);
+}
 
-  float dt = GetFrameTime();
+void StepGame(GameState *game, const InputFrame *input) {
+  PROFILE_BEGIN(zone, "StepGame");
+  float dt = SIM_DT;
   game->gameTime += dt;
 
   // Update player movement and camera
-  UpdatePlayer(game);
+  UpdatePlayer(game, input);
 
   // Update legacy enemy AI (only if alive)
   if (game->enemyActive) {
-    UpdateEnemy(game);
+    UpdateEnemy(game, dt);
   }
 
   // Update all enemies from pool
   UpdateEnemies(game, dt);
 
+  // Re-bin enemies for this step's hit and proximity queries
+  RebuildEnemyGrid();
+
   // Update combat system
-  UpdateCombat(game, dt);
+  UpdateCombat(game, input, dt);
 
   // Update particles
   UpdateParticles(dt);
 
-  // Update music if playing
-  UpdateMusic();
-
   // Damage flash decay
   if (game->damageFlashTimer > 0) {
     game->damageFlashTimer -= dt;
   }
-
-  // Check for pause toggle
-  if (IsKeyPressed(KEY_P)) {
-    game->isPaused = !game->isPaused;
-  }
-
-  // Quit on ESC
-  if (IsKeyPressed(KEY_ESCAPE)) {
-    game->isRunning = false;
-  }
+  PROFILE_END(zone);
 }
 
 // ==========================================
 // DRAW
 // ==========================================
 
+void PublishGameDrawState(GameState *view, const GameState *live) {
+  PROFILE_BEGIN(zone, "PublishGameDrawState");
+  *view = *live; // The level grid is shared; it doesn't change in play
+
+  float alpha = live->interpAlpha;
+  view->camera.position = Vector3Lerp(live->prevCamera.position,
+                                      live->camera.position, alpha);
+  view->camera.target =
+      Vector3Lerp(live->prevCamera.target, live->camera.target, alpha);
+  view->playerPos = Vector3Lerp(live->prevPlayerPos, live->playerPos, alpha);
+  view->enemyPos = Vector3Lerp(live->prevEnemyPos, live->enemyPos, alpha);
+
+  PublishEnemyDrawState(alpha);
+  PublishCombatDrawState(alpha);
+  PublishParticleDrawState(alpha);
+  PROFILE_END(zone);
+}
+
 void DrawGame(const GameState *game) {
-  // Draw arena (floor and walls)
-  DrawArena();
+  PROFILE_BEGIN(zone, "DrawGame");
+  // Every draw path below tests its bounds against this frustum
+  BeginCullFrame(game->camera,
+                 (float)GetScreenWidth() / (float)GetScreenHeight());
+
+  // Draw the loaded level, or the arena (floor and walls)
+  if (game->level.data) {
+    DrawLevel(&game->level);
+  } else {
+    DrawArena();
+  }
 
   // Draw legacy enemy (billboard from combat system)
   if (game->enemyActive) {
@@ -122,14 +301,16 @@ void DrawGame(const GameState *game) {
   DrawEnemies(game);
 
   // Draw particles
-  DrawParticles();
+  DrawParticles(game->camera);
 
   // Draw a reference grid on the floor (helpful for debugging)
   DrawGrid(10, GRID_SCALE);
+  PROFILE_END(zone);
 }
 
 // Draw UI elements (called from main.c after EndMode3D)
 void DrawGameUI(const GameState *game) {
+  PROFILE_BEGIN(zone, "DrawGameUI");
   // Combat HUD (crosshair, health bars)
   DrawCombatUI(game);
 
@@ -146,15 +327,30 @@ void DrawGameUI(const GameState *game) {
     DrawText("PAUSED", GetScreenWidth() / 2 - 60, GetScreenHeight() / 2 - 20,
              40, WHITE);
   }
+  PROFILE_END(zone);
 }
 
 // ==========================================
 // CLEANUP
 // ==========================================
 
-void CleanupGame(GameState *game) {
-  UnloadCombat();
+void UnloadGameAssets(void) {
+  ShutdownAssetLoader(); // Lets whatever is still loading land first
+  UnloadCombatAssets();
+  UnloadEnemyAssets();
+  UnloadParticleRenderer();
+  UnloadSpriteBatch();
   UnloadArena();
+  UnloadSpriteAtlas();
+  if (GetTextureReferenceCount() > 0)
+    printf("[Assets] WARNING: %d texture references never released\n",
+           GetTextureReferenceCount());
   UnloadAudioSystem();
-  (void)game;
+}
+
+void CleanupGame(GameState *game) {
+  FinishAssetLoads(); // A level still loading lands before it's freed
+  SetEnemyLevel(NULL);
+  UnloadLevel(&game->level);
+  ShutdownJobSystem();
 }
@@ -7,6 +7,8 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "input.h"
+#include "map_loader.h"
 #include "raylib.h"
 #include <stdbool.h>
 
@@ -18,6 +20,13 @@
 #define SCREEN_HEIGHT 720
 #define TARGET_FPS 60
 
+// Fixed-step simulation: the game always advances in SIM_DT steps, however
+// fast the display runs. A slow frame runs at most SIM_MAX_STEPS and drops
+// the rest of its time rather than falling further behind.
+#define SIM_HZ 120
+#define SIM_DT (1.0f / SIM_HZ)
+#define SIM_MAX_STEPS 8
+
 // Arena dimensions
 #define ARENA_SIZE 50.0f
 #define WALL_HEIGHT 5.0f
@@ -29,6 +38,7 @@
 #define PLAYER_HEIGHT 1.8f
 #define GRAVITY 0.5f
 #define PLAYER_MAX_HP 100
+#define PLAYER_RADIUS 0.5f // Footprint for level wall collisions
 
 // Enemy settings
 #define ENEMY_WIDTH 3.0f
@@ -63,20 +73,50 @@ typedef struct {
   int playerMaxHP;
   float damageFlashTimer;
 
+  // Level (data == NULL when playing in the open arena)
+  LevelMap level;
+  bool levelLoading; // QueueGameLevel's level isn't in yet; don't simulate
+
   // Game state
   bool isRunning;
   bool isPaused;
   float gameTime;
 
+  // Fixed-step bookkeeping (see UpdateGame)
+  double simAccumulator;   // Time not yet simulated (double so 1/144 s
+                           // frames don't drift a step over a minute)
+  float interpAlpha;       // Render blend from the previous step, 0..1
+  Camera3D prevCamera;     // Player, camera and legacy enemy before the
+  Vector3 prevPlayerPos;   // last step
+  Vector3 prevEnemyPos;
+  uint32_t pendingPressed; // Presses and mouse motion waiting for a step
+  Vector2 pendingMouse;
+
 } GameState;
 
 // ===========================================
 // FUNCTION DECLARATIONS
 // ===========================================
 
-// Game lifecycle
+// Game lifecycle. InitGame, LoadGameLevel, UpdateGame and CleanupGame make
+// no window, texture or audio calls, so the simulation runs headless; the
+// windowed game brackets them with InitGameAssets/UnloadGameAssets.
 void InitGame(GameState *game);
-void UpdateGame(GameState *game);
+void InitGameAssets(void); // After InitWindow: audio, textures, models
+void UnloadGameAssets(void);
+bool LoadGameLevel(GameState *game, const char *filename);
+// LoadGameLevel with the file read on a loader thread: levelLoading stays
+// set until PumpAssetLoads applies it (asset_loader.h)
+void QueueGameLevel(GameState *game, const char *filename);
+// Advance by the frame's input->dt in fixed SIM_DT steps
+void UpdateGame(GameState *game, const InputFrame *input);
+// One fixed step (input->dt is ignored)
+void StepGame(GameState *game, const InputFrame *input);
+// Copy everything the Draw functions read (game state, enemy, projectile
+// and particle pools) into their render snapshots, blended interpAlpha of
+// the way from the previous step to the current one. Call while no update
+// is running; drawing can then overlap the next update.
+void PublishGameDrawState(GameState *view, const GameState *live);
 void DrawGame(const GameState *game);
 void DrawGameUI(const GameState *game);
 void CleanupGame(GameState *game);
@@ -0,0 +1,50 @@
+/**
+ * Kitchen Knight - Input Frames Implementation
+ * ============================================
+ * Key and mouse bindings for each button.
+ */
+
+#include "input.h"
+
+typedef struct {
+  InputButton button;
+  int key;   // KEY_NULL if bound to the mouse
+  int mouse; // Mouse button, used when key is KEY_NULL
+} InputBinding;
+
+static const InputBinding bindings[] = {
+    {INPUT_MOVE_FORWARD, KEY_W, 0},
+    {INPUT_MOVE_BACK, KEY_S, 0},
+    {INPUT_MOVE_LEFT, KEY_A, 0},
+    {INPUT_MOVE_RIGHT, KEY_D, 0},
+    {INPUT_ATTACK, KEY_NULL, MOUSE_BUTTON_LEFT},
+    {INPUT_WEAPON_1, KEY_ONE, 0},
+    {INPUT_WEAPON_2, KEY_TWO, 0},
+    {INPUT_WEAPON_3, KEY_THREE, 0},
+    {INPUT_WEAPON_4, KEY_FOUR, 0},
+    {INPUT_PAUSE, KEY_P, 0},
+    {INPUT_QUIT, KEY_ESCAPE, 0},
+};
+
+#define BINDING_COUNT ((int)(sizeof(bindings) / sizeof(bindings[0])))
+
+InputFrame PollInputFrame(void) {
+  InputFrame input = {.dt = GetFrameTime(), .mouseDelta = GetMouseDelta()};
+
+  for (int i = 0; i < BINDING_COUNT; i++) {
+    const InputBinding *b = &bindings[i];
+    bool held, pressed;
+    if (b->key != KEY_NULL) {
+      held = IsKeyDown(b->key);
+      pressed = IsKeyPressed(b->key);
+    } else {
+      held = IsMouseButtonDown(b->mouse);
+      pressed = IsMouseButtonPressed(b->mouse);
+    }
+    if (held)
+      input.held |= (uint32_t)b->button;
+    if (pressed)
+      input.pressed |= (uint32_t)b->button;
+  }
+  return input;
+}
@@ -0,0 +1,50 @@
+/**
+ * Kitchen Knight - Input Frames
+ * =============================
+ * One frame of player input, captured on the main thread. The simulation
+ * reads these instead of raylib's input state, so it can run on another
+ * thread (raylib polls input inside EndDrawing).
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Buttons (bit flags) ---
+typedef enum {
+  INPUT_MOVE_FORWARD = 1 << 0,
+  INPUT_MOVE_BACK = 1 << 1,
+  INPUT_MOVE_LEFT = 1 << 2,
+  INPUT_MOVE_RIGHT = 1 << 3,
+  INPUT_ATTACK = 1 << 4,
+  INPUT_WEAPON_1 = 1 << 5,
+  INPUT_WEAPON_2 = 1 << 6,
+  INPUT_WEAPON_3 = 1 << 7,
+  INPUT_WEAPON_4 = 1 << 8,
+  INPUT_PAUSE = 1 << 9,
+  INPUT_QUIT = 1 << 10,
+} InputButton;
+
+typedef struct {
+  float dt;           // Frame time this input covers (seconds)
+  Vector2 mouseDelta; // Pixels since the previous frame
+  uint32_t held;      // Buttons down at capture
+  uint32_t pressed;   // Buttons that went down since the previous capture
+} InputFrame;
+
+// Capture the current frame's input from raylib (main thread only)
+InputFrame PollInputFrame(void);
+
+static inline bool IsInputHeld(const InputFrame *input, InputButton button) {
+  return (input->held & (uint32_t)button) != 0;
+}
+
+static inline bool IsInputPressed(const InputFrame *input,
+                                  InputButton button) {
+  return (input->pressed & (uint32_t)button) != 0;
+}
+
+#endif // INPUT_H
@@ -0,0 +1,279 @@
+/**
+ * Kitchen Knight - Job System Implementation
+ * ==========================================
+ * Chase-Lev deques (the C11 formulation by Le, Pop, Cohen and Zappa
+ * Nardelli) holding packed index ranges. The owner pushes and pops at the
+ * bottom, thieves take from the top. One ParallelFor batch runs at a time;
+ * idle workers sleep on a condition variable between batches.
+ */
+
+#include "jobs.h"
+#include "profiler.h"
+#include "sys_thread.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Halving means a deque never holds more than one entry per split level,
+// i.e. at most 32 for a 31-bit range
+#define DEQUE_CAPACITY 64
+#define DEQUE_MASK (DEQUE_CAPACITY - 1)
+#define CACHE_LINE 64
+
+// A job is a range packed as begin << 32 | end; 0 (empty range) means none
+typedef uint64_t Job;
+#define JOB_NONE 0ull
+
+typedef struct {
+  _Alignas(CACHE_LINE) atomic_llong top;
+  _Alignas(CACHE_LINE) atomic_llong bottom;
+  atomic_ullong slots[DEQUE_CAPACITY];
+} JobDeque;
+
+// --- Pool ---
+static int workerCount = 1;
+static SysThread *threads[JOB_MAX_WORKERS];
+static JobDeque deques[JOB_MAX_WORKERS];
+static SysMutex *wakeMutex = NULL;
+static SysCond *wakeCond = NULL;
+static uint64_t batchId = 0; // Guarded by wakeMutex
+static bool quitting = false; // Guarded by wakeMutex
+
+// --- Current Batch ---
+// Written before the root job is pushed; the push/steal pair orders them
+static JobRangeFn batchFn;
+static void *batchCtx;
+static int batchGrain;
+static atomic_int batchRemaining; // Indices not finished yet
+
+// ==========================================
+// DEQUE
+// ==========================================
+
+static inline Job PackJob(int begin, int end) {
+  return ((uint64_t)(uint32_t)begin << 32) | (uint32_t)end;
+}
+
+// Owner only
+static void PushJob(JobDeque *d, Job job) {
+  long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+  atomic_store_explicit(&d->slots[b & DEQUE_MASK], job, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+}
+
+// Owner only
+static Job PopJob(JobDeque *d) {
+  long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  long long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+  Job job = JOB_NONE;
+  if (t <= b) {
+    job = atomic_load_explicit(&d->slots[b & DEQUE_MASK],
+                               memory_order_relaxed);
+    if (t == b) {
+      // Last entry: race the thieves for it
+      if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                   memory_order_seq_cst,
+                                                   memory_order_relaxed))
+        job = JOB_NONE;
+      atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+  } else {
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+  }
+  return job;
+}
+
+// Any thread; JOB_NONE if empty or another thief won
+static Job StealJob(JobDeque *d) {
+  long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  long long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+  if (t >= b)
+    return JOB_NONE;
+
+  Job job =
+      atomic_load_explicit(&d->slots[t & DEQUE_MASK], memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit(
+          &d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+    return JOB_NONE;
+  return job;
+}
+
+// ==========================================
+// EXECUTION
+// ==========================================
+
+// Split off right halves until the piece is one chunk, then run it
+static void RunJob(int self, Job job) {
+  int begin = (int)(job >> 32);
+  int end = (int)(uint32_t)job;
+  int grain = batchGrain;
+
+  while (end - begin > grain) {
+    int half = (end - begin) / (2 * grain) * grain;
+    if (half == 0)
+      half = grain;
+    PushJob(&deques[self], PackJob(begin + half, end));
+    end = begin + half;
+  }
+
+  PROFILE_BEGIN(zone, "Job");
+  batchFn(batchCtx, begin, end, self);
+  PROFILE_END(zone);
+  atomic_fetch_sub_explicit(&batchRemaining, end - begin,
+                            memory_order_release);
+}
+
+static Job FindJob(int self, uint32_t *rng) {
+  Job job = PopJob(&deques[self]);
+  if (job != JOB_NONE)
+    return job;
+
+  // Visit every other deque once, starting at a random victim
+  *rng ^= *rng << 13;
+  *rng ^= *rng >> 17;
+  *rng ^= *rng << 5;
+  int start = (int)(*rng % (uint32_t)workerCount);
+  for (int k = 0; k < workerCount; k++) {
+    int victim = (start + k) % workerCount;
+    if (victim == self)
+      continue;
+    job = StealJob(&deques[victim]);
+    if (job != JOB_NONE)
+      return job;
+  }
+  return JOB_NONE;
+}
+
+static void HelpUntilDone(int self) {
+  uint32_t rng = 0x9E3779B9u * (uint32_t)(self + 1);
+  while (atomic_load_explicit(&batchRemaining, memory_order_acquire) > 0) {
+    Job job = FindJob(self, &rng);
+    if (job != JOB_NONE)
+      RunJob(self, job);
+    else
+      YieldSysThread();
+  }
+}
+
+static void WorkerMain(void *arg) {
+  int self = (int)(intptr_t)arg;
+  uint64_t seen = 0;
+
+  char name[16];
+  snprintf(name, sizeof(name), "Worker %d", self);
+  SetProfileThreadName(name);
+
+  for (;;) {
+    LockSysMutex(wakeMutex);
+    while (!quitting && batchId == seen)
+      WaitSysCond(wakeCond, wakeMutex);
+    bool quit = quitting;
+    seen = batchId;
+    UnlockSysMutex(wakeMutex);
+
+    if (quit)
+      return;
+    HelpUntilDone(self);
+  }
+}
+
+// ==========================================
+// LIFECYCLE
+// ==========================================
+
+bool InitJobSystem(int count) {
+  ShutdownJobSystem();
+
+  int cpus = GetCpuCount();
+  if (count <= 0)
+    count = cpus;
+  if (count > JOB_MAX_WORKERS)
+    count = JOB_MAX_WORKERS;
+
+  for (int w = 0; w < JOB_MAX_WORKERS; w++) {
+    atomic_init(&deques[w].top, 0);
+    atomic_init(&deques[w].bottom, 0);
+  }
+  atomic_init(&batchRemaining, 0);
+  batchId = 0;
+  quitting = false;
+
+  if (count > 1) {
+    wakeMutex = CreateSysMutex();
+    wakeCond = CreateSysCond();
+    if (!wakeMutex || !wakeCond) {
+      printf("[Jobs] ERROR: Could not create the wake-up signal\n");
+      ShutdownJobSystem();
+      return false;
+    }
+  }
+
+  // Worker 0 is the calling thread
+  workerCount = 1;
+  for (int w = 1; w < count; w++) {
+    threads[w] = CreateSysThread(WorkerMain, (void *)(intptr_t)w);
+    if (!threads[w]) {
+      printf("[Jobs] WARNING: Started only %d of %d workers\n", w, count);
+      break;
+    }
+    workerCount = w + 1;
+  }
+
+  printf("[Jobs] %d worker(s) on %d CPU(s)\n", workerCount, cpus);
+  return workerCount == count;
+}
+
+void ShutdownJobSystem(void) {
+  if (wakeMutex) {
+    LockSysMutex(wakeMutex);
+    quitting = true;
+    BroadcastSysCond(wakeCond);
+    UnlockSysMutex(wakeMutex);
+  }
+
+  for (int w = 1; w < workerCount; w++) {
+    JoinSysThread(threads[w]);
+    threads[w] = NULL;
+  }
+  workerCount = 1;
+
+  DestroySysCond(wakeCond);
+  DestroySysMutex(wakeMutex);
+  wakeCond = NULL;
+  wakeMutex = NULL;
+}
+
+int GetJobWorkerCount(void) { return workerCount; }
+
+// ==========================================
+// PARALLEL FOR
+// ==========================================
+
+void ParallelFor(int begin, int end, int grain, JobRangeFn fn, void *ctx) {
+  if (end <= begin)
+    return;
+  if (grain < 1)
+    grain = 1;
+  if (workerCount <= 1 || end - begin <= grain) {
+    fn(ctx, begin, end, 0);
+    return;
+  }
+
+  batchFn = fn;
+  batchCtx = ctx;
+  batchGrain = grain;
+  atomic_store_explicit(&batchRemaining, end - begin, memory_order_relaxed);
+  PushJob(&deques[0], PackJob(begin, end));
+
+  LockSysMutex(wakeMutex);
+  batchId++;
+  BroadcastSysCond(wakeCond);
+  UnlockSysMutex(wakeMutex);
+
+  HelpUntilDone(0);
+}
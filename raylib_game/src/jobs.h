@@ -0,0 +1,37 @@
+/**
+ * Kitchen Knight - Job System
+ * ===========================
+ * Fixed worker pool with per-worker work-stealing deques. ParallelFor splits
+ * an index range in halves on demand: whoever runs a piece keeps the left
+ * half and leaves the right half on its own deque, where idle workers steal
+ * it. Big pieces get stolen first, so load balances without a central queue.
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+
+#define JOB_MAX_WORKERS 64
+
+// Runs one chunk [begin, end). worker is 0 for the calling thread and
+// 1..GetJobWorkerCount()-1 for pool threads, for indexing per-worker scratch.
+typedef void (*JobRangeFn)(void *ctx, int begin, int end, int worker);
+
+// --- Lifecycle ---
+// Total worker count including the calling thread; 0 means one per CPU.
+// Re-initializing shuts the old pool down first.
+bool InitJobSystem(int workerCount);
+void ShutdownJobSystem(void);
+int GetJobWorkerCount(void); // 1 when not initialized
+
+// --- Parallel For ---
+// Run fn over [begin, end) in chunks of at least grain indices and wait for
+// all of them; the caller works too. Chunks start at begin plus a multiple
+// of grain, so a grain that is a multiple of 8 keeps SIMD blocks whole.
+// Only one thread at a time may call it (that thread acts as worker 0; in
+// pipelined mode it is the simulation thread), and never from inside a job.
+// Without workers (or for a single chunk) this is just fn(ctx, begin, end, 0).
+void ParallelFor(int begin, int end, int grain, JobRangeFn fn, void *ctx);
+
+#endif // JOBS_H
@@ -0,0 +1,341 @@
+/**
+ * Kitchen Knight - Level Mesh Implementation
+ * ==========================================
+ * Wall tops are merged into rectangles: each unmerged wall cell grows as
+ * far as it can along x, then along z while the whole row below is free.
+ * Walls are all one height, so side faces only merge along their row or
+ * column. A side is kept only where the neighbouring cell is open. Merging
+ * stops at chunk borders.
+ *
+ * Edges are baked as one thin triangle per line and drawn in wire mode,
+ * which keeps them in an ordinary triangle mesh (rlgl has no line-mesh
+ * draw). Where wire mode is missing (GL ES) they fill to near nothing.
+ */
+
+#include "level_mesh.h"
+#include "culling.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define EDGE_LIFT 0.01f    // Edges sit this far off their face (depth test)
+#define EDGE_SLIVER 0.001f // Third corner of an edge's triangle
+
+typedef struct {
+  float *data;  // xyz per vertex
+  int count;    // Vertices
+  int capacity; // Vertices
+  bool failed;
+} VertexList;
+
+typedef struct {
+  VertexList faces;
+  VertexList edges;
+  bool withEdges;
+  int faceCount;
+} MeshBuilder;
+
+// ==========================================
+// BUILDING
+// ==========================================
+
+static void PushVertex(VertexList *list, Vector3 v) {
+  if (list->failed)
+    return;
+  if (list->count == list->capacity) {
+    int capacity = list->capacity ? list->capacity * 2 : 1024;
+    float *data =
+        RL_REALLOC(list->data, sizeof(float) * 3 * (size_t)capacity);
+    if (!data) {
+      list->failed = true;
+      return;
+    }
+    list->data = data;
+    list->capacity = capacity;
+  }
+  float *out = &list->data[list->count++ * 3];
+  out[0] = v.x;
+  out[1] = v.y;
+  out[2] = v.z;
+}
+
+// Quad from origin spanning u and v. u x v must point out of the face so
+// it winds counter-clockwise seen from outside (back faces are culled).
+static void AddFace(MeshBuilder *b, Vector3 origin, Vector3 u, Vector3 v) {
+  Vector3 corners[4] = {origin, Vector3Add(origin, u),
+                        Vector3Add(Vector3Add(origin, u), v),
+                        Vector3Add(origin, v)};
+  static const int triangles[6] = {0, 1, 2, 0, 2, 3};
+  for (int i = 0; i < 6; i++)
+    PushVertex(&b->faces, corners[triangles[i]]);
+  b->faceCount++;
+  if (!b->withEdges)
+    return;
+
+  Vector3 normal = Vector3Normalize(Vector3CrossProduct(u, v));
+  Vector3 lift = Vector3Scale(normal, EDGE_LIFT);
+  Vector3 sliver = Vector3Scale(normal, EDGE_SLIVER);
+  for (int i = 0; i < 4; i++) {
+    Vector3 from = Vector3Add(corners[i], lift);
+    Vector3 to = Vector3Add(corners[(i + 1) & 3], lift);
+    PushVertex(&b->edges, from);
+    PushVertex(&b->edges, to);
+    PushVertex(&b->edges, Vector3Add(to, sliver));
+  }
+}
+
+static inline bool IsWall(const LevelMap *map, int x, int z) {
+  return GetCell(map, x, z) == CELL_WALL; // Outside the map counts
+}
+
+// Cells x0..x1-1, z0..z1-1 of the map (one chunk)
+typedef struct {
+  int x0, z0, x1, z1;
+} CellRect;
+
+// Top of every wall cell in the chunk, merged into as few rectangles as
+// the greedy pass finds
+static void AddTopFaces(MeshBuilder *b, const LevelMap *map,
+                        unsigned char *merged, CellRect r, float wallHeight,
+                        Vector3 origin) {
+  int width = map->width;
+  float s = MAP_CELL_SIZE;
+  for (int z = r.z0; z < r.z1; z++) {
+    for (int x = r.x0; x < r.x1; x++) {
+      if (merged[z * width + x] || !IsWall(map, x, z))
+        continue;
+      int x1 = x + 1;
+      while (x1 < r.x1 && !merged[z * width + x1] && IsWall(map, x1, z))
+        x1++;
+      int z1 = z + 1;
+      for (; z1 < r.z1; z1++) {
+        int i = x;
+        while (i < x1 && !merged[z1 * width + i] && IsWall(map, i, z1))
+          i++;
+        if (i < x1)
+          break;
+      }
+      for (int mz = z; mz < z1; mz++)
+        for (int mx = x; mx < x1; mx++)
+          merged[mz * width + mx] = 1;
+
+      Vector3 corner = {origin.x + x * s, wallHeight, origin.z + z * s};
+      AddFace(b, corner, (Vector3){0.0f, 0.0f, (z1 - z) * s},
+              (Vector3){(x1 - x) * s, 0.0f, 0.0f});
+    }
+  }
+}
+
+// Wall sides in the chunk facing (dx, dz), one quad per run of exposed
+// cells. Runs go along z for faces looking down x, and along x otherwise.
+static void AddSideFaces(MeshBuilder *b, const LevelMap *map, int dx, int dz,
+                         CellRect r, float wallHeight, Vector3 origin) {
+  float s = MAP_CELL_SIZE;
+  int lineBegin = dx ? r.x0 : r.z0, lineEnd = dx ? r.x1 : r.z1;
+  int runBegin = dx ? r.z0 : r.x0, runEnd = dx ? r.z1 : r.x1;
+  Vector3 up = {0.0f, wallHeight, 0.0f};
+
+  for (int line = lineBegin; line < lineEnd; line++) {
+    int start = -1;
+    for (int i = runBegin; i <= runEnd; i++) {
+      int x = dx ? line : i;
+      int z = dx ? i : line;
+      bool exposed =
+          i < runEnd && IsWall(map, x, z) && !IsWall(map, x + dx, z + dz);
+      if (exposed && start < 0)
+        start = i;
+      if (exposed || start < 0)
+        continue;
+
+      float from = start * s;
+      float span = (i - start) * s;
+      Vector3 corner, along;
+      if (dx) {
+        corner = (Vector3){origin.x + (line + (dx > 0)) * s, 0.0f,
+                           origin.z + from};
+        along = (Vector3){0.0f, 0.0f, span};
+      } else {
+        corner = (Vector3){origin.x + from, 0.0f,
+                           origin.z + (line + (dz > 0)) * s};
+        along = (Vector3){span, 0.0f, 0.0f};
+      }
+      if (dx > 0 || dz < 0)
+        AddFace(b, corner, up, along);
+      else
+        AddFace(b, corner, along, up);
+      start = -1;
+    }
+  }
+}
+
+// ==========================================
+// UPLOAD
+// ==========================================
+
+// Hand the vertices to a GPU mesh. The CPU copy is dropped once uploaded;
+// only the vertex count is needed to draw.
+static void UploadVertices(Mesh *mesh, VertexList *list) {
+  *mesh = (Mesh){0};
+  mesh->vertexCount = list->count;
+  mesh->triangleCount = list->count / 3;
+  mesh->vertices = list->data;
+  // UploadMesh always streams texcoords; zeros sample the white texel
+  mesh->texcoords = RL_CALLOC((size_t)list->count * 2, sizeof(float));
+  UploadMesh(mesh, false);
+  RL_FREE(mesh->vertices);
+  RL_FREE(mesh->texcoords);
+  mesh->vertices = NULL;
+  mesh->texcoords = NULL;
+  *list = (VertexList){0};
+}
+
+// Upload what the builder holds as the next chunk and empty it for the
+// one after. Returns false if the builder ran out of memory.
+static bool FinishChunk(LevelMesh *mesh, MeshBuilder *b, BoundingBox bounds) {
+  bool ok = !b->faces.failed && !b->edges.failed;
+  if (ok && b->faces.count > 0) {
+    LevelMeshChunk *chunk = &mesh->chunks[mesh->chunkCount++];
+    UploadVertices(&chunk->faces, &b->faces);
+    if (b->edges.count > 0)
+      UploadVertices(&chunk->edges, &b->edges);
+    // Edges stand a little proud of the faces
+    chunk->bounds = (BoundingBox){Vector3SubtractValue(bounds.min, EDGE_LIFT),
+                                  Vector3AddValue(bounds.max, EDGE_LIFT)};
+    mesh->faceCount += b->faceCount;
+  }
+  RL_FREE(b->faces.data);
+  RL_FREE(b->edges.data);
+  *b = (MeshBuilder){.withEdges = b->withEdges};
+  return ok;
+}
+
+static bool BeginMesh(LevelMesh *mesh, int maxChunks) {
+  *mesh = (LevelMesh){0};
+  mesh->chunks = calloc((size_t)maxChunks, sizeof(LevelMeshChunk));
+  return mesh->chunks != NULL;
+}
+
+static bool EndMesh(LevelMesh *mesh, bool ok, const char *what) {
+  if (!ok)
+    printf("[LevelMesh] ERROR: Out of memory baking %s\n", what);
+  if (!ok || mesh->chunkCount == 0) {
+    UnloadLevelMesh(mesh);
+    return false;
+  }
+  mesh->material = LoadMaterialDefault();
+  printf("[LevelMesh] Baked %s: %d faces in %d chunks\n", what,
+         mesh->faceCount, mesh->chunkCount);
+  return true;
+}
+
+bool BuildLevelMesh(LevelMesh *mesh, const LevelMap *map, float wallHeight,
+                    bool withEdges) {
+  int chunksX = (map->width + LEVEL_MESH_CHUNK - 1) / LEVEL_MESH_CHUNK;
+  int chunksZ = (map->height + LEVEL_MESH_CHUNK - 1) / LEVEL_MESH_CHUNK;
+  bool ok = BeginMesh(mesh, chunksX * chunksZ);
+  unsigned char *merged = calloc((size_t)map->width * map->height, 1);
+  ok = ok && merged;
+
+  // Same centering as GridToWorld
+  Vector3 origin = {-map->width * MAP_CELL_SIZE / 2.0f, 0.0f,
+                    -map->height * MAP_CELL_SIZE / 2.0f};
+  MeshBuilder b = {.withEdges = withEdges};
+  for (int cz = 0; ok && cz < chunksZ; cz++) {
+    for (int cx = 0; ok && cx < chunksX; cx++) {
+      CellRect r = {cx * LEVEL_MESH_CHUNK, cz * LEVEL_MESH_CHUNK,
+                    (cx + 1) * LEVEL_MESH_CHUNK, (cz + 1) * LEVEL_MESH_CHUNK};
+      if (r.x1 > map->width)
+        r.x1 = map->width;
+      if (r.z1 > map->height)
+        r.z1 = map->height;
+
+      AddTopFaces(&b, map, merged, r, wallHeight, origin);
+      AddSideFaces(&b, map, 1, 0, r, wallHeight, origin);
+      AddSideFaces(&b, map, -1, 0, r, wallHeight, origin);
+      AddSideFaces(&b, map, 0, 1, r, wallHeight, origin);
+      AddSideFaces(&b, map, 0, -1, r, wallHeight, origin);
+
+      BoundingBox bounds = {
+          {origin.x + r.x0 * MAP_CELL_SIZE, 0.0f,
+           origin.z + r.z0 * MAP_CELL_SIZE},
+          {origin.x + r.x1 * MAP_CELL_SIZE, wallHeight,
+           origin.z + r.z1 * MAP_CELL_SIZE}};
+      ok = FinishChunk(mesh, &b, bounds);
+    }
+  }
+  free(merged);
+  return EndMesh(mesh, ok, "level");
+}
+
+bool BuildBoxMesh(LevelMesh *mesh, const BoundingBox *boxes, int count,
+                  bool withEdges) {
+  if (count <= 0 || !BeginMesh(mesh, 1))
+    return false;
+  MeshBuilder b = {.withEdges = withEdges};
+  BoundingBox bounds = boxes[0];
+  for (int i = 0; i < count; i++) {
+    Vector3 lo = boxes[i].min;
+    Vector3 hi = boxes[i].max;
+    Vector3 sx = {hi.x - lo.x, 0.0f, 0.0f};
+    Vector3 sy = {0.0f, hi.y - lo.y, 0.0f};
+    Vector3 sz = {0.0f, 0.0f, hi.z - lo.z};
+
+    AddFace(&b, (Vector3){lo.x, hi.y, lo.z}, sz, sx); // Top
+    AddFace(&b, (Vector3){hi.x, lo.y, lo.z}, sy, sz); // +X
+    AddFace(&b, lo, sz, sy);                          // -X
+    AddFace(&b, (Vector3){lo.x, lo.y, hi.z}, sx, sy); // +Z
+    AddFace(&b, lo, sy, sx);                          // -Z
+    bounds.min = Vector3Min(bounds.min, lo);
+    bounds.max = Vector3Max(bounds.max, hi);
+  }
+  return EndMesh(mesh, FinishChunk(mesh, &b, bounds), "boxes");
+}
+
+// ==========================================
+// DRAWING
+// ==========================================
+
+void DrawLevelMesh(const LevelMesh *mesh, Color faceColor, Color edgeColor) {
+  if (mesh->chunkCount == 0)
+    return;
+  bool anyEdges = false;
+  mesh->material.maps[MATERIAL_MAP_DIFFUSE].color = faceColor;
+  for (int i = 0; i < mesh->chunkCount; i++) {
+    LevelMeshChunk *chunk = &mesh->chunks[i];
+    chunk->visible = IsBoxVisible(CULL_LEVEL, chunk->bounds);
+    if (!chunk->visible)
+      continue;
+    DrawMesh(chunk->faces, mesh->material, MatrixIdentity());
+    anyEdges |= chunk->edges.vertexCount > 0;
+  }
+  if (!anyEdges)
+    return;
+
+  rlDrawRenderBatchActive(); // Queued immediate-mode draws stay filled
+  rlEnableWireMode();
+  rlDisableBackfaceCulling();
+  mesh->material.maps[MATERIAL_MAP_DIFFUSE].color = edgeColor;
+  for (int i = 0; i < mesh->chunkCount; i++) {
+    const LevelMeshChunk *chunk = &mesh->chunks[i];
+    if (chunk->visible && chunk->edges.vertexCount > 0)
+      DrawMesh(chunk->edges, mesh->material, MatrixIdentity());
+  }
+  rlEnableBackfaceCulling();
+  rlDisableWireMode();
+}
+
+// ==========================================
+// CLEANUP
+// ==========================================
+
+void UnloadLevelMesh(LevelMesh *mesh) {
+  for (int i = 0; i < mesh->chunkCount; i++) {
+    UnloadMesh(mesh->chunks[i].faces);
+    UnloadMesh(mesh->chunks[i].edges);
+  }
+  free(mesh->chunks);
+  if (mesh->material.maps)
+    UnloadMaterial(mesh->material);
+  *mesh = (LevelMesh){0};
+}
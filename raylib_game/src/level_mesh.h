@@ -0,0 +1,56 @@
+/**
+ * Kitchen Knight - Level Mesh
+ * ===========================
+ * Static wall geometry baked into GPU meshes once at load time, so a level
+ * draws in a bounded number of calls however many wall cells it has.
+ * Adjacent wall cells are merged (greedy meshing) and faces buried between
+ * walls, or against the map border, are dropped. The map is baked in
+ * square chunks so each can be culled on its own. Edge lines are optional
+ * and baked into a second mesh per chunk.
+ *
+ *   LevelMesh mesh = {0};
+ *   BuildLevelMesh(&mesh, &map, WALL_HEIGHT, true);   // Needs a window
+ *   DrawLevelMesh(&mesh, BROWN, DARKBROWN);           // Inside BeginMode3D
+ *   UnloadLevelMesh(&mesh);
+ */
+
+#ifndef LEVEL_MESH_H
+#define LEVEL_MESH_H
+
+#include "map_loader.h"
+#include "raylib.h"
+#include <stdbool.h>
+
+#define LEVEL_MESH_CHUNK 32 // Map cells per chunk side
+
+typedef struct {
+  Mesh faces;         // Exposed wall faces, merged
+  Mesh edges;         // Outline of every merged face (empty without edges)
+  BoundingBox bounds; // For culling
+  bool visible;       // Set while drawing
+} LevelMeshChunk;
+
+typedef struct {
+  LevelMeshChunk *chunks; // Only chunks with walls in them
+  int chunkCount;
+  Material material; // Default shader, recolored per draw
+  int faceCount;     // Merged quads
+} LevelMesh;
+
+// Bake every wall cell of the map, withEdges adding the outline mesh.
+// Returns false if there were no walls or no memory (mesh stays empty).
+bool BuildLevelMesh(LevelMesh *mesh, const LevelMap *map, float wallHeight,
+                    bool withEdges);
+
+// Bake free-standing boxes into one chunk (tops and sides, no bottoms).
+// Faces between overlapping boxes are kept.
+bool BuildBoxMesh(LevelMesh *mesh, const BoundingBox *boxes, int count,
+                  bool withEdges);
+
+// Two draw calls per chunk in view: faces, then edges if baked. Chunks are
+// culled under CULL_LEVEL.
+void DrawLevelMesh(const LevelMesh *mesh, Color faceColor, Color edgeColor);
+
+void UnloadLevelMesh(LevelMesh *mesh);
+
+#endif // LEVEL_MESH_H
@@ -0,0 +1,403 @@
+/**
+ * Kitchen Knight - Logger Implementation
+ * ======================================
+ * The ring is a bounded multi-producer queue with a sequence number per
+ * slot: a producer claims a slot with one compare-and-swap on the write
+ * position, fills it and publishes it by bumping the slot's sequence. The
+ * writer thread is the only consumer. Producers never wait; when the ring
+ * is full the message is counted as dropped.
+ *
+ * Both sides walk the format with the same parser, so the producer knows
+ * which type to pull off the va_list and the writer knows which cast to
+ * hand snprintf for each conversion.
+ */
+
+#include "logger.h"
+#include "sys_thread.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_IDLE_MS 2     // Writer sleep when the ring is empty
+#define LOG_LINE_MAX 1024 // Formatted message, truncated beyond
+#define LOG_SPEC_MAX 32   // One conversion, e.g. "%-12.3f"
+#define LOG_TEXT_NONE 0xFF
+
+typedef enum {
+  ARG_INT,
+  ARG_LONG,
+  ARG_LLONG,
+  ARG_UINT,
+  ARG_ULONG,
+  ARG_ULLONG,
+  ARG_SIZE,
+  ARG_DOUBLE,
+  ARG_STRING,
+  ARG_POINTER,
+  ARG_PERCENT, // "%%", takes no argument
+  ARG_UNSUPPORTED
+} ArgKind;
+
+typedef union {
+  long long i;
+  unsigned long long u; // Also the text offset of a %s argument
+  double f;
+  const void *p;
+} LogArg;
+
+// 128 bytes with the default sizes
+typedef struct {
+  atomic_uint sequence;
+  uint8_t level;
+  uint8_t argCount;
+  uint8_t textUsed;
+  const char *format;
+  LogArg args[LOG_MAX_ARGS];
+  char text[LOG_TEXT_SIZE];
+} LogRecord;
+
+atomic_int logLevel = LOG_LEVEL_DEBUG;
+
+static LogRecord ring[LOG_RING_SIZE];
+static atomic_uint writePos = 0;
+static unsigned readPos = 0; // Writer thread (or shutdown) only
+static atomic_uint dropped = 0;
+
+static atomic_bool queueing = false; // Producers use the ring
+static atomic_bool writerRunning = false;
+static SysThread *writer = NULL;
+
+// ==========================================
+// FORMAT PARSING
+// ==========================================
+
+// Parse the conversion at spec (which starts with '%'). Returns its length.
+static int ParseSpec(const char *spec, ArgKind *kind) {
+  int n = 1;
+  while (spec[n] && strchr("-+ #0", spec[n]))
+    n++;
+  while (spec[n] >= '0' && spec[n] <= '9')
+    n++;
+  if (spec[n] == '.') {
+    n++;
+    while (spec[n] >= '0' && spec[n] <= '9')
+      n++;
+  }
+
+  // Length: 0 = none, 1 = l, 2 = ll, 3 = z; h and hh promote to int
+  int length = 0;
+  if (spec[n] == 'h') {
+    n += spec[n + 1] == 'h' ? 2 : 1;
+  } else if (spec[n] == 'l') {
+    length = spec[n + 1] == 'l' ? 2 : 1;
+    n += length;
+  } else if (spec[n] == 'z') {
+    length = 3;
+    n++;
+  }
+
+  static const ArgKind signedKinds[4] = {ARG_INT, ARG_LONG, ARG_LLONG,
+                                         ARG_SIZE};
+  static const ArgKind unsignedKinds[4] = {ARG_UINT, ARG_ULONG, ARG_ULLONG,
+                                           ARG_SIZE};
+  char conversion = spec[n];
+  if (conversion)
+    n++;
+  switch (conversion) {
+  case 'd':
+  case 'i':
+    *kind = signedKinds[length];
+    break;
+  case 'u':
+  case 'o':
+  case 'x':
+  case 'X':
+    *kind = unsignedKinds[length];
+    break;
+  case 'c':
+    *kind = ARG_INT;
+    break;
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  case 'a':
+  case 'A':
+    *kind = ARG_DOUBLE;
+    break;
+  case 's':
+    *kind = ARG_STRING;
+    break;
+  case 'p':
+    *kind = ARG_POINTER;
+    break;
+  case '%':
+    *kind = ARG_PERCENT;
+    break;
+  default: // '*' widths, %n, long double, ...
+    *kind = ARG_UNSUPPORTED;
+    break;
+  }
+  return n;
+}
+
+// ==========================================
+// PRODUCERS (any thread)
+// ==========================================
+
+static void CopyText(LogRecord *record, LogArg *arg, const char *text) {
+  int room = LOG_TEXT_SIZE - record->textUsed;
+  if (room <= 0) {
+    arg->u = LOG_TEXT_NONE;
+    return;
+  }
+  if (!text)
+    text = "(null)";
+  size_t length = strlen(text);
+  if (length > (size_t)room - 1)
+    length = (size_t)room - 1;
+  memcpy(record->text + record->textUsed, text, length);
+  record->text[record->textUsed + length] = '\0';
+  arg->u = record->textUsed;
+  record->textUsed = (uint8_t)(record->textUsed + length + 1);
+}
+
+// Pull the arguments off the va_list; stops at the first conversion it
+// can't store, and the writer prints the format from there on as-is
+static void CaptureArgs(LogRecord *record, va_list args) {
+  record->argCount = 0;
+  record->textUsed = 0;
+  for (const char *c = record->format; *c; c++) {
+    if (*c != '%')
+      continue;
+    ArgKind kind;
+    int length = ParseSpec(c, &kind);
+    c += length - 1;
+    if (kind == ARG_PERCENT)
+      continue;
+    if (kind == ARG_UNSUPPORTED || record->argCount == LOG_MAX_ARGS)
+      return;
+
+    LogArg *arg = &record->args[record->argCount++];
+    switch (kind) {
+    case ARG_INT:
+      arg->i = va_arg(args, int);
+      break;
+    case ARG_LONG:
+      arg->i = va_arg(args, long);
+      break;
+    case ARG_LLONG:
+      arg->i = va_arg(args, long long);
+      break;
+    case ARG_UINT:
+      arg->u = va_arg(args, unsigned);
+      break;
+    case ARG_ULONG:
+      arg->u = va_arg(args, unsigned long);
+      break;
+    case ARG_ULLONG:
+      arg->u = va_arg(args, unsigned long long);
+      break;
+    case ARG_SIZE:
+      arg->u = va_arg(args, size_t);
+      break;
+    case ARG_DOUBLE:
+      arg->f = va_arg(args, double);
+      break;
+    case ARG_STRING:
+      CopyText(record, arg, va_arg(args, const char *));
+      break;
+    case ARG_POINTER:
+      arg->p = va_arg(args, void *);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void LogWrite(int level, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  if (!atomic_load_explicit(&queueing, memory_order_acquire)) {
+    vprintf(format, args);
+    va_end(args);
+    return;
+  }
+
+  // Claim a slot: its sequence equals the position while it is free
+  unsigned pos = atomic_load_explicit(&writePos, memory_order_relaxed);
+  LogRecord *record;
+  for (;;) {
+    record = &ring[pos & LOG_RING_MASK];
+    unsigned sequence =
+        atomic_load_explicit(&record->sequence, memory_order_acquire);
+    int diff = (int)(sequence - pos);
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&writePos, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+      va_end(args);
+      return;
+    } else {
+      pos = atomic_load_explicit(&writePos, memory_order_relaxed);
+    }
+  }
+
+  record->level = (uint8_t)level;
+  record->format = format;
+  CaptureArgs(record, args);
+  va_end(args);
+  atomic_store_explicit(&record->sequence, pos + 1, memory_order_release);
+}
+
+void SetLogLevel(int level) {
+  atomic_store_explicit(&logLevel, level, memory_order_relaxed);
+}
+
+// ==========================================
+// WRITER
+// ==========================================
+
+static int FormatArg(char *out, size_t size, const char *spec, ArgKind kind,
+                     const LogRecord *record, LogArg arg) {
+  switch (kind) {
+  case ARG_INT:
+    return snprintf(out, size, spec, (int)arg.i);
+  case ARG_LONG:
+    return snprintf(out, size, spec, (long)arg.i);
+  case ARG_LLONG:
+    return snprintf(out, size, spec, arg.i);
+  case ARG_UINT:
+    return snprintf(out, size, spec, (unsigned)arg.u);
+  case ARG_ULONG:
+    return snprintf(out, size, spec, (unsigned long)arg.u);
+  case ARG_ULLONG:
+    return snprintf(out, size, spec, arg.u);
+  case ARG_SIZE:
+    return snprintf(out, size, spec, (size_t)arg.u);
+  case ARG_DOUBLE:
+    return snprintf(out, size, spec, arg.f);
+  case ARG_STRING:
+    return snprintf(out, size, spec,
+                    arg.u == LOG_TEXT_NONE ? "..." : record->text + arg.u);
+  case ARG_POINTER:
+    return snprintf(out, size, spec, arg.p);
+  default:
+    return 0;
+  }
+}
+
+static void WriteRecord(const LogRecord *record) {
+  char line[LOG_LINE_MAX];
+  size_t length = 0;
+  int argIndex = 0;
+  const char *c = record->format;
+  while (*c && length < sizeof(line) - 1) {
+    if (*c != '%') {
+      line[length++] = *c++;
+      continue;
+    }
+
+    ArgKind kind;
+    int specLength = ParseSpec(c, &kind);
+    if (kind == ARG_PERCENT) {
+      line[length++] = '%';
+    } else if (kind == ARG_UNSUPPORTED || argIndex == record->argCount ||
+               specLength >= LOG_SPEC_MAX) {
+      break; // Nothing captured from here on
+    } else {
+      char spec[LOG_SPEC_MAX];
+      memcpy(spec, c, (size_t)specLength);
+      spec[specLength] = '\0';
+      int written = FormatArg(line + length, sizeof(line) - length, spec,
+                              kind, record, record->args[argIndex++]);
+      if (written > 0)
+        length += (size_t)written;
+      if (length > sizeof(line) - 1)
+        length = sizeof(line) - 1;
+    }
+    c += specLength;
+  }
+
+  // Whatever couldn't be formatted goes out verbatim
+  size_t rest = strlen(c);
+  if (rest > sizeof(line) - 1 - length)
+    rest = sizeof(line) - 1 - length;
+  memcpy(line + length, c, rest);
+  length += rest;
+  fwrite(line, 1, length, stdout);
+}
+
+// Write every published record. Returns how many there were.
+static int DrainRecords(void) {
+  int count = 0;
+  for (;;) {
+    LogRecord *record = &ring[readPos & LOG_RING_MASK];
+    unsigned sequence =
+        atomic_load_explicit(&record->sequence, memory_order_acquire);
+    if (sequence != readPos + 1)
+      break;
+    WriteRecord(record);
+    atomic_store_explicit(&record->sequence, readPos + LOG_RING_SIZE,
+                          memory_order_release);
+    readPos++;
+    count++;
+  }
+
+  unsigned lost = atomic_exchange_explicit(&dropped, 0, memory_order_relaxed);
+  if (lost)
+    printf("[Log] WARNING: Ring full, dropped %u message(s)\n", lost);
+  if (count || lost)
+    fflush(stdout);
+  return count;
+}
+
+static void WriterMain(void *arg) {
+  (void)arg;
+  while (atomic_load_explicit(&writerRunning, memory_order_acquire)) {
+    if (!DrainRecords())
+      SleepSysThread(LOG_IDLE_MS);
+  }
+}
+
+// ==========================================
+// LIFECYCLE
+// ==========================================
+
+bool InitLogger(void) {
+  if (writer)
+    return true;
+
+  for (unsigned i = 0; i < LOG_RING_SIZE; i++)
+    atomic_store_explicit(&ring[i].sequence, i, memory_order_relaxed);
+  atomic_store_explicit(&writePos, 0, memory_order_relaxed);
+  readPos = 0;
+
+  atomic_store_explicit(&writerRunning, true, memory_order_release);
+  writer = CreateSysThread(WriterMain, NULL);
+  if (!writer) {
+    atomic_store_explicit(&writerRunning, false, memory_order_release);
+    printf("[Log] WARNING: No writer thread, logging synchronously\n");
+    return false;
+  }
+  atomic_store_explicit(&queueing, true, memory_order_release);
+  return true;
+}
+
+void ShutdownLogger(void) {
+  if (!writer)
+    return;
+  atomic_store_explicit(&queueing, false, memory_order_release);
+  atomic_store_explicit(&writerRunning, false, memory_order_release);
+  JoinSysThread(writer);
+  writer = NULL;
+  DrainRecords(); // Anything published after the writer's last pass
+}
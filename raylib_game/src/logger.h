@@ -0,0 +1,92 @@
+/**
+ * Kitchen Knight - Logger
+ * =======================
+ * Leveled printf-style logging that doesn't block gameplay. A call copies
+ * its format pointer and arguments into a fixed-size record in a lock-free
+ * ring; a background thread formats the records and writes them to stdout.
+ *
+ *   LOG_DEBUG("[EnemySystem] Enemy %d took %d damage\n", index, damage);
+ *
+ * Formats must be string literals (only the pointer is kept). %s arguments
+ * are copied, up to LOG_TEXT_SIZE bytes per record. Calls below
+ * KK_LOG_LEVEL compile out entirely (their arguments aren't evaluated);
+ * SetLogLevel filters the rest at run time. Before InitLogger, after
+ * ShutdownLogger or if the thread can't start, messages print directly.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE 4
+
+// Lowest level compiled in (set by CMake's KK_LOG_LEVEL)
+#ifndef KK_LOG_LEVEL
+#define KK_LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#define LOG_RING_SIZE 4096 // Records (power of two)
+#define LOG_MAX_ARGS 8     // Conversions per message
+#define LOG_TEXT_SIZE 48   // Bytes for copies of %s arguments
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define LOG_PRINTF_FORMAT
+#endif
+
+extern atomic_int logLevel;
+
+// Slow path behind the level check in the macros below
+void LogWrite(int level, const char *format, ...) LOG_PRINTF_FORMAT;
+
+#define LOG_AT(level, ...)                                                   \
+  ((level) >= atomic_load_explicit(&logLevel, memory_order_relaxed)         \
+       ? LogWrite((level), __VA_ARGS__)                                      \
+       : (void)0)
+
+// Compiled out: sizeof keeps the arguments type-checked but unevaluated
+#define LOG_NOTHING(...) ((void)sizeof(printf(__VA_ARGS__)))
+
+#if KK_LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_NOTHING(__VA_ARGS__)
+#endif
+
+#if KK_LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_NOTHING(__VA_ARGS__)
+#endif
+
+#if KK_LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_NOTHING(__VA_ARGS__)
+#endif
+
+#if KK_LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_NOTHING(__VA_ARGS__)
+#endif
+
+// Start the writer thread. Returns false (logging stays synchronous) if it
+// can't be created.
+bool InitLogger(void);
+// Write what's queued and stop the thread. Call once the threads that log
+// have finished.
+void ShutdownLogger(void);
+
+// Messages below level are skipped at run time (default LOG_LEVEL_DEBUG)
+void SetLogLevel(int level);
+
+#endif // LOGGER_H
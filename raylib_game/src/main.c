@@ -3,62 +3,280 @@
  * ==================================
  * A Doom-style 3D game built with Raylib.
  * Cross-platform: Mac and Windows.
+ *
+ * Usage: kitchen_knight [level] [--record file] [--replay file]
+ *                       [--timings file.csv] [--budget ms] [--loose]
+ *
+ * Frames over the budget (default two frames at TARGET_FPS, 0 = off) are
+ * logged to kk_hitches.txt with their zone timings and entity counts.
+ *
+ * Assets come from assets.kkpak (see kk_pack) when it exists, unless
+ * --loose asks for the files under assets/. They load in the background:
+ * the first frame draws straight away, with placeholders for whatever
+ * hasn't landed, and the simulation starts once the level is in. The time
+ * from launch to the first frame and to the last asset is printed, to
+ * compare the two.
  */
 
+#include "archive.h"
 #include "arena.h"
+#include "asset_loader.h"
+#include "audio.h"
+#include "combat.h"
+#include "culling.h"
+#include "enemies/enemy_lod.h"
+#include "enemies/enemy_types.h"
 #include "enemy.h"
+#include "frame_stats.h"
 #include "game.h"
+#include "input.h"
+#include "logger.h"
+#include "particles.h"
+#include "pipeline.h"
 #include "player.h"
+#include "profiler.h"
 #include "raylib.h"
+#include "replay.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HITCH_LOG_FILE "kk_hitches.txt"
+
+static const char *timeLabels[FRAME_TIME_COUNT] = {"Frame", "Update", "Draw"};
+
+int main(int argc, char **argv) {
+  uint64_t launchNs = GetTimestampNs(); // Cold start runs to the first frame
 
-int main(void) {
   // ==========================================
   // INITIALIZATION
   // ==========================================
 
+  // Optional ASCII level (e.g. assets/levels/level1.txt), else the arena
+  const char *levelPath = NULL;
+  const char *recordPath = NULL;
+  const char *replayPath = NULL;
+  const char *timingsPath = NULL;
+  double budgetMs = 2000.0 / TARGET_FPS;
+  bool looseAssets = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+      recordPath = argv[++i];
+    else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+      replayPath = argv[++i];
+    else if (strcmp(argv[i], "--timings") == 0 && i + 1 < argc)
+      timingsPath = argv[++i];
+    else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+      budgetMs = atof(argv[++i]);
+    else if (strcmp(argv[i], "--loose") == 0)
+      looseAssets = true;
+    else
+      levelPath = argv[i];
+  }
+
+  // Gameplay messages are written by a background thread
+  InitLogger();
+
   InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Kitchen Knight 3D");
   SetTargetFPS(TARGET_FPS);
 
   // Lock and hide cursor for FPS-style controls
   DisableCursor();
 
-  // Initialize game state
+  // A replay brings its own level and RNG seed; a recording stores them
+  ReplayHeader replay;
+  if (replayPath && StartReplay(replayPath, &replay)) {
+    if (replay.level[0])
+      levelPath = replay.level;
+    SetRandomSeed(replay.seed);
+    SetTargetFPS(0); // Recorded frame times drive the sim; draw flat out
+  } else if (recordPath) {
+    uint32_t seed = (uint32_t)time(NULL);
+    SetRandomSeed(seed);
+    StartRecording(recordPath, seed, levelPath);
+  }
+  if (timingsPath) {
+    StartTimingLog(timingsPath);
+  }
+
+  // Hitch capture needs the zones, so the profiler records while it is on;
+  // F3 only shows the overlay then
+  InitFrameStats(budgetMs, HITCH_LOG_FILE);
+  bool showProfiler = false;
+  if (IsHitchCaptureEnabled()) {
+    SetProfilerEnabled(true);
+  }
+
+  // Initialize game state. The simulation owns game; drawing reads view,
+  // a snapshot published once per frame.
   GameState game = {0};
+  GameState view = {0};
+  if (!looseAssets)
+    OpenAssetArchive(ASSET_ARCHIVE_FILE);
+  InitGameAssets();
   InitGame(&game);
+  if (levelPath) {
+    QueueGameLevel(&game, levelPath);
+  }
+  bool firstFrame = true;
+  bool assetsLoading = true;
+  view = game;
+  uint64_t renderNs = 0;
+  uint64_t frameTop = 0;
+  FrameSample sample = {0};
+  int traceCount = 0;
+  SetProfileThreadName("Main");
 
   // ==========================================
   // MAIN GAME LOOP
   // ==========================================
 
-  while (!WindowShouldClose() && game.isRunning) {
+  // A replay runs to its last frame even past a recorded quit, since a
+  // pipelined recording simulates one frame beyond it
+  while (!WindowShouldClose() && (view.isRunning || IsReplaying())) {
+    BeginProfileFrame();
+    uint64_t now = GetTimestampNs();
+    if (frameTop) {
+      sample.frameNs = now - frameTop;
+      RecordFrameStats(&sample);
+    }
+    frameTop = now;
+
+    // F2 toggles the pipelined simulation for comparison, F3 the profiler
+    // overlay (and recording, when hitch capture isn't keeping it on); F4
+    // saves the recent zones as a Chrome trace; F5 toggles culling
+    if (IsKeyPressed(KEY_F2)) {
+      SetSimPipelined(!IsSimPipelined());
+    }
+    if (IsKeyPressed(KEY_F3)) {
+      showProfiler = !showProfiler;
+      bool record = showProfiler || IsHitchCaptureEnabled();
+      if (record != IsProfilerEnabled())
+        SetProfilerEnabled(record);
+    }
+    if (IsKeyPressed(KEY_F4)) {
+      WriteProfileTrace(TextFormat("kk_trace_%d.json", traceCount++));
+    }
+    if (IsKeyPressed(KEY_F5)) {
+      SetCullingEnabled(!IsCullingEnabled());
+    }
+
     // --- UPDATE ---
-    UpdateGame(&game);
+    // Nothing simulates (or records, or replays) until the level is in, so
+    // a recording starts from the same state as its replay
+    bool simulate = !game.levelLoading;
+    InputFrame input = {0};
+    if (simulate) {
+      if (IsReplaying()) {
+        if (!NextReplayFrame(&input))
+          break;
+      } else {
+        input = PollInputFrame();
+        RecordInputFrame(&input);
+      }
+      RunSimFrame(&game, &input);
+    }
+
+    // The simulation is idle: land finished loads, snapshot it, then hand
+    // it the next frame
+    PumpAssetLoads(ASSET_UPLOAD_BUDGET_MS);
+    if (assetsLoading && GetPendingAssetLoads() == 0) {
+      printf("[Startup] Assets loaded %.1f ms after launch, from %s\n",
+             NsToMs(GetTimestampNs() - launchNs),
+             IsAssetArchiveOpen() ? ASSET_ARCHIVE_FILE : "loose files");
+      assetsLoading = false;
+    }
+    uint64_t publishStart = GetTimestampNs();
+    PublishGameDrawState(&view, &game);
+    EnemyLODStats lod = *GetEnemyLODStats();
+    uint64_t simNs = GetLastSimNs();
+    sample.publishNs = GetTimestampNs() - publishStart;
+    FlushSFX();
+    UpdateMusic();
+    if (simulate)
+      KickSimFrame(&game, &input);
 
     // --- DRAW ---
+    uint64_t renderStart = GetTimestampNs();
     BeginDrawing();
 
     ClearBackground((Color){40, 40, 40, 255}); // Dark gray
 
-    BeginMode3D(game.camera);
-    DrawGame(&game);
-    EndMode3D();
+    if (view.levelLoading) {
+      DrawText("Loading...", SCREEN_WIDTH / 2 - 60, SCREEN_HEIGHT / 2 - 20, 30,
+               LIGHTGRAY);
+    } else {
+      BeginMode3D(view.camera);
+      DrawGame(&view);
+      EndMode3D();
 
-    // Combat HUD (crosshair, health bars, etc.)
-    DrawGameUI(&game);
+      // Combat HUD (crosshair, health bars, etc.)
+      DrawGameUI(&view);
+    }
 
     // Debug info
     DrawFPS(10, SCREEN_HEIGHT - 60);
+    DrawText(TextFormat("AI %.2f ms | LOD %d/%d/%d/%d | ticked %d",
+                        lod.avgFrameNs / 1e6, lod.bandCount[0],
+                        lod.bandCount[1], lod.bandCount[2], lod.bandCount[3],
+                        lod.ticked),
+             10, SCREEN_HEIGHT - 80, 16, LIGHTGRAY);
+    DrawText(TextFormat("Sim %.2f ms | Render %.2f ms | %s (F2)",
+                        NsToMs(simNs), NsToMs(renderNs),
+                        IsSimPipelined() ? "Pipelined" : "Serial"),
+             10, SCREEN_HEIGHT - 100, 16, LIGHTGRAY);
+    for (int k = 0; k < FRAME_TIME_COUNT; k++) {
+      FrameTimeSummary t = GetFrameTimeSummary((FrameTimeKind)k);
+      DrawText(TextFormat("%-6s p50 %.2f | p95 %.2f | p99 %.2f | max %.2f ms",
+                          timeLabels[k], t.p50, t.p95, t.p99, t.max),
+               10, SCREEN_HEIGHT - 160 + k * 20, 16, LIGHTGRAY);
+    }
+    if (IsHitchCaptureEnabled()) {
+      DrawText(TextFormat("Hitches over %.1f ms: %d", GetFrameBudgetMs(),
+                          GetHitchCount()),
+               10, SCREEN_HEIGHT - 180, 16, LIGHTGRAY);
+    }
     DrawText("WASD - Move | Mouse - Look | LMB - Attack | ESC - Quit", 10,
              SCREEN_HEIGHT - 30, 16, LIGHTGRAY);
 
+    // Draw time excludes EndDrawing's frame-rate wait
+    renderNs = GetTimestampNs() - renderStart;
+    LogFrameTiming(simNs, renderNs);
+    if (showProfiler) {
+      int height = DrawProfilerOverlay(SCREEN_WIDTH - 610, 10, 600);
+      DrawCullStats(SCREEN_WIDTH - 610, 10 + height, 600);
+    }
     EndDrawing();
+    if (firstFrame) {
+      printf("[Startup] First frame %.1f ms after launch\n",
+             NsToMs(GetTimestampNs() - launchNs));
+      firstFrame = false;
+    }
+
+    // Recorded at the top of the next frame, once its length is known
+    sample.updateNs = simNs;
+    sample.drawNs = renderNs;
+    sample.enemies = GetEnemyDrawCount();
+    sample.projectiles = GetProjectileDrawCount();
+    sample.particles = GetParticleDrawCount();
   }
 
   // ==========================================
   // CLEANUP
   // ==========================================
 
+  // Every recorded frame has simulated once the pipeline drains
+  ShutdownSimPipeline();
+  StopRecording(&game);
+  FinishReplay(&game);
+  StopTimingLog();
+  ShutdownFrameStats();
   CleanupGame(&game);
+  UnloadGameAssets();
+  CloseAssetArchive();
+  ShutdownLogger();
   CloseWindow();
 
   return 0;
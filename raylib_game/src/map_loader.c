@@ -5,20 +5,36 @@
  */
 
 #include "map_loader.h"
+#include "archive.h"
+#include "culling.h"
 #include "enemies/enemy_types.h"
 #include "game.h"
+#include "level_mesh.h"
+#include "logger.h"
+#include "profiler.h"
+#include "pvs.h"
+#include "raymath.h"
+#include "timer.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Walls of the loaded level, baked once it has a window to draw in
+static LevelMesh levelMesh = {0};
+static const char *bakedLevel = NULL; // Data of the map levelMesh shows
+
+// Cell-to-cell visibility of the loaded level, handed to the culler
+static LevelPVS levelPVS = {0};
+static const char *pvsLevel = NULL; // Data of the map levelPVS describes
+
 // ==========================================
 // COORDINATE CONVERSION
 // ==========================================
 
 Vector3 GridToWorld(int gridX, int gridZ, int mapWidth, int mapHeight) {
   // Center the map around origin
-  float cellSize = 4.0f;
+  float cellSize = MAP_CELL_SIZE;
   float halfWidth = (mapWidth * cellSize) / 2.0f;
   float halfHeight = (mapHeight * cellSize) / 2.0f;
 
@@ -26,6 +42,18 @@ Vector3 GridToWorld(int gridX, int gridZ, int mapWidth, int mapHeight) {
                    (gridZ * cellSize) - halfHeight + (cellSize / 2.0f)};
 }
 
+bool WorldToCell(const LevelMap *map, Vector3 pos, int *gridX, int *gridZ) {
+  // Inverse of GridToWorld (floor, so cells left of the origin stay negative)
+  float halfWidth = (map->width * MAP_CELL_SIZE) / 2.0f;
+  float halfHeight = (map->height * MAP_CELL_SIZE) / 2.0f;
+  int x = (int)floorf((pos.x + halfWidth) / MAP_CELL_SIZE);
+  int z = (int)floorf((pos.z + halfHeight) / MAP_CELL_SIZE);
+
+  *gridX = x;
+  *gridZ = z;
+  return x >= 0 && x < map->width && z >= 0 && z < map->height;
+}
+
 char GetCell(const LevelMap *map, int x, int z) {
   if (x < 0 || x >= map->width || z < 0 || z >= map->height) {
     return CELL_WALL; // Out of bounds = wall
@@ -33,23 +61,52 @@ char GetCell(const LevelMap *map, int x, int z) {
   return map->data[z * map->width + x];
 }
 
+bool IsWallAt(const LevelMap *map, float x, float z) {
+  int gridX, gridZ;
+  WorldToCell(map, (Vector3){x, 0.0f, z}, &gridX, &gridZ);
+  return GetCell(map, gridX, gridZ) == CELL_WALL;
+}
+
 // ==========================================
 // LOADING
 // ==========================================
 
+unsigned char *ReadLevelFile(const char *filename, int *size) {
+  // From the asset archive when it has the level (copied: levels are a few
+  // KB, and this way the caller frees either the same way), else the file
+  *size = 0;
+  const unsigned char *archived = GetArchiveFile(filename, size);
+  unsigned char *text = NULL;
+  if (archived) {
+    text = MemAlloc((unsigned int)(*size > 0 ? *size : 1));
+    if (text)
+      memcpy(text, archived, (size_t)*size);
+  } else if (!IsArchivedPath(filename)) {
+    text = LoadFileData(filename, size);
+  }
+  if (!text)
+    LOG_ERROR("[MapLoader] Failed to open: %s\n", filename);
+  return text;
+}
+
 bool LoadLevel(const char *filename, LevelMap *map) {
-  FILE *file = fopen(filename, "r");
-  if (!file) {
-    printf("[MapLoader] Failed to open: %s\n", filename);
+  int size = 0;
+  unsigned char *text = ReadLevelFile(filename, &size);
+  if (!text)
     return false;
-  }
+  bool ok = ParseLevel(filename, text, size, map);
+  UnloadFileData(text);
+  return ok;
+}
 
+bool ParseLevel(const char *filename, const unsigned char *text, int size,
+                LevelMap *map) {
   // First pass: determine dimensions
   int width = 0, height = 0;
   int currentWidth = 0;
-  char c;
 
-  while ((c = fgetc(file)) != EOF) {
+  for (int i = 0; i < size; i++) {
+    char c = (char)text[i];
     if (c == '\n') {
       if (currentWidth > width)
         width = currentWidth;
@@ -71,10 +128,10 @@ bool LoadLevel(const char *filename, LevelMap *map) {
   map->playerStart = (Vector3){0.0f, PLAYER_HEIGHT, 0.0f};
 
   // Second pass: read data
-  rewind(file);
   int x = 0, z = 0;
 
-  while ((c = fgetc(file)) != EOF) {
+  for (int i = 0; i < size; i++) {
+    char c = (char)text[i];
     if (c == '\n') {
       z++;
       x = 0;
@@ -111,8 +168,7 @@ bool LoadLevel(const char *filename, LevelMap *map) {
     }
   }
 
-  fclose(file);
-  printf(
+  LOG_INFO(
       "[MapLoader] Loaded %s: %dx%d, %d enemies, start at (%.1f, %.1f, %.1f)\n",
       filename, width, height, map->enemyCount, map->playerStart.x,
       map->playerStart.y, map->playerStart.z);
@@ -124,8 +180,46 @@ bool LoadLevel(const char *filename, LevelMap *map) {
 // RENDERING
 // ==========================================
 
+void BakeLevelMesh(const LevelMap *map) {
+  UnloadLevelMesh(&levelMesh);
+  bakedLevel = NULL;
+  if (map->data && BuildLevelMesh(&levelMesh, map, WALL_HEIGHT, true))
+    bakedLevel = map->data;
+}
+
+void LoadLevelVisibility(const LevelMap *map, const char *filename) {
+  SetCullPVS(NULL, NULL);
+  UnloadLevelPVS(&levelPVS);
+  pvsLevel = NULL;
+  if (!map->data)
+    return;
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s%s", filename, PVS_FILE_EXTENSION);
+  int size = 0;
+  const unsigned char *archived = GetArchiveFile(path, &size);
+  bool loaded = archived ? LoadLevelPVSFromMemory(&levelPVS, archived,
+                                                  (size_t)size, map)
+                         : !IsArchivedPath(path) &&
+                               LoadLevelPVS(&levelPVS, path, map);
+  if (loaded) {
+    LOG_INFO("[MapLoader] Level visibility loaded from %s (%u bytes)\n",
+             path, levelPVS.rleSize);
+  } else {
+    uint64_t start = GetTimestampNs();
+    if (!BuildLevelPVS(&levelPVS, map))
+      return;
+    LOG_INFO("[MapLoader] Level visibility built in %.1f ms (%u bytes); "
+             "kk_pvs can precompute it\n",
+             NsToMs(GetTimestampNs() - start), levelPVS.rleSize);
+  }
+  pvsLevel = map->data;
+  SetCullPVS(&levelPVS, map);
+}
+
 void DrawLevel(const LevelMap *map) {
-  float cellSize = 4.0f;
+  PROFILE_BEGIN(zone, "DrawLevel");
+  float cellSize = MAP_CELL_SIZE;
   float wallHeight = WALL_HEIGHT;
 
   // Floor
@@ -133,18 +227,28 @@ void DrawLevel(const LevelMap *map) {
   DrawPlane((Vector3){0.0f, 0.0f, 0.0f}, (Vector2){floorSize, floorSize},
             (Color){60, 80, 60, 255});
 
-  // Walls
+  // Walls: the baked mesh, or cube by cube if this map wasn't baked
+  if (map->data && map->data == bakedLevel) {
+    DrawLevelMesh(&levelMesh, BROWN, DARKBROWN);
+    PROFILE_END(zone);
+    return;
+  }
   for (int z = 0; z < map->height; z++) {
     for (int x = 0; x < map->width; x++) {
-      if (GetCell(map, x, z) == CELL_WALL) {
-        Vector3 pos = GridToWorld(x, z, map->width, map->height);
-        pos.y = wallHeight / 2.0f;
+      if (GetCell(map, x, z) != CELL_WALL)
+        continue;
+      Vector3 pos = GridToWorld(x, z, map->width, map->height);
+      pos.y = wallHeight / 2.0f;
+      Vector3 half = {cellSize / 2.0f, wallHeight / 2.0f, cellSize / 2.0f};
+      BoundingBox box = {Vector3Subtract(pos, half), Vector3Add(pos, half)};
+      if (!IsBoxVisible(CULL_LEVEL, box))
+        continue;
 
-        DrawCube(pos, cellSize, wallHeight, cellSize, BROWN);
-        DrawCubeWires(pos, cellSize, wallHeight, cellSize, DARKBROWN);
-      }
+      DrawCube(pos, cellSize, wallHeight, cellSize, BROWN);
+      DrawCubeWires(pos, cellSize, wallHeight, cellSize, DARKBROWN);
     }
   }
+  PROFILE_END(zone);
 }
 
 // ==========================================
@@ -152,6 +256,15 @@ void DrawLevel(const LevelMap *map) {
 // ==========================================
 
 void UnloadLevel(LevelMap *map) {
+  if (map->data && map->data == bakedLevel) {
+    UnloadLevelMesh(&levelMesh);
+    bakedLevel = NULL;
+  }
+  if (map->data && map->data == pvsLevel) {
+    SetCullPVS(NULL, NULL);
+    UnloadLevelPVS(&levelPVS);
+    pvsLevel = NULL;
+  }
   if (map->data) {
     free(map->data);
     map->data = NULL;
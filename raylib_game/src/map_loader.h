@@ -19,6 +19,9 @@
 #define CELL_ENEMY_M 'M' // Microwave spawn
 #define CELL_ITEM_H 'H'  // Health pickup
 
+// World units per map cell
+#define MAP_CELL_SIZE 4.0f
+
 // --- Level Map Struct ---
 typedef struct {
   int width;
@@ -30,13 +33,31 @@ typedef struct {
 
 // --- Functions ---
 bool LoadLevel(const char *filename, LevelMap *map);
+// LoadLevel in two halves. The read, from the asset archive or disk, is
+// safe on any thread (free the text with UnloadFileData); the parse spawns
+// the level's enemies, so it belongs to the simulation.
+unsigned char *ReadLevelFile(const char *filename, int *size);
+bool ParseLevel(const char *filename, const unsigned char *text, int size,
+                LevelMap *map);
+// Bake the map's walls into GPU meshes for DrawLevel (needs a window).
+// Unloading the map frees them.
+void BakeLevelMesh(const LevelMap *map);
+// Read <filename>.pvs, or build the PVS if it's missing or stale, and cull
+// the map's draws with it. Unloading the map drops it.
+void LoadLevelVisibility(const LevelMap *map, const char *filename);
 void DrawLevel(const LevelMap *map);
 void UnloadLevel(LevelMap *map);
 
 // Convert grid position to world position
 Vector3 GridToWorld(int gridX, int gridZ, int mapWidth, int mapHeight);
 
+// Convert world position to grid cell. Returns false outside the map.
+bool WorldToCell(const LevelMap *map, Vector3 pos, int *gridX, int *gridZ);
+
 // Get cell at position
 char GetCell(const LevelMap *map, int x, int z);
 
+// True if the world position lies in a wall cell (or outside the map)
+bool IsWallAt(const LevelMap *map, float x, float z);
+
 #endif // MAP_LOADER_H
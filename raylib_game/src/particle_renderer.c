@@ -0,0 +1,238 @@
+/**
+ * Kitchen Knight - Particle Renderer Implementation
+ * =================================================
+ * Particles are drawn unsorted with depth writes off: they still hide
+ * behind walls and enemies, and overlapping soft edges blend the same in
+ * any order closely enough.
+ */
+
+#include "particle_renderer.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STREAM_CHUNK 1024 // Particles per rlgl batch check in the fallback
+#define GRADIENT_SIZE 32  // Fallback soft-circle texture
+
+typedef struct {
+  float x, y, z;
+  float radius;
+  Color color;
+} ParticleInstance;
+
+// Quad corners in radii, counter-clockwise as seen from the camera
+static const float quadCorners[6 * 2] = {
+    -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f,  // Lower right triangle
+    -1.0f, -1.0f, 1.0f, 1.0f,  -1.0f, 1.0f, // Upper left triangle
+};
+
+static const char *particleVertexShader =
+    "#version 330\n"
+    "in vec2 quadCorner;\n"
+    "in vec4 instancePosition;\n" // xyz center, w radius
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "uniform vec3 cameraRight;\n"
+    "uniform vec3 cameraUp;\n"
+    "out vec2 fragCorner;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "  vec3 world = instancePosition.xyz + instancePosition.w *\n"
+    "      (cameraRight * quadCorner.x + cameraUp * quadCorner.y);\n"
+    "  fragCorner = quadCorner;\n"
+    "  fragColor = instanceColor;\n"
+    "  gl_Position = mvp * vec4(world, 1.0);\n"
+    "}\n";
+
+static const char *particleFragmentShader =
+    "#version 330\n"
+    "in vec2 fragCorner;\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "  float d = dot(fragCorner, fragCorner);\n"
+    "  if (d > 1.0) discard;\n"
+    "  float edge = 1.0 - smoothstep(0.25, 1.0, d);\n"
+    "  finalColor = vec4(fragColor.rgb, fragColor.a * edge);\n"
+    "}\n";
+
+static ParticleInstance *instances = NULL;
+static int capacity = 0;
+static int instanceCount = 0;
+static Vector3 cameraRight, cameraUp;
+
+// Instanced path (GL 3.3+)
+static bool instanced = false;
+static Shader shader = {0};
+static unsigned int vao = 0;
+static unsigned int cornerVbo = 0;
+static unsigned int instanceVbo = 0;
+static int mvpLoc, rightLoc, upLoc;
+
+// Streamed fallback
+static Texture2D gradient = {0};
+
+// ==========================================
+// SETUP
+// ==========================================
+
+static bool LoadInstancing(void) {
+  int version = rlGetVersion();
+  if (version != RL_OPENGL_33 && version != RL_OPENGL_43)
+    return false;
+
+  shader = LoadShaderFromMemory(particleVertexShader, particleFragmentShader);
+  if (shader.id == 0 || shader.id == rlGetShaderIdDefault())
+    return false;
+  int cornerLoc = GetShaderLocationAttrib(shader, "quadCorner");
+  int positionLoc = GetShaderLocationAttrib(shader, "instancePosition");
+  int colorLoc = GetShaderLocationAttrib(shader, "instanceColor");
+  mvpLoc = GetShaderLocation(shader, "mvp");
+  rightLoc = GetShaderLocation(shader, "cameraRight");
+  upLoc = GetShaderLocation(shader, "cameraUp");
+  if (cornerLoc < 0 || positionLoc < 0 || colorLoc < 0) {
+    UnloadShader(shader);
+    return false;
+  }
+
+  vao = rlLoadVertexArray();
+  rlEnableVertexArray(vao);
+  cornerVbo = rlLoadVertexBuffer(quadCorners, sizeof(quadCorners), false);
+  rlSetVertexAttribute((unsigned)cornerLoc, 2, RL_FLOAT, false, 0, 0);
+  rlEnableVertexAttribute((unsigned)cornerLoc);
+
+  instanceVbo = rlLoadVertexBuffer(
+      NULL, capacity * (int)sizeof(ParticleInstance), true);
+  rlSetVertexAttribute((unsigned)positionLoc, 4, RL_FLOAT, false,
+                       sizeof(ParticleInstance), 0);
+  rlEnableVertexAttribute((unsigned)positionLoc);
+  rlSetVertexAttributeDivisor((unsigned)positionLoc, 1);
+  rlSetVertexAttribute((unsigned)colorLoc, 4, RL_UNSIGNED_BYTE, true,
+                       sizeof(ParticleInstance),
+                       offsetof(ParticleInstance, color));
+  rlEnableVertexAttribute((unsigned)colorLoc);
+  rlSetVertexAttributeDivisor((unsigned)colorLoc, 1);
+  rlDisableVertexArray();
+  return true;
+}
+
+void InitParticleRenderer(int maxParticles) {
+  UnloadParticleRenderer();
+  capacity = maxParticles > 0 ? maxParticles : 1;
+  instances = malloc(sizeof(ParticleInstance) * (size_t)capacity);
+  if (!instances) {
+    printf("[Particles] ERROR: Out of memory for %d particles\n", capacity);
+    capacity = 0;
+    return;
+  }
+
+  instanced = LoadInstancing();
+  if (!instanced) {
+    Image image = GenImageGradientRadial(GRADIENT_SIZE, GRADIENT_SIZE, 0.25f,
+                                         WHITE, BLANK);
+    gradient = LoadTextureFromImage(image);
+    UnloadImage(image);
+  }
+  printf("[Particles] %d particles per draw, %s\n", capacity,
+         instanced ? "instanced" : "streamed (no GL 3.3)");
+}
+
+void UnloadParticleRenderer(void) {
+  if (instanced) {
+    rlUnloadVertexArray(vao);
+    rlUnloadVertexBuffer(cornerVbo);
+    rlUnloadVertexBuffer(instanceVbo);
+    UnloadShader(shader);
+    instanced = false;
+  }
+  if (gradient.id > 0) {
+    UnloadTexture(gradient);
+    gradient = (Texture2D){0};
+  }
+  free(instances);
+  instances = NULL;
+  capacity = instanceCount = 0;
+}
+
+// ==========================================
+// DRAWING
+// ==========================================
+
+static void DrawInstanced(void) {
+  Matrix mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+  rlEnableShader(shader.id);
+  rlSetUniformMatrix(mvpLoc, mvp);
+  rlSetUniform(rightLoc, &cameraRight, SHADER_UNIFORM_VEC3, 1);
+  rlSetUniform(upLoc, &cameraUp, SHADER_UNIFORM_VEC3, 1);
+  rlEnableVertexArray(vao);
+  rlUpdateVertexBuffer(instanceVbo, instances,
+                       instanceCount * (int)sizeof(ParticleInstance), 0);
+  rlDrawVertexArrayInstanced(0, 6, instanceCount);
+  rlDisableVertexArray();
+  rlDisableShader();
+}
+
+static void DrawStreamed(void) {
+  static const float u[4] = {0.0f, 1.0f, 1.0f, 0.0f};
+  static const float v[4] = {1.0f, 1.0f, 0.0f, 0.0f};
+  for (int chunk = 0; chunk < instanceCount; chunk += STREAM_CHUNK) {
+    int end = chunk + STREAM_CHUNK < instanceCount ? chunk + STREAM_CHUNK
+                                                   : instanceCount;
+    rlCheckRenderBatchLimit((end - chunk) * 4);
+    rlSetTexture(gradient.id);
+    rlBegin(RL_QUADS);
+    for (int i = chunk; i < end; i++) {
+      const ParticleInstance *p = &instances[i];
+      Vector3 center = {p->x, p->y, p->z};
+      Vector3 right = Vector3Scale(cameraRight, p->radius);
+      Vector3 up = Vector3Scale(cameraUp, p->radius);
+      Vector3 bottom = Vector3Subtract(center, up);
+      Vector3 top = Vector3Add(center, up);
+      Vector3 corners[4] = {
+          Vector3Subtract(bottom, right), Vector3Add(bottom, right),
+          Vector3Add(top, right), Vector3Subtract(top, right)};
+
+      rlColor4ub(p->color.r, p->color.g, p->color.b, p->color.a);
+      for (int c = 0; c < 4; c++) {
+        rlTexCoord2f(u[c], v[c]);
+        rlVertex3f(corners[c].x, corners[c].y, corners[c].z);
+      }
+    }
+    rlEnd();
+    rlSetTexture(0);
+  }
+  rlDrawRenderBatchActive(); // Before depth writes come back on
+}
+
+static void FlushParticles(void) {
+  if (instanceCount == 0)
+    return;
+  rlDrawRenderBatchActive(); // Earlier immediate-mode draws keep depth writes
+  rlDisableDepthMask();
+  if (instanced)
+    DrawInstanced();
+  else
+    DrawStreamed();
+  rlEnableDepthMask();
+  instanceCount = 0;
+}
+
+void BeginParticleBatch(Camera3D camera) {
+  Matrix view = GetCameraMatrix(camera);
+  cameraRight = (Vector3){view.m0, view.m4, view.m8};
+  cameraUp = (Vector3){view.m1, view.m5, view.m9};
+  instanceCount = 0;
+}
+
+void PushParticle(Vector3 position, float radius, Color color) {
+  if (!instances)
+    return;
+  if (instanceCount == capacity)
+    FlushParticles();
+  instances[instanceCount++] =
+      (ParticleInstance){position.x, position.y, position.z, radius, color};
+}
+
+void EndParticleBatch(void) { FlushParticles(); }
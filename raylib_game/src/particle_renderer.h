@@ -0,0 +1,28 @@
+/**
+ * Kitchen Knight - Particle Renderer
+ * ==================================
+ * Soft round particles as camera-facing quads. Each frame's particles are
+ * streamed into one dynamic instance buffer (center, radius, color) and
+ * drawn with a single instanced call; the fragment shader shapes the quad
+ * into a circle that fades toward its edge. Without GL 3.3 the quads go
+ * through rlgl's batch with a radial gradient texture instead.
+ *
+ *   BeginParticleBatch(camera);
+ *   PushParticle(position, radius, color);   // Per particle
+ *   EndParticleBatch();                      // Inside BeginMode3D
+ */
+
+#ifndef PARTICLE_RENDERER_H
+#define PARTICLE_RENDERER_H
+
+#include "raylib.h"
+
+// Needs a window. A batch over capacity is drawn in several calls.
+void InitParticleRenderer(int capacity);
+void UnloadParticleRenderer(void);
+
+void BeginParticleBatch(Camera3D camera);
+void PushParticle(Vector3 position, float radius, Color color);
+void EndParticleBatch(void);
+
+#endif // PARTICLE_RENDERER_H
@@ -1,36 +1,181 @@
 /**
  * Kitchen Knight - Particle System Implementation
  * ================================================
- * Particle pool, updates, and rendering.
+ * Particle pool, updates, and rendering. The update integrates the live
+ * range with masked lane operations; the scalar version is the reference,
+ * used for tails and non-x86 builds, and must stay in lock-step with the
+ * vector versions (same operations, same order).
  */
 
 #include "particles.h"
+#include "culling.h"
+#include "jobs.h"
+#include "particle_renderer.h"
+#include "profiler.h"
 #include "raymath.h"
+#include "simd.h"
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 // --- Global Pool ---
-static Particle particlePool[MAX_PARTICLES];
+ParticlePool particlePool;
+
+// What DrawParticles sees: the live particles at publish time
+static int drawCount = 0;
+static float drawX[MAX_PARTICLES], drawY[MAX_PARTICLES], drawZ[MAX_PARTICLES];
+static float drawLifetime[MAX_PARTICLES], drawMaxLifetime[MAX_PARTICLES];
+static float drawSize[MAX_PARTICLES];
+static Color drawColor[MAX_PARTICLES];
+static uint8_t drawVisible[MAX_PARTICLES];
+
+// Longest lifetime spawned since InitParticleSystem: no particle is older
+static float longestLifetime = 0.0f;
+
+#define PARTICLE_CULL_RADIUS 0.5f // Largest spawn size
+
+// Particles per job chunk (a multiple of 8 keeps AVX2 blocks whole)
+#define PARTICLE_JOB_GRAIN 1024
+
+// Physics
+#define PARTICLE_GRAVITY 15.0f
+#define PARTICLE_FLOOR 0.1f     // Lowest height; below it they bounce
+#define PARTICLE_BOUNCE -0.3f   // Vertical speed kept (flipped) by a bounce
+#define PARTICLE_FRICTION 0.8f  // Horizontal speed kept by a bounce
+
+#define PARTICLE_AGE_BUCKETS 64 // Age resolution of oldest-first recycling
+// Fewest slots a full pool frees at once
+#define PARTICLE_RECYCLE_MIN (MAX_PARTICLES / 16)
 
 // ==========================================
 // INITIALIZATION
 // ==========================================
 
 void InitParticleSystem(void) {
-  for (int i = 0; i < MAX_PARTICLES; i++) {
-    particlePool[i].active = false;
+  particlePool.count = 0;
+  longestLifetime = 0.0f;
+}
+
+// ==========================================
+// POOL
+// ==========================================
+
+static void MoveParticle(int dst, int src) {
+  ParticlePool *p = &particlePool;
+  p->posX[dst] = p->posX[src];
+  p->posY[dst] = p->posY[src];
+  p->posZ[dst] = p->posZ[src];
+  p->velX[dst] = p->velX[src];
+  p->velY[dst] = p->velY[src];
+  p->velZ[dst] = p->velZ[src];
+  p->lifetime[dst] = p->lifetime[src];
+  p->maxLifetime[dst] = p->maxLifetime[src];
+  p->size[dst] = p->size[src];
+  p->color[dst] = p->color[src];
+  p->prevX[dst] = p->prevX[src];
+  p->prevY[dst] = p->prevY[src];
+  p->prevZ[dst] = p->prevZ[src];
+}
+
+// Swap-remove: the last live particle takes each dead one's slot, so
+// [0, count) stays dense
+static void RemoveDeadParticles(void) {
+  ParticlePool *p = &particlePool;
+  int i = 0;
+  while (i < p->count) {
+    if (p->lifetime[i] > 0) {
+      i++;
+      continue;
+    }
+    // Slot i gets an unchecked particle: look at it again
+    MoveParticle(i, --p->count);
   }
 }
 
+static inline int AgeBucket(const ParticlePool *p, int i, float scale) {
+  return (int)((p->maxLifetime[i] - p->lifetime[i]) * scale);
+}
+
+// Frees at least k slots (PARTICLE_RECYCLE_MIN, so a full pool isn't
+// rescanned for every small burst) by dropping the particles alive
+// longest: one pass buckets their ages, a second swap-removes whole
+// buckets from the old end, plus enough of the bucket the cut falls in
+static void RecycleOldestParticles(int k) {
+  ParticlePool *p = &particlePool;
+  if (k < PARTICLE_RECYCLE_MIN)
+    k = PARTICLE_RECYCLE_MIN;
+  if (k >= p->count) {
+    p->count = 0;
+    return;
+  }
+
+  float scale = longestLifetime > 0.0f
+                    ? (PARTICLE_AGE_BUCKETS - 1) / longestLifetime
+                    : 0.0f;
+  int histogram[PARTICLE_AGE_BUCKETS] = {0};
+  for (int i = 0; i < p->count; i++)
+    histogram[AgeBucket(p, i, scale)]++;
+
+  int cut = PARTICLE_AGE_BUCKETS - 1;
+  int taken = 0;
+  while (taken + histogram[cut] < k)
+    taken += histogram[cut--];
+  int fromCut = k - taken;
+
+  int i = 0;
+  while (i < p->count && k > 0) {
+    int bucket = AgeBucket(p, i, scale);
+    if (bucket < cut || (bucket == cut && fromCut == 0)) {
+      i++;
+      continue;
+    }
+    if (bucket == cut)
+      fromCut--;
+    k--;
+    MoveParticle(i, --p->count);
+  }
+}
+
+int ReserveParticles(int count) {
+  ParticlePool *p = &particlePool;
+  if (count <= 0)
+    return p->count;
+  if (count > MAX_PARTICLES)
+    count = MAX_PARTICLES;
+  int overflow = p->count + count - MAX_PARTICLES;
+  if (overflow > 0)
+    RecycleOldestParticles(overflow);
+  int first = p->count;
+  p->count += count;
+  return first;
+}
+
 // ==========================================
 // HELPERS
 // ==========================================
 
-static int FindFreeSlot(void) {
-  for (int i = 0; i < MAX_PARTICLES; i++) {
-    if (!particlePool[i].active)
-      return i;
+// Shared spawn state of a reserved block, at rest at pos
+static void FillParticleBlock(int first, int end, Vector3 pos, Color color) {
+  ParticlePool *p = &particlePool;
+  for (int i = first; i < end; i++) {
+    p->posX[i] = p->prevX[i] = pos.x;
+    p->posY[i] = p->prevY[i] = pos.y;
+    p->posZ[i] = p->prevZ[i] = pos.z;
+    p->color[i] = color;
   }
-  return -1; // No free slot
+}
+
+static void LaunchParticle(int i, Vector3 velocity, float lifetime,
+                           float size) {
+  ParticlePool *p = &particlePool;
+  p->velX[i] = velocity.x;
+  p->velY[i] = velocity.y;
+  p->velZ[i] = velocity.z;
+  p->lifetime[i] = lifetime;
+  p->maxLifetime[i] = lifetime;
+  p->size[i] = size;
+  if (lifetime > longestLifetime)
+    longestLifetime = lifetime;
 }
 
 static Vector3 RandomDirection(void) {
@@ -45,119 +190,251 @@ static Vector3 RandomDirection(void) {
 // ==========================================
 
 void SpawnExplosion(Vector3 pos, Color color, int count) {
-  for (int i = 0; i < count; i++) {
-    int slot = FindFreeSlot();
-    if (slot < 0)
-      break;
-
+  int first = ReserveParticles(count);
+  int end = particlePool.count;
+  FillParticleBlock(first, end, pos, color);
+  for (int i = first; i < end; i++) {
     Vector3 dir = RandomDirection();
     float speed = 5.0f + (float)GetRandomValue(0, 100) / 10.0f;
-
-    particlePool[slot] =
-        (Particle){.position = pos,
-                   .velocity = Vector3Scale(dir, speed),
-                   .color = color,
-                   .lifetime = 0.5f + (float)GetRandomValue(0, 50) / 100.0f,
-                   .maxLifetime = 1.0f,
-                   .size = 0.2f + (float)GetRandomValue(0, 30) / 100.0f,
-                   .active = true};
-    particlePool[slot].maxLifetime = particlePool[slot].lifetime;
+    float lifetime = 0.5f + (float)GetRandomValue(0, 50) / 100.0f;
+    float size = 0.2f + (float)GetRandomValue(0, 30) / 100.0f;
+    LaunchParticle(i, Vector3Scale(dir, speed), lifetime, size);
   }
 }
 
 void SpawnHitSparks(Vector3 pos, int count) {
-  for (int i = 0; i < count; i++) {
-    int slot = FindFreeSlot();
-    if (slot < 0)
-      break;
-
+  int first = ReserveParticles(count);
+  int end = particlePool.count;
+  FillParticleBlock(first, end, pos, YELLOW);
+  for (int i = first; i < end; i++) {
     Vector3 dir = RandomDirection();
     float speed = 3.0f + (float)GetRandomValue(0, 50) / 10.0f;
-
-    particlePool[slot] =
-        (Particle){.position = pos,
-                   .velocity = Vector3Scale(dir, speed),
-                   .color = YELLOW,
-                   .lifetime = 0.2f + (float)GetRandomValue(0, 20) / 100.0f,
-                   .maxLifetime = 0.4f,
-                   .size = 0.1f,
-                   .active = true};
-    particlePool[slot].maxLifetime = particlePool[slot].lifetime;
+    float lifetime = 0.2f + (float)GetRandomValue(0, 20) / 100.0f;
+    LaunchParticle(i, Vector3Scale(dir, speed), lifetime, 0.1f);
   }
 }
 
 void SpawnBlood(Vector3 pos, int count) {
-  for (int i = 0; i < count; i++) {
-    int slot = FindFreeSlot();
-    if (slot < 0)
-      break;
-
+  int first = ReserveParticles(count);
+  int end = particlePool.count;
+  FillParticleBlock(first, end, pos, RED);
+  for (int i = first; i < end; i++) {
     Vector3 dir = RandomDirection();
     dir.y = fabsf(dir.y); // Bias upward
     float speed = 2.0f + (float)GetRandomValue(0, 40) / 10.0f;
+    float lifetime = 0.3f + (float)GetRandomValue(0, 30) / 100.0f;
+    LaunchParticle(i, Vector3Scale(dir, speed), lifetime, 0.15f);
+  }
+}
 
-    particlePool[slot] =
-        (Particle){.position = pos,
-                   .velocity = Vector3Scale(dir, speed),
-                   .color = RED,
-                   .lifetime = 0.3f + (float)GetRandomValue(0, 30) / 100.0f,
-                   .maxLifetime = 0.6f,
-                   .size = 0.15f,
-                   .active = true};
-    particlePool[slot].maxLifetime = particlePool[slot].lifetime;
+// ==========================================
+// UPDATE: SCALAR
+// ==========================================
+
+static void IntegrateParticlesScalar(ParticlePool *p, int begin, int end,
+                                     float dt) {
+  float fall = PARTICLE_GRAVITY * dt;
+  for (int i = begin; i < end; i++) {
+    float vx = p->velX[i], vy = p->velY[i], vz = p->velZ[i];
+    float x = p->posX[i] + vx * dt;
+    float y = p->posY[i] + vy * dt;
+    float z = p->posZ[i] + vz * dt;
+    vy -= fall;
+    p->lifetime[i] -= dt;
+
+    // Floor collision
+    if (y < PARTICLE_FLOOR) {
+      y = PARTICLE_FLOOR;
+      vy *= PARTICLE_BOUNCE;
+      vx *= PARTICLE_FRICTION;
+      vz *= PARTICLE_FRICTION;
+    }
+
+    p->posX[i] = x;
+    p->posY[i] = y;
+    p->posZ[i] = z;
+    p->velX[i] = vx;
+    p->velY[i] = vy;
+    p->velZ[i] = vz;
   }
 }
 
+#if KK_HAVE_SSE2
+
 // ==========================================
-// UPDATE
+// UPDATE: SSE2 (4 lanes)
 // ==========================================
 
-void UpdateParticles(float dt) {
-  for (int i = 0; i < MAX_PARTICLES; i++) {
-    if (!particlePool[i].active)
-      continue;
+static inline __m128 Select4(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
 
-    Particle *p = &particlePool[i];
+static int IntegrateParticlesSSE2(ParticlePool *p, int begin, int end,
+                                  float dt) {
+  const __m128 step = _mm_set1_ps(dt);
+  const __m128 fall = _mm_set1_ps(PARTICLE_GRAVITY * dt);
+  const __m128 floorY = _mm_set1_ps(PARTICLE_FLOOR);
+  const __m128 bounce = _mm_set1_ps(PARTICLE_BOUNCE);
+  const __m128 friction = _mm_set1_ps(PARTICLE_FRICTION);
 
-    // Physics
-    p->position = Vector3Add(p->position, Vector3Scale(p->velocity, dt));
-    p->velocity.y -= 15.0f * dt; // Gravity
+  int i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 vx = _mm_loadu_ps(&p->velX[i]);
+    __m128 vy = _mm_loadu_ps(&p->velY[i]);
+    __m128 vz = _mm_loadu_ps(&p->velZ[i]);
+    __m128 x = _mm_add_ps(_mm_loadu_ps(&p->posX[i]), _mm_mul_ps(vx, step));
+    __m128 y = _mm_add_ps(_mm_loadu_ps(&p->posY[i]), _mm_mul_ps(vy, step));
+    __m128 z = _mm_add_ps(_mm_loadu_ps(&p->posZ[i]), _mm_mul_ps(vz, step));
+    vy = _mm_sub_ps(vy, fall);
+    _mm_storeu_ps(&p->lifetime[i],
+                  _mm_sub_ps(_mm_loadu_ps(&p->lifetime[i]), step));
 
-    // Lifetime
-    p->lifetime -= dt;
-    if (p->lifetime <= 0) {
-      p->active = false;
-    }
+    // Floor collision
+    __m128 hit = _mm_cmplt_ps(y, floorY);
+    y = Select4(hit, floorY, y);
+    vy = Select4(hit, _mm_mul_ps(vy, bounce), vy);
+    vx = Select4(hit, _mm_mul_ps(vx, friction), vx);
+    vz = Select4(hit, _mm_mul_ps(vz, friction), vz);
+
+    _mm_storeu_ps(&p->posX[i], x);
+    _mm_storeu_ps(&p->posY[i], y);
+    _mm_storeu_ps(&p->posZ[i], z);
+    _mm_storeu_ps(&p->velX[i], vx);
+    _mm_storeu_ps(&p->velY[i], vy);
+    _mm_storeu_ps(&p->velZ[i], vz);
+  }
+  return i;
+}
+
+// ==========================================
+// UPDATE: AVX2 (8 lanes)
+// ==========================================
+
+static KK_TARGET_AVX2 int IntegrateParticlesAVX2(ParticlePool *p, int begin,
+                                                 int end, float dt) {
+  const __m256 step = _mm256_set1_ps(dt);
+  const __m256 fall = _mm256_set1_ps(PARTICLE_GRAVITY * dt);
+  const __m256 floorY = _mm256_set1_ps(PARTICLE_FLOOR);
+  const __m256 bounce = _mm256_set1_ps(PARTICLE_BOUNCE);
+  const __m256 friction = _mm256_set1_ps(PARTICLE_FRICTION);
+
+  int i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 vx = _mm256_loadu_ps(&p->velX[i]);
+    __m256 vy = _mm256_loadu_ps(&p->velY[i]);
+    __m256 vz = _mm256_loadu_ps(&p->velZ[i]);
+    // Separate mul and add (no FMA) to round like the scalar version
+    __m256 x =
+        _mm256_add_ps(_mm256_loadu_ps(&p->posX[i]), _mm256_mul_ps(vx, step));
+    __m256 y =
+        _mm256_add_ps(_mm256_loadu_ps(&p->posY[i]), _mm256_mul_ps(vy, step));
+    __m256 z =
+        _mm256_add_ps(_mm256_loadu_ps(&p->posZ[i]), _mm256_mul_ps(vz, step));
+    vy = _mm256_sub_ps(vy, fall);
+    _mm256_storeu_ps(&p->lifetime[i],
+                     _mm256_sub_ps(_mm256_loadu_ps(&p->lifetime[i]), step));
 
     // Floor collision
-    if (p->position.y < 0.1f) {
-      p->position.y = 0.1f;
-      p->velocity.y *= -0.3f; // Bounce
-      p->velocity.x *= 0.8f;
-      p->velocity.z *= 0.8f;
-    }
+    __m256 hit = _mm256_cmp_ps(y, floorY, _CMP_LT_OQ);
+    y = _mm256_blendv_ps(y, floorY, hit);
+    vy = _mm256_blendv_ps(vy, _mm256_mul_ps(vy, bounce), hit);
+    vx = _mm256_blendv_ps(vx, _mm256_mul_ps(vx, friction), hit);
+    vz = _mm256_blendv_ps(vz, _mm256_mul_ps(vz, friction), hit);
+
+    _mm256_storeu_ps(&p->posX[i], x);
+    _mm256_storeu_ps(&p->posY[i], y);
+    _mm256_storeu_ps(&p->posZ[i], z);
+    _mm256_storeu_ps(&p->velX[i], vx);
+    _mm256_storeu_ps(&p->velY[i], vy);
+    _mm256_storeu_ps(&p->velZ[i], vz);
   }
+  return i;
+}
+
+#endif // KK_HAVE_SSE2
+
+// ==========================================
+// UPDATE: DISPATCH
+// ==========================================
+
+// Particles are independent, so chunks can run on any worker
+static void UpdateParticleRange(void *ctx, int begin, int end, int worker) {
+  (void)worker;
+  float dt = *(const float *)ctx;
+  int i = begin;
+#if KK_HAVE_SSE2
+  switch (GetSimdLevel()) {
+  case SIMD_AVX2:
+    i = IntegrateParticlesAVX2(&particlePool, i, end, dt);
+    break;
+  case SIMD_SSE2:
+    i = IntegrateParticlesSSE2(&particlePool, i, end, dt);
+    break;
+  default:
+    break;
+  }
+#endif
+  IntegrateParticlesScalar(&particlePool, i, end, dt);
+}
+
+void UpdateParticles(float dt) {
+  PROFILE_BEGIN(zone, "UpdateParticles");
+  ParallelFor(0, particlePool.count, PARTICLE_JOB_GRAIN, UpdateParticleRange,
+              &dt);
+  RemoveDeadParticles(); // Serial, after the parallel integrate
+  PROFILE_END(zone);
 }
 
 // ==========================================
 // RENDERING
 // ==========================================
 
-void DrawParticles(void) {
-  for (int i = 0; i < MAX_PARTICLES; i++) {
-    if (!particlePool[i].active)
-      continue;
+void SaveParticleInterpolationState(void) {
+  size_t bytes = (size_t)particlePool.count * sizeof(float);
+  memcpy(particlePool.prevX, particlePool.posX, bytes);
+  memcpy(particlePool.prevY, particlePool.posY, bytes);
+  memcpy(particlePool.prevZ, particlePool.posZ, bytes);
+}
 
-    Particle *p = &particlePool[i];
+// Called while the simulation is idle, so drawing can overlap the next
+// update
+void PublishParticleDrawState(float alpha) {
+  const ParticlePool *p = &particlePool;
+  drawCount = p->count;
+  for (int i = 0; i < drawCount; i++) {
+    drawX[i] = p->prevX[i] + alpha * (p->posX[i] - p->prevX[i]);
+    drawY[i] = p->prevY[i] + alpha * (p->posY[i] - p->prevY[i]);
+    drawZ[i] = p->prevZ[i] + alpha * (p->posZ[i] - p->prevZ[i]);
+  }
+  size_t bytes = (size_t)drawCount * sizeof(float);
+  memcpy(drawLifetime, p->lifetime, bytes);
+  memcpy(drawMaxLifetime, p->maxLifetime, bytes);
+  memcpy(drawSize, p->size, bytes);
+  memcpy(drawColor, p->color, (size_t)drawCount * sizeof(Color));
+}
+
+int GetParticleDrawCount(void) { return drawCount; }
+
+// One instanced draw for every live particle in view
+void DrawParticles(Camera3D camera) {
+  PROFILE_BEGIN(zone, "DrawParticles");
+  CullSpheres(CULL_PARTICLES, drawX, drawY, drawZ, PARTICLE_CULL_RADIUS,
+              drawCount, drawVisible);
+  BeginParticleBatch(camera);
+  for (int k = 0; k < drawCount; k++) {
+    if (!drawVisible[k])
+      continue;
 
     // Fade out
-    float alpha = p->lifetime / p->maxLifetime;
-    Color drawColor = p->color;
-    drawColor.a = (unsigned char)(255 * alpha);
+    float alpha = drawLifetime[k] / drawMaxLifetime[k];
+    Color color = drawColor[k];
+    color.a = (unsigned char)(255 * alpha);
 
     // Shrink over time
-    float size = p->size * alpha;
+    float size = drawSize[k] * alpha;
 
-    DrawSphere(p->position, size, drawColor);
+    PushParticle((Vector3){drawX[k], drawY[k], drawZ[k]}, size, color);
   }
+  EndParticleBatch();
+  PROFILE_END(zone);
 }
@@ -1,7 +1,12 @@
 /**
  * Kitchen Knight - Particle System
  * =================================
- * Visual effects for explosions, hits, etc.
+ * Visual effects for explosions, hits, etc. The pool is a dense
+ * structure of arrays: live particles are slots [0, count), in no
+ * particular order, and a particle that dies is overwritten by the last
+ * one. Updates only touch the living, 4 (SSE2) or 8 (AVX2) at a time.
+ * Effects reserve their whole burst at once; a full pool makes room by
+ * dropping its oldest particles rather than the new ones.
  */
 
 #ifndef PARTICLES_H
@@ -10,24 +15,46 @@
 #include "raylib.h"
 #include <stdbool.h>
 
-// --- Particle Struct ---
+// Pool size (live particles at once)
+#define MAX_PARTICLES 131072
+
+// --- Particle Pool (SoA) ---
 typedef struct {
-  Vector3 position;
-  Vector3 velocity;
-  Color color;
-  float lifetime;
-  float maxLifetime;
-  float size;
-  bool active;
-} Particle;
-
-// Pool size
-#define MAX_PARTICLES 256
+  // Hot: read and written by every update
+  float posX[MAX_PARTICLES];
+  float posY[MAX_PARTICLES];
+  float posZ[MAX_PARTICLES];
+  float velX[MAX_PARTICLES];
+  float velY[MAX_PARTICLES];
+  float velZ[MAX_PARTICLES];
+  float lifetime[MAX_PARTICLES]; // Seconds left; dies at 0
+
+  // Cold: spawn and draw only
+  float maxLifetime[MAX_PARTICLES];
+  float size[MAX_PARTICLES];
+  Color color[MAX_PARTICLES];
+  float prevX[MAX_PARTICLES]; // Position before the last fixed step, for
+  float prevY[MAX_PARTICLES]; // drawing between steps
+  float prevZ[MAX_PARTICLES];
+
+  int count; // Live particles
+} ParticlePool;
+
+extern ParticlePool particlePool;
 
 // --- Functions ---
 void InitParticleSystem(void);
 void UpdateParticles(float dt);
-void DrawParticles(void);
+void SaveParticleInterpolationState(void); // Before the frame's last step
+// Snapshot for DrawParticles, alpha of the way into the last step
+void PublishParticleDrawState(float alpha);
+int GetParticleDrawCount(void); // Active particles in the snapshot
+void DrawParticles(Camera3D camera);
+
+// Appends count slots in one step and returns the first; the block is
+// [first, particlePool.count) and the caller fills every array in it.
+// When the pool can't fit them, the oldest particles are recycled.
+int ReserveParticles(int count);
 
 // Effects
 void SpawnExplosion(Vector3 pos, Color color, int count);
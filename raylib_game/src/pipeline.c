@@ -0,0 +1,152 @@
+/**
+ * Kitchen Knight - Simulation Pipeline Implementation
+ * ===================================================
+ * One long-lived simulation thread, handed one frame at a time through a
+ * mutex and condition variable. The handoff is also what makes the main
+ * thread's snapshot copies safe: it only publishes after waiting here.
+ */
+
+#include "pipeline.h"
+#include "profiler.h"
+#include "sys_thread.h"
+#include "timer.h"
+#include <stdio.h>
+
+typedef enum { SIM_IDLE, SIM_QUEUED, SIM_RUNNING } SimState;
+
+static bool pipelined = false;
+static SysThread *simThread = NULL;
+static SysMutex *simMutex = NULL;
+static SysCond *simCond = NULL;
+
+// Guarded by simMutex
+static SimState simState = SIM_IDLE;
+static bool simQuit = false;
+static GameState *simGame = NULL;
+static InputFrame simInput;
+
+static uint64_t lastSimNs = 0;
+
+// ==========================================
+// SIMULATION THREAD
+// ==========================================
+
+static void TimedUpdate(GameState *game, const InputFrame *input) {
+  uint64_t start = GetTimestampNs();
+  UpdateGame(game, input);
+  lastSimNs = GetTimestampNs() - start;
+}
+
+static void SimThreadMain(void *arg) {
+  (void)arg;
+  SetProfileThreadName("Sim");
+  LockSysMutex(simMutex);
+  for (;;) {
+    while (!simQuit && simState != SIM_QUEUED)
+      WaitSysCond(simCond, simMutex);
+    if (simQuit)
+      break;
+
+    simState = SIM_RUNNING;
+    UnlockSysMutex(simMutex);
+    TimedUpdate(simGame, &simInput);
+    LockSysMutex(simMutex);
+
+    simState = SIM_IDLE;
+    BroadcastSysCond(simCond);
+  }
+  UnlockSysMutex(simMutex);
+}
+
+static bool StartSimThread(void) {
+  if (simThread)
+    return true;
+
+  simMutex = CreateSysMutex();
+  simCond = CreateSysCond();
+  simQuit = false;
+  simState = SIM_IDLE;
+  if (simMutex && simCond)
+    simThread = CreateSysThread(SimThreadMain, NULL);
+
+  if (!simThread) {
+    printf("[Pipeline] ERROR: Could not start the simulation thread\n");
+    DestroySysCond(simCond);
+    DestroySysMutex(simMutex);
+    simCond = NULL;
+    simMutex = NULL;
+    return false;
+  }
+  return true;
+}
+
+static void WaitSimIdle(void) {
+  if (!simThread)
+    return;
+  LockSysMutex(simMutex);
+  while (simState != SIM_IDLE)
+    WaitSysCond(simCond, simMutex);
+  UnlockSysMutex(simMutex);
+}
+
+// ==========================================
+// MAIN THREAD
+// ==========================================
+
+bool SetSimPipelined(bool enabled) {
+  if (enabled == pipelined)
+    return true;
+
+  if (enabled && !StartSimThread())
+    return false;
+  if (!enabled)
+    WaitSimIdle();
+
+  pipelined = enabled;
+  printf("[Pipeline] Simulation %s\n",
+         pipelined ? "pipelined (one frame ahead)" : "serial");
+  return true;
+}
+
+bool IsSimPipelined(void) { return pipelined; }
+
+void RunSimFrame(GameState *live, const InputFrame *input) {
+  if (pipelined)
+    WaitSimIdle();
+  else
+    TimedUpdate(live, input);
+}
+
+void KickSimFrame(GameState *live, const InputFrame *input) {
+  if (!pipelined)
+    return;
+
+  LockSysMutex(simMutex);
+  simGame = live;
+  simInput = *input;
+  simState = SIM_QUEUED;
+  BroadcastSysCond(simCond);
+  UnlockSysMutex(simMutex);
+}
+
+void ShutdownSimPipeline(void) {
+  if (!simThread)
+    return;
+
+  LockSysMutex(simMutex);
+  while (simState != SIM_IDLE)
+    WaitSysCond(simCond, simMutex);
+  simQuit = true;
+  BroadcastSysCond(simCond);
+  UnlockSysMutex(simMutex);
+
+  JoinSysThread(simThread);
+  DestroySysCond(simCond);
+  DestroySysMutex(simMutex);
+  simThread = NULL;
+  simCond = NULL;
+  simMutex = NULL;
+  pipelined = false;
+}
+
+uint64_t GetLastSimNs(void) { return lastSimNs; }
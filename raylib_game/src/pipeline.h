@@ -0,0 +1,45 @@
+/**
+ * Kitchen Knight - Simulation Pipeline
+ * ====================================
+ * Optionally runs UpdateGame on a dedicated thread, one frame ahead of the
+ * renderer. The main thread draws frame N from the published snapshots
+ * while frame N+1 simulates, so a frame costs about max(sim, render)
+ * instead of the sum, at the price of one extra frame of input latency.
+ * All raylib calls stay on the main thread.
+ *
+ * Per frame, on the main thread:
+ *   InputFrame input = PollInputFrame();
+ *   RunSimFrame(&live, &input);          // Serial: update now
+ *   PublishGameDrawState(&view, &live);  // Sim is idle here
+ *   KickSimFrame(&live, &input);         // Pipelined: update while drawing
+ *   ... draw view ...
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "game.h"
+#include "input.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Switch modes; turning pipelining off waits for the frame in flight.
+// Returns false if the simulation thread could not be started.
+bool SetSimPipelined(bool enabled);
+bool IsSimPipelined(void);
+
+// Serial mode: run the update now. Pipelined: wait for the update kicked
+// last frame. Either way the simulation is idle on return.
+void RunSimFrame(GameState *live, const InputFrame *input);
+
+// Pipelined mode: start the next update on the simulation thread (input is
+// copied). Does nothing in serial mode.
+void KickSimFrame(GameState *live, const InputFrame *input);
+
+// Stop the simulation thread (waits for the frame in flight)
+void ShutdownSimPipeline(void);
+
+// Duration of the last completed update
+uint64_t GetLastSimNs(void);
+
+#endif // PIPELINE_H
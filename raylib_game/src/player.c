@@ -16,6 +16,19 @@ static float Clampf(float value, float min, float max) {
   return value;
 }
 
+// True if the player's footprint overlaps a wall of the loaded level
+static bool IsPlayerBlocked(const GameState *game) {
+  const LevelMap *level = &game->level;
+  if (!level->data)
+    return false;
+
+  float x = game->playerPos.x;
+  float z = game->playerPos.z;
+  float r = PLAYER_RADIUS;
+  return IsWallAt(level, x - r, z - r) || IsWallAt(level, x + r, z - r) ||
+         IsWallAt(level, x - r, z + r) || IsWallAt(level, x + r, z + r);
+}
+
 // ==========================================
 // INITIALIZATION
 // ==========================================
@@ -42,11 +55,11 @@ void InitPlayer(GameState *game) {
 // UPDATE
 // ==========================================
 
-void UpdatePlayer(GameState *game) {
-  float dt = GetFrameTime();
+void UpdatePlayer(GameState *game, const InputFrame *input) {
+  float dt = input->dt;
 
   // --- MOUSE LOOK ---
-  Vector2 mouseDelta = GetMouseDelta();
+  Vector2 mouseDelta = input->mouseDelta;
 
   game->playerYaw -= mouseDelta.x * MOUSE_SENSITIVITY;
   game->playerPitch -= mouseDelta.y * MOUSE_SENSITIVITY;
@@ -61,19 +74,19 @@ void UpdatePlayer(GameState *game) {
 
   Vector3 moveDir = {0.0f, 0.0f, 0.0f};
 
-  if (IsKeyDown(KEY_W)) {
+  if (IsInputHeld(input, INPUT_MOVE_FORWARD)) {
     moveDir.x += forward.x;
     moveDir.z += forward.z;
   }
-  if (IsKeyDown(KEY_S)) {
+  if (IsInputHeld(input, INPUT_MOVE_BACK)) {
     moveDir.x -= forward.x;
     moveDir.z -= forward.z;
   }
-  if (IsKeyDown(KEY_A)) {
+  if (IsInputHeld(input, INPUT_MOVE_LEFT)) {
     moveDir.x += right.x;
     moveDir.z += right.z;
   }
-  if (IsKeyDown(KEY_D)) {
+  if (IsInputHeld(input, INPUT_MOVE_RIGHT)) {
     moveDir.x -= right.x;
     moveDir.z -= right.z;
   }
@@ -85,9 +98,15 @@ void UpdatePlayer(GameState *game) {
     moveDir.z /= len;
   }
 
-  // Apply movement
-  game->playerPos.x += moveDir.x * PLAYER_SPEED * dt;
-  game->playerPos.z += moveDir.z * PLAYER_SPEED * dt;
+  // Apply movement (one axis at a time so walls can be slid along)
+  float stepX = moveDir.x * PLAYER_SPEED * dt;
+  float stepZ = moveDir.z * PLAYER_SPEED * dt;
+  game->playerPos.x += stepX;
+  if (IsPlayerBlocked(game))
+    game->playerPos.x -= stepX;
+  game->playerPos.z += stepZ;
+  if (IsPlayerBlocked(game))
+    game->playerPos.z -= stepZ;
 
   // --- GRAVITY ---
   if (!game->isGrounded) {
@@ -120,6 +139,10 @@ void UpdatePlayer(GameState *game) {
 // ==========================================
 
 void CheckPlayerCollisions(GameState *game) {
+  // Level walls (out of bounds counts as wall) already blocked movement
+  if (game->level.data)
+    return;
+
   float halfArena =
       (ARENA_SIZE / 2.0f) - 1.0f; // Leave margin for wall thickness
 
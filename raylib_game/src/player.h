@@ -8,12 +8,13 @@
 #define PLAYER_H
 
 #include "game.h"
+#include "input.h"
 
 // Initialize player position and camera
 void InitPlayer(GameState *game);
 
 // Update player movement and camera from input
-void UpdatePlayer(GameState *game);
+void UpdatePlayer(GameState *game, const InputFrame *input);
 
 // Check and resolve wall collisions
 void CheckPlayerCollisions(GameState *game);
@@ -0,0 +1,344 @@
+/**
+ * Kitchen Knight - Scoped Profiler Implementation
+ * ===============================================
+ * Each thread gets a single-producer ring the first time it records while
+ * the profiler is on; the main thread is the only consumer. Collected zones
+ * go into a fixed history (for traces) and the current frame's list (for
+ * the overlay). Rings are never reused, so a thread that exits keeps its
+ * slot; once PROFILE_MAX_THREADS have registered, new threads go unrecorded.
+ */
+
+#include "profiler.h"
+#include "raylib.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#define PROFILE_RING_MASK (PROFILE_RING_SIZE - 1)
+#define PROFILE_HISTORY 65536     // Zones kept for traces (power of two)
+#define PROFILE_FRAME_EVENTS 2048 // Zones shown in the overlay
+#define PROFILE_NAME_MAX 32
+
+// Overlay layout
+#define OVERLAY_LANE_HEIGHT 14
+#define OVERLAY_LABEL_WIDTH 70
+#define OVERLAY_MAX_DEPTH 6
+
+typedef struct {
+  const char *name;
+  uint64_t start;
+  uint32_t durationNs;
+  uint16_t depth;
+  uint16_t thread; // Ring index
+} ProfileEvent;
+
+typedef struct {
+  ProfileEvent slots[PROFILE_RING_SIZE];
+  atomic_uint head; // Written by the owning thread
+  atomic_uint tail; // Written by the main thread
+  atomic_uint dropped;
+  uint16_t index;
+  char name[PROFILE_NAME_MAX];
+} ProfileRing;
+
+atomic_bool profilerEnabled = false;
+
+static ProfileRing *_Atomic rings[PROFILE_MAX_THREADS];
+static atomic_int ringCount = 0;
+
+// Per thread
+static THREAD_LOCAL ProfileRing *localRing = NULL;
+static THREAD_LOCAL bool localRingFailed = false;
+static THREAD_LOCAL int localDepth = 0;
+static THREAD_LOCAL char localName[PROFILE_NAME_MAX];
+
+// Main thread only
+static ProfileEvent history[PROFILE_HISTORY];
+static uint64_t historyCount = 0; // Total ever collected
+static ProfileEvent frameEvents[PROFILE_FRAME_EVENTS];
+static int frameEventCount = 0;
+static uint64_t frameStart = 0;   // Start of the frame being recorded
+static uint64_t overlayStart = 0; // Span of the frame the overlay shows
+static uint64_t overlayEnd = 0;
+static unsigned droppedTotal = 0;
+
+// ==========================================
+// RECORDING (any thread)
+// ==========================================
+
+static ProfileRing *RegisterThread(void) {
+  int index = atomic_fetch_add(&ringCount, 1);
+  ProfileRing *ring = NULL;
+  if (index < PROFILE_MAX_THREADS)
+    ring = calloc(1, sizeof(ProfileRing));
+  if (!ring) {
+    localRingFailed = true;
+    return NULL;
+  }
+
+  ring->index = (uint16_t)index;
+  if (localName[0])
+    memcpy(ring->name, localName, sizeof(ring->name));
+  else
+    snprintf(ring->name, sizeof(ring->name), "Thread %d", index);
+  atomic_store_explicit(&rings[index], ring, memory_order_release);
+  return ring;
+}
+
+uint64_t StartProfileZone(void) {
+  localDepth++;
+  return GetTimestampNs();
+}
+
+void FinishProfileZone(const ProfileZone *zone) {
+  uint64_t end = GetTimestampNs();
+  int depth = localDepth--; // Outermost zone is depth 1
+
+  ProfileRing *ring = localRing;
+  if (!ring) {
+    if (localRingFailed)
+      return;
+    ring = localRing = RegisterThread();
+    if (!ring)
+      return;
+  }
+
+  unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  if (head - tail >= PROFILE_RING_SIZE) {
+    atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    return;
+  }
+
+  uint64_t duration = end - zone->start;
+  ring->slots[head & PROFILE_RING_MASK] = (ProfileEvent){
+      .name = zone->name,
+      .start = zone->start,
+      .durationNs = duration > UINT32_MAX ? UINT32_MAX : (uint32_t)duration,
+      .depth = (uint16_t)depth,
+      .thread = ring->index};
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void SetProfileThreadName(const char *name) {
+  snprintf(localName, sizeof(localName), "%s", name);
+}
+
+// ==========================================
+// CONTROL (main thread)
+// ==========================================
+
+void SetProfilerEnabled(bool enabled) {
+  atomic_store_explicit(&profilerEnabled, enabled, memory_order_relaxed);
+  printf("[Profiler] %s\n", enabled ? "Enabled" : "Disabled");
+}
+
+bool IsProfilerEnabled(void) {
+  return atomic_load_explicit(&profilerEnabled, memory_order_relaxed);
+}
+
+void BeginProfileFrame(void) {
+  uint64_t now = GetTimestampNs();
+  frameEventCount = 0;
+  droppedTotal = 0;
+
+  int count = atomic_load_explicit(&ringCount, memory_order_acquire);
+  if (count > PROFILE_MAX_THREADS)
+    count = PROFILE_MAX_THREADS;
+  for (int r = 0; r < count; r++) {
+    ProfileRing *ring = atomic_load_explicit(&rings[r], memory_order_acquire);
+    if (!ring)
+      continue; // Claimed but not published yet
+
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    for (; tail != head; tail++) {
+      const ProfileEvent *event = &ring->slots[tail & PROFILE_RING_MASK];
+      history[historyCount++ & (PROFILE_HISTORY - 1)] = *event;
+      if (frameEventCount < PROFILE_FRAME_EVENTS)
+        frameEvents[frameEventCount++] = *event;
+    }
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    droppedTotal +=
+        atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+  }
+
+  overlayStart = frameStart ? frameStart : now;
+  overlayEnd = now;
+  frameStart = now;
+}
+
+static int CompareTotals(const void *a, const void *b) {
+  uint64_t x = ((const ProfileZoneTotal *)a)->totalNs;
+  uint64_t y = ((const ProfileZoneTotal *)b)->totalNs;
+  return (x < y) - (x > y);
+}
+
+int GetProfileFrameTotals(ProfileZoneTotal *totals, int maxTotals) {
+  int count = 0;
+  for (int i = 0; i < frameEventCount; i++) {
+    const ProfileEvent *event = &frameEvents[i];
+    int t = 0;
+    while (t < count && totals[t].name != event->name &&
+           strcmp(totals[t].name, event->name) != 0)
+      t++;
+    if (t == count) {
+      if (count == maxTotals)
+        continue;
+      totals[count++] = (ProfileZoneTotal){event->name, 0, 0};
+    }
+    totals[t].totalNs += event->durationNs;
+    totals[t].calls++;
+  }
+  qsort(totals, (size_t)count, sizeof(ProfileZoneTotal), CompareTotals);
+  return count;
+}
+
+// ==========================================
+// OVERLAY
+// ==========================================
+
+static Color ZoneColor(const char *name) {
+  uint32_t hash = 2166136261u;
+  for (const char *c = name; *c; c++)
+    hash = (hash ^ (uint8_t)*c) * 16777619u;
+  return ColorFromHSV((float)(hash % 360), 0.55f, 0.85f);
+}
+
+int DrawProfilerOverlay(int x, int y, int width) {
+  if (!IsProfilerEnabled())
+    return 0;
+
+  // Lanes: each thread that recorded this frame, one row per depth
+  int laneOfThread[PROFILE_MAX_THREADS];
+  int depthOfThread[PROFILE_MAX_THREADS] = {0};
+  for (int i = 0; i < frameEventCount; i++) {
+    int t = frameEvents[i].thread;
+    int depth = frameEvents[i].depth < OVERLAY_MAX_DEPTH
+                    ? frameEvents[i].depth
+                    : OVERLAY_MAX_DEPTH;
+    if (depth > depthOfThread[t])
+      depthOfThread[t] = depth;
+  }
+  int lanes = 0;
+  for (int t = 0; t < PROFILE_MAX_THREADS; t++) {
+    laneOfThread[t] = lanes;
+    lanes += depthOfThread[t];
+  }
+
+  double span = (double)(overlayEnd - overlayStart);
+  int barX = x + OVERLAY_LABEL_WIDTH;
+  int barWidth = width - OVERLAY_LABEL_WIDTH;
+  int height = 20 + lanes * OVERLAY_LANE_HEIGHT;
+  DrawRectangle(x, y, width, height, ColorAlpha(BLACK, 0.7f));
+  DrawText(TextFormat("Profiler: frame %.2f ms, %d zones, %u dropped "
+                      "(F3 hide, F4 trace)",
+                      span / 1e6, frameEventCount, droppedTotal),
+           x + 4, y + 4, 10, RAYWHITE);
+  if (span <= 0.0)
+    return height;
+
+  for (int t = 0; t < PROFILE_MAX_THREADS; t++) {
+    if (!depthOfThread[t])
+      continue;
+    ProfileRing *ring = atomic_load_explicit(&rings[t], memory_order_acquire);
+    int laneY = y + 20 + laneOfThread[t] * OVERLAY_LANE_HEIGHT;
+    DrawText(ring ? ring->name : "?", x + 4, laneY + 2, 10, LIGHTGRAY);
+  }
+
+  for (int i = 0; i < frameEventCount; i++) {
+    const ProfileEvent *event = &frameEvents[i];
+    if (event->depth < 1 || event->depth > OVERLAY_MAX_DEPTH)
+      continue;
+
+    // Clip zones that began in an earlier frame (the sim thread's, when
+    // pipelined)
+    double begin = (double)event->start - (double)overlayStart;
+    double end = begin + event->durationNs;
+    if (begin < 0.0)
+      begin = 0.0;
+    if (end > span)
+      end = span;
+    if (end <= begin)
+      continue;
+
+    int left = barX + (int)(begin / span * barWidth);
+    int right = barX + (int)(end / span * barWidth);
+    if (right <= left)
+      right = left + 1;
+    int laneY = y + 20 +
+                (laneOfThread[event->thread] + event->depth - 1) *
+                    OVERLAY_LANE_HEIGHT;
+
+    DrawRectangle(left, laneY, right - left, OVERLAY_LANE_HEIGHT - 1,
+                  ZoneColor(event->name));
+    const char *label =
+        TextFormat("%s %.2f", event->name, event->durationNs / 1e6);
+    if (MeasureText(label, 10) < right - left - 4)
+      DrawText(label, left + 2, laneY + 2, 10, BLACK);
+  }
+  return height;
+}
+
+// ==========================================
+// CHROME TRACE
+// ==========================================
+
+bool WriteProfileTrace(const char *path) {
+  uint64_t count = historyCount < PROFILE_HISTORY ? historyCount
+                                                  : PROFILE_HISTORY;
+  if (count == 0) {
+    printf("[Profiler] Nothing recorded yet (enable with F3)\n");
+    return false;
+  }
+
+  FILE *file = fopen(path, "w");
+  if (!file) {
+    printf("[Profiler] ERROR: Could not create %s\n", path);
+    return false;
+  }
+
+  // Timestamps in microseconds from the oldest zone kept
+  uint64_t first = historyCount - count;
+  uint64_t origin = UINT64_MAX;
+  for (uint64_t i = first; i < historyCount; i++) {
+    uint64_t start = history[i & (PROFILE_HISTORY - 1)].start;
+    if (start < origin)
+      origin = start;
+  }
+
+  fprintf(file, "{\"traceEvents\":[\n");
+  int threads = atomic_load_explicit(&ringCount, memory_order_acquire);
+  if (threads > PROFILE_MAX_THREADS)
+    threads = PROFILE_MAX_THREADS;
+  for (int t = 0; t < threads; t++) {
+    ProfileRing *ring = atomic_load_explicit(&rings[t], memory_order_acquire);
+    if (!ring)
+      continue;
+    fprintf(file,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}},\n",
+            t, ring->name);
+  }
+  for (uint64_t i = first; i < historyCount; i++) {
+    const ProfileEvent *event = &history[i & (PROFILE_HISTORY - 1)];
+    fprintf(file,
+            "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+            "\"ts\":%.3f,\"dur\":%.3f}%s\n",
+            event->name, event->thread, (event->start - origin) / 1e3,
+            event->durationNs / 1e3, i + 1 < historyCount ? "," : "");
+  }
+  fprintf(file, "]}\n");
+  fclose(file);
+
+  printf("[Profiler] Wrote %llu zones to %s\n", (unsigned long long)count,
+         path);
+  return true;
+}
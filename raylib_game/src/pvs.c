@@ -0,0 +1,448 @@
+/**
+ * Kitchen Knight - Potentially Visible Set Implementation
+ * =======================================================
+ * Each row is the union of recursive shadowcasting (8 octants) from the
+ * centers of the cell and its open neighbours, grown by one cell. That
+ * covers a camera anywhere in the cell, and anything poking a little way
+ * out of the cell it stands in. Rows are built in parallel; work per row
+ * is proportional to what it sees, not to the map.
+ *
+ * File layout, all little-endian:
+ *   "KPVS" version width height mapHash(u64) rleSize
+ *   rowOffset[width * height + 1] (u32) rle[rleSize]
+ */
+
+#include "pvs.h"
+#include "jobs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PVS_MAGIC "KPVS"
+#define PVS_VERSION 1u
+#define PVS_JOB_GRAIN 64 // Rows per job chunk
+
+// One worker's row in progress and the rows it has finished
+typedef struct {
+  uint8_t *mark; // Per cell: in the row being built
+  int *cells;    // Marked cells, in marking order
+  int cellCount;
+  uint8_t *out; // Encoded rows
+  size_t outSize;
+  size_t outCapacity;
+  bool failed;
+} PVSScratch;
+
+typedef struct {
+  const LevelMap *map;
+  PVSScratch scratch[JOB_MAX_WORKERS];
+  uint8_t *rowWorker;  // Which scratch holds each row
+  size_t *rowStart;    // Where in it
+  uint32_t *rowLength; // Bytes
+} PVSBuild;
+
+// Transforms from octant coordinates (dx, dy) to map (x, z)
+static const int octants[8][4] = {
+    {1, 0, 0, -1}, {0, 1, -1, 0}, {0, -1, -1, 0}, {-1, 0, 0, -1},
+    {-1, 0, 0, 1}, {0, -1, 1, 0}, {0, 1, 1, 0},   {1, 0, 0, 1},
+};
+
+static inline bool IsWall(const LevelMap *map, int x, int z) {
+  return GetCell(map, x, z) == CELL_WALL; // Outside the map counts
+}
+
+static inline void Mark(PVSScratch *s, int cell) {
+  if (!s->mark[cell]) {
+    s->mark[cell] = 1;
+    s->cells[s->cellCount++] = cell;
+  }
+}
+
+// ==========================================
+// SHADOWCASTING
+// ==========================================
+
+// Marks what (cx, cz) sees in one octant, from row onwards, between the
+// slopes start (inclusive, larger) and end
+static void CastLight(PVSScratch *s, const LevelMap *map, int cx, int cz,
+                      int row, float start, float end, const int *t) {
+  if (start < end)
+    return;
+  int radius = map->width > map->height ? map->width : map->height;
+  float nextStart = start;
+  for (int j = row; j <= radius; j++) {
+    int dy = -j;
+    bool blocked = false;
+    for (int dx = -j; dx <= 0; dx++) {
+      float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+      float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+      if (start < rightSlope)
+        continue;
+      if (end > leftSlope)
+        break;
+
+      int x = cx + dx * t[0] + dy * t[1];
+      int z = cz + dx * t[2] + dy * t[3];
+      bool wall = IsWall(map, x, z);
+      if (x >= 0 && x < map->width && z >= 0 && z < map->height)
+        Mark(s, z * map->width + x);
+
+      if (blocked) {
+        if (wall) {
+          nextStart = rightSlope;
+          continue;
+        }
+        blocked = false;
+        start = nextStart;
+      } else if (wall && j < radius) {
+        // Light past this wall in its own pass, then resume beyond it
+        blocked = true;
+        CastLight(s, map, cx, cz, j + 1, start, leftSlope, t);
+        nextStart = rightSlope;
+      }
+    }
+    if (blocked)
+      break;
+  }
+}
+
+static void MarkVisibleFrom(PVSScratch *s, const LevelMap *map, int x,
+                            int z) {
+  Mark(s, z * map->width + x);
+  for (int o = 0; o < 8; o++)
+    CastLight(s, map, x, z, 1, 1.0f, 0.0f, octants[o]);
+}
+
+// ==========================================
+// ENCODING
+// ==========================================
+
+static bool Reserve(PVSScratch *s, size_t bytes) {
+  if (s->outSize + bytes <= s->outCapacity)
+    return true;
+  size_t capacity = s->outCapacity ? s->outCapacity * 2 : 4096;
+  while (capacity < s->outSize + bytes)
+    capacity *= 2;
+  uint8_t *out = realloc(s->out, capacity);
+  if (!out)
+    return false;
+  s->out = out;
+  s->outCapacity = capacity;
+  return true;
+}
+
+static void PutVarint(PVSScratch *s, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    s->out[s->outSize++] = byte | (value ? 0x80 : 0);
+  } while (value);
+}
+
+static int CompareInt(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+// Runs of the marked cells, then clear them for the next row
+static bool EncodeMarked(PVSScratch *s) {
+  qsort(s->cells, (size_t)s->cellCount, sizeof(int), CompareInt);
+  bool ok = true;
+  int pos = 0;
+  for (int i = 0; i < s->cellCount && ok;) {
+    int first = s->cells[i];
+    int last = first;
+    while (i < s->cellCount && s->cells[i] == last) {
+      last++;
+      i++;
+    }
+    ok = Reserve(s, 10);
+    if (ok) {
+      PutVarint(s, (uint32_t)(first - pos)); // Hidden
+      PutVarint(s, (uint32_t)(last - first)); // Visible
+    }
+    pos = last;
+  }
+  for (int i = 0; i < s->cellCount; i++)
+    s->mark[s->cells[i]] = 0;
+  s->cellCount = 0;
+  return ok;
+}
+
+// ==========================================
+// BUILDING
+// ==========================================
+
+static void BuildRows(void *ctx, int begin, int end, int worker) {
+  PVSBuild *build = ctx;
+  const LevelMap *map = build->map;
+  PVSScratch *s = &build->scratch[worker];
+  int cells = map->width * map->height;
+  if (!s->mark) {
+    s->mark = calloc((size_t)cells, 1);
+    s->cells = malloc(sizeof(int) * (size_t)cells);
+    if (!s->mark || !s->cells)
+      s->failed = true;
+  }
+
+  for (int cell = begin; cell < end && !s->failed; cell++) {
+    int x = cell % map->width;
+    int z = cell / map->width;
+    size_t start = s->outSize;
+    if (IsWall(map, x, z)) {
+      // The camera is never in a wall; don't cull anything if it is
+      for (int i = 0; i < cells; i++)
+        Mark(s, i);
+    } else {
+      for (int nz = z - 1; nz <= z + 1; nz++)
+        for (int nx = x - 1; nx <= x + 1; nx++)
+          if (!IsWall(map, nx, nz))
+            MarkVisibleFrom(s, map, nx, nz);
+
+      // Grow by one cell (walls included) for bounds that straddle cells
+      int seen = s->cellCount;
+      for (int i = 0; i < seen; i++) {
+        int cx = s->cells[i] % map->width;
+        int cz = s->cells[i] / map->width;
+        for (int nz = cz - 1; nz <= cz + 1; nz++)
+          for (int nx = cx - 1; nx <= cx + 1; nx++)
+            if (nx >= 0 && nx < map->width && nz >= 0 && nz < map->height)
+              Mark(s, nz * map->width + nx);
+      }
+    }
+    if (!EncodeMarked(s)) {
+      s->failed = true;
+      break;
+    }
+    build->rowWorker[cell] = (uint8_t)worker;
+    build->rowStart[cell] = start;
+    build->rowLength[cell] = (uint32_t)(s->outSize - start);
+  }
+}
+
+bool BuildLevelPVS(LevelPVS *pvs, const LevelMap *map) {
+  *pvs = (LevelPVS){0};
+  int cells = map->width * map->height;
+  PVSBuild *build = calloc(1, sizeof(PVSBuild));
+  bool ok = build != NULL && cells > 0;
+  if (ok) {
+    build->map = map;
+    build->rowWorker = malloc((size_t)cells);
+    build->rowStart = malloc(sizeof(size_t) * (size_t)cells);
+    build->rowLength = malloc(sizeof(uint32_t) * (size_t)cells);
+    ok = build->rowWorker && build->rowStart && build->rowLength;
+  }
+  if (ok) {
+    ParallelFor(0, cells, PVS_JOB_GRAIN, BuildRows, build);
+    for (int w = 0; w < JOB_MAX_WORKERS; w++)
+      ok = ok && !build->scratch[w].failed;
+  }
+
+  // Stitch the workers' rows together in cell order
+  if (ok) {
+    size_t total = 0;
+    for (int i = 0; i < cells; i++)
+      total += build->rowLength[i];
+    pvs->rowOffset = malloc(sizeof(uint32_t) * ((size_t)cells + 1));
+    pvs->rle = malloc(total ? total : 1);
+    ok = pvs->rowOffset && pvs->rle && total <= UINT32_MAX;
+    uint32_t offset = 0;
+    for (int i = 0; ok && i < cells; i++) {
+      const PVSScratch *s = &build->scratch[build->rowWorker[i]];
+      memcpy(pvs->rle + offset, s->out + build->rowStart[i],
+             build->rowLength[i]);
+      pvs->rowOffset[i] = offset;
+      offset += build->rowLength[i];
+    }
+    if (ok) {
+      pvs->rowOffset[cells] = offset;
+      pvs->rleSize = offset;
+      pvs->width = map->width;
+      pvs->height = map->height;
+      pvs->mapHash = HashLevelMap(map);
+    }
+  }
+
+  if (build) {
+    for (int w = 0; w < JOB_MAX_WORKERS; w++) {
+      free(build->scratch[w].mark);
+      free(build->scratch[w].cells);
+      free(build->scratch[w].out);
+    }
+    free(build->rowWorker);
+    free(build->rowStart);
+    free(build->rowLength);
+    free(build);
+  }
+  if (!ok) {
+    printf("[PVS] ERROR: Out of memory for a %dx%d map\n", map->width,
+           map->height);
+    UnloadLevelPVS(pvs);
+  }
+  return ok;
+}
+
+// ==========================================
+// QUERIES
+// ==========================================
+
+static uint32_t GetVarint(const uint8_t **p, const uint8_t *end) {
+  uint32_t value = 0;
+  for (int shift = 0; *p < end && shift < 32; shift += 7) {
+    uint8_t byte = *(*p)++;
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  return value;
+}
+
+void DecodePVSRow(const LevelPVS *pvs, int cell, uint8_t *visible) {
+  size_t cells = (size_t)pvs->width * pvs->height;
+  memset(visible, 0, cells);
+  const uint8_t *p = pvs->rle + pvs->rowOffset[cell];
+  const uint8_t *end = pvs->rle + pvs->rowOffset[cell + 1];
+  size_t pos = 0;
+  while (p < end && pos < cells) {
+    size_t hidden = GetVarint(&p, end);
+    size_t shown = GetVarint(&p, end);
+    pos += hidden;
+    if (pos >= cells)
+      break;
+    if (shown > cells - pos)
+      shown = cells - pos;
+    memset(visible + pos, 1, shown);
+    pos += shown;
+  }
+}
+
+uint64_t HashLevelMap(const LevelMap *map) {
+  // FNV-1a over the size and the cells
+  uint64_t hash = 1469598103934665603ull;
+  int32_t size[2] = {map->width, map->height};
+  const uint8_t *bytes = (const uint8_t *)size;
+  for (size_t i = 0; i < sizeof(size); i++)
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  size_t cells = (size_t)map->width * map->height;
+  for (size_t i = 0; i < cells; i++)
+    hash = (hash ^ (uint8_t)map->data[i]) * 1099511628211ull;
+  return hash;
+}
+
+// ==========================================
+// FILES
+// ==========================================
+// Byte by byte, so files move between machines and compilers
+
+static void WriteU32(FILE *file, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+typedef struct {
+  const uint8_t *at;
+  const uint8_t *end;
+} Reader;
+
+static bool ReadU32(Reader *r, uint32_t *value) {
+  if (r->end - r->at < 4)
+    return false;
+  const uint8_t *b = r->at;
+  *value = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 |
+           (uint32_t)b[3] << 24;
+  r->at += 4;
+  return true;
+}
+
+bool SaveLevelPVS(const LevelPVS *pvs, const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    printf("[PVS] ERROR: Can't write %s\n", path);
+    return false;
+  }
+  fwrite(PVS_MAGIC, 1, 4, file);
+  WriteU32(file, PVS_VERSION);
+  WriteU32(file, (uint32_t)pvs->width);
+  WriteU32(file, (uint32_t)pvs->height);
+  WriteU32(file, (uint32_t)pvs->mapHash);
+  WriteU32(file, (uint32_t)(pvs->mapHash >> 32));
+  WriteU32(file, pvs->rleSize);
+  int cells = pvs->width * pvs->height;
+  for (int i = 0; i <= cells; i++)
+    WriteU32(file, pvs->rowOffset[i]);
+  fwrite(pvs->rle, 1, pvs->rleSize, file);
+  bool ok = !ferror(file);
+  fclose(file);
+  return ok;
+}
+
+bool LoadLevelPVSFromMemory(LevelPVS *pvs, const unsigned char *data,
+                            size_t size, const LevelMap *map) {
+  *pvs = (LevelPVS){0};
+  Reader r = {data, data + size};
+  uint32_t version = 0, width = 0, height = 0, hashLo = 0, hashHi = 0;
+  uint32_t rleSize = 0;
+  bool ok = size >= 4 && memcmp(data, PVS_MAGIC, 4) == 0;
+  r.at += ok ? 4 : 0;
+  ok = ok && ReadU32(&r, &version) && version == PVS_VERSION &&
+       ReadU32(&r, &width) && ReadU32(&r, &height) &&
+       ReadU32(&r, &hashLo) && ReadU32(&r, &hashHi) && ReadU32(&r, &rleSize);
+  uint64_t hash = (uint64_t)hashHi << 32 | hashLo;
+  ok = ok && (int)width == map->width && (int)height == map->height &&
+       hash == HashLevelMap(map);
+
+  int cells = map->width * map->height;
+  if (ok) {
+    pvs->rowOffset = malloc(sizeof(uint32_t) * ((size_t)cells + 1));
+    pvs->rle = malloc(rleSize ? rleSize : 1);
+    ok = pvs->rowOffset && pvs->rle;
+  }
+  for (int i = 0; ok && i <= cells; i++) {
+    ok = ReadU32(&r, &pvs->rowOffset[i]) && pvs->rowOffset[i] <= rleSize &&
+         (i == 0 || pvs->rowOffset[i] >= pvs->rowOffset[i - 1]);
+  }
+  ok = ok && pvs->rowOffset[cells] == rleSize &&
+       (size_t)(r.end - r.at) >= rleSize;
+  if (!ok) {
+    UnloadLevelPVS(pvs);
+    return false;
+  }
+  memcpy(pvs->rle, r.at, rleSize);
+  pvs->width = map->width;
+  pvs->height = map->height;
+  pvs->mapHash = hash;
+  pvs->rleSize = rleSize;
+  return true;
+}
+
+bool LoadLevelPVS(LevelPVS *pvs, const char *path, const LevelMap *map) {
+  *pvs = (LevelPVS){0};
+  FILE *file = fopen(path, "rb");
+  if (!file)
+    return false;
+  uint8_t *data = NULL;
+  long size = -1;
+  if (fseek(file, 0, SEEK_END) == 0)
+    size = ftell(file);
+  if (size > 0 && fseek(file, 0, SEEK_SET) == 0) {
+    data = malloc((size_t)size);
+    if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+      free(data);
+      data = NULL;
+    }
+  }
+  fclose(file);
+
+  bool ok = data && LoadLevelPVSFromMemory(pvs, data, (size_t)size, map);
+  free(data);
+  if (!ok)
+    printf("[PVS] %s doesn't match this level; ignoring it\n", path);
+  return ok;
+}
+
+void UnloadLevelPVS(LevelPVS *pvs) {
+  free(pvs->rowOffset);
+  free(pvs->rle);
+  *pvs = (LevelPVS){0};
+}
@@ -0,0 +1,55 @@
+/**
+ * Kitchen Knight - Potentially Visible Set
+ * ========================================
+ * For every cell of an ASCII level, the cells that could be seen from
+ * somewhere inside it. Walls are the only occluders, so the test is 2D;
+ * each row is a run-length encoded bitset over all cells of the map.
+ * Build it at load, or offline with kk_pvs, which writes it next to the
+ * level as <level>.pvs:
+ *
+ *   if (!LoadLevelPVS(&pvs, "level1.txt.pvs", &map))
+ *     BuildLevelPVS(&pvs, &map);
+ *   DecodePVSRow(&pvs, cameraCell, visible);   // One byte per cell
+ */
+
+#ifndef PVS_H
+#define PVS_H
+
+#include "map_loader.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PVS_FILE_EXTENSION ".pvs"
+
+typedef struct {
+  int width;           // Map cells
+  int height;
+  uint64_t mapHash;    // HashLevelMap of the map it was built from
+  uint32_t *rowOffset; // Per cell, into rle; one extra entry for the end
+  uint8_t *rle;        // Per row: run lengths (LEB128), hidden run first
+  uint32_t rleSize;
+} LevelPVS;
+
+// Conservative: a cell is in the set if it can be seen from the center of
+// the cell or an open neighbour, or touches such a cell. Rows of wall
+// cells see everything. Runs on the job system. Returns false without
+// memory.
+bool BuildLevelPVS(LevelPVS *pvs, const LevelMap *map);
+
+// Returns false if the file is missing, damaged or was built from a
+// different map (pvs stays empty)
+bool LoadLevelPVS(LevelPVS *pvs, const char *path, const LevelMap *map);
+// The same, from the bytes of a .pvs file (copied; data can go after)
+bool LoadLevelPVSFromMemory(LevelPVS *pvs, const unsigned char *data,
+                            size_t size, const LevelMap *map);
+bool SaveLevelPVS(const LevelPVS *pvs, const char *path);
+void UnloadLevelPVS(LevelPVS *pvs);
+
+// Expand cell's row into visible[width * height] (1 = potentially visible)
+void DecodePVSRow(const LevelPVS *pvs, int cell, uint8_t *visible);
+
+// Fingerprint of a map's size and cells, to match a PVS file to its level
+uint64_t HashLevelMap(const LevelMap *map);
+
+#endif // PVS_H
@@ -0,0 +1,291 @@
+/**
+ * Kitchen Knight - Input Recording and Replay Implementation
+ * ==========================================================
+ * File layout, all little-endian:
+ *   "KKRP" version seed simHz frameCount endHash(u64) levelLen level[]
+ *   then per frame: dt mouseX mouseY (f32) held pressed (u32)
+ * frameCount and endHash are patched in when recording stops.
+ */
+
+#include "replay.h"
+#include "enemies/enemy_types.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REPLAY_MAGIC "KKRP"
+#define REPLAY_VERSION 1u
+#define REPLAY_COUNT_OFFSET 16 // frameCount, then endHash
+
+static FILE *recordFile = NULL;
+static uint32_t recordCount = 0;
+
+static FILE *replayFile = NULL;
+static ReplayHeader replayHeader;
+static uint32_t replayIndex = 0;
+
+static FILE *timingFile = NULL;
+static uint32_t timingFrame = 0;
+
+// ==========================================
+// SERIALIZATION
+// ==========================================
+// Byte by byte, so files move between machines and compilers
+
+static void WriteU32(FILE *file, uint32_t value) {
+  uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8),
+                      (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void WriteU64(FILE *file, uint64_t value) {
+  WriteU32(file, (uint32_t)value);
+  WriteU32(file, (uint32_t)(value >> 32));
+}
+
+static void WriteF32(FILE *file, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  WriteU32(file, bits);
+}
+
+static bool ReadU32(FILE *file, uint32_t *value) {
+  uint8_t bytes[4];
+  if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes))
+    return false;
+  *value = (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 |
+           (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+  return true;
+}
+
+static bool ReadU64(FILE *file, uint64_t *value) {
+  uint32_t lo, hi;
+  if (!ReadU32(file, &lo) || !ReadU32(file, &hi))
+    return false;
+  *value = (uint64_t)hi << 32 | lo;
+  return true;
+}
+
+static bool ReadF32(FILE *file, float *value) {
+  uint32_t bits;
+  if (!ReadU32(file, &bits))
+    return false;
+  memcpy(value, &bits, sizeof(bits));
+  return true;
+}
+
+// ==========================================
+// RECORDING
+// ==========================================
+
+bool StartRecording(const char *path, uint32_t seed, const char *level) {
+  if (recordFile)
+    fclose(recordFile);
+  recordFile = fopen(path, "wb");
+  if (!recordFile) {
+    printf("[Replay] ERROR: Could not create %s\n", path);
+    return false;
+  }
+
+  uint32_t levelLen = level ? (uint32_t)strlen(level) : 0;
+  if (levelLen >= REPLAY_LEVEL_MAX)
+    levelLen = REPLAY_LEVEL_MAX - 1;
+
+  fwrite(REPLAY_MAGIC, 1, 4, recordFile);
+  WriteU32(recordFile, REPLAY_VERSION);
+  WriteU32(recordFile, seed);
+  WriteU32(recordFile, SIM_HZ);
+  WriteU32(recordFile, 0); // frameCount, patched on stop
+  WriteU64(recordFile, 0); // endHash, patched on stop
+  WriteU32(recordFile, levelLen);
+  if (levelLen)
+    fwrite(level, 1, levelLen, recordFile);
+
+  recordCount = 0;
+  printf("[Replay] Recording to %s (seed %u)\n", path, seed);
+  return true;
+}
+
+void RecordInputFrame(const InputFrame *input) {
+  if (!recordFile)
+    return;
+  WriteF32(recordFile, input->dt);
+  WriteF32(recordFile, input->mouseDelta.x);
+  WriteF32(recordFile, input->mouseDelta.y);
+  WriteU32(recordFile, input->held);
+  WriteU32(recordFile, input->pressed);
+  recordCount++;
+}
+
+void StopRecording(const GameState *game) {
+  if (!recordFile)
+    return;
+  uint64_t hash = HashGameState(game);
+  fseek(recordFile, REPLAY_COUNT_OFFSET, SEEK_SET);
+  WriteU32(recordFile, recordCount);
+  WriteU64(recordFile, hash);
+  fclose(recordFile);
+  recordFile = NULL;
+  printf("[Replay] Recorded %u frames, end hash %016llx\n", recordCount,
+         (unsigned long long)hash);
+}
+
+bool IsRecording(void) { return recordFile != NULL; }
+
+// ==========================================
+// PLAYBACK
+// ==========================================
+
+bool StartReplay(const char *path, ReplayHeader *header) {
+  if (replayFile)
+    fclose(replayFile);
+  replayFile = fopen(path, "rb");
+  if (!replayFile) {
+    printf("[Replay] ERROR: Could not open %s\n", path);
+    return false;
+  }
+
+  char magic[4];
+  uint32_t version = 0, levelLen = 0;
+  memset(&replayHeader, 0, sizeof(replayHeader));
+  bool ok = fread(magic, 1, 4, replayFile) == 4 &&
+            memcmp(magic, REPLAY_MAGIC, 4) == 0 &&
+            ReadU32(replayFile, &version) && version == REPLAY_VERSION &&
+            ReadU32(replayFile, &replayHeader.seed) &&
+            ReadU32(replayFile, &replayHeader.simHz) &&
+            ReadU32(replayFile, &replayHeader.frameCount) &&
+            ReadU64(replayFile, &replayHeader.endHash) &&
+            ReadU32(replayFile, &levelLen) && levelLen < REPLAY_LEVEL_MAX &&
+            fread(replayHeader.level, 1, levelLen, replayFile) == levelLen;
+  if (!ok) {
+    printf("[Replay] ERROR: %s is not a version %u replay\n", path,
+           REPLAY_VERSION);
+    fclose(replayFile);
+    replayFile = NULL;
+    return false;
+  }
+
+  // Steps of another length take different paths through the same input
+  if (replayHeader.simHz != SIM_HZ) {
+    printf("[Replay] WARNING: Recorded at %u Hz, simulating at %d Hz; "
+           "expect a desync\n",
+           replayHeader.simHz, SIM_HZ);
+  }
+
+  replayIndex = 0;
+  *header = replayHeader;
+  printf("[Replay] Playing %s: %u frames, seed %u%s%s\n", path,
+         replayHeader.frameCount, replayHeader.seed,
+         levelLen ? ", level " : "", replayHeader.level);
+  return true;
+}
+
+bool NextReplayFrame(InputFrame *input) {
+  if (!replayFile || replayIndex >= replayHeader.frameCount)
+    return false;
+
+  InputFrame frame = {0};
+  bool ok = ReadF32(replayFile, &frame.dt) &&
+            ReadF32(replayFile, &frame.mouseDelta.x) &&
+            ReadF32(replayFile, &frame.mouseDelta.y) &&
+            ReadU32(replayFile, &frame.held) &&
+            ReadU32(replayFile, &frame.pressed);
+  if (!ok) {
+    printf("[Replay] WARNING: File ends after %u of %u frames\n",
+           replayIndex, replayHeader.frameCount);
+    return false;
+  }
+
+  replayIndex++;
+  *input = frame;
+  return true;
+}
+
+bool FinishReplay(const GameState *game) {
+  if (!replayFile)
+    return true;
+  fclose(replayFile);
+  replayFile = NULL;
+
+  uint64_t hash = HashGameState(game);
+  bool complete = replayIndex == replayHeader.frameCount;
+  bool match = replayHeader.endHash == 0 ||
+               (complete && hash == replayHeader.endHash);
+  if (replayHeader.endHash == 0) {
+    printf("[Replay] Played %u frames (recording has no end hash)\n",
+           replayIndex);
+  } else if (match) {
+    printf("[Replay] Played %u frames, end state matches (%016llx)\n",
+           replayIndex, (unsigned long long)hash);
+  } else {
+    printf("[Replay] DESYNC after %u/%u frames: end hash %016llx, "
+           "recorded %016llx\n",
+           replayIndex, replayHeader.frameCount, (unsigned long long)hash,
+           (unsigned long long)replayHeader.endHash);
+  }
+  return match;
+}
+
+bool IsReplaying(void) { return replayFile != NULL; }
+
+// ==========================================
+// TIMINGS
+// ==========================================
+
+bool StartTimingLog(const char *path) {
+  if (timingFile)
+    fclose(timingFile);
+  timingFile = fopen(path, "w");
+  if (!timingFile) {
+    printf("[Replay] ERROR: Could not create %s\n", path);
+    return false;
+  }
+  fprintf(timingFile, "frame,sim_ms,render_ms\n");
+  timingFrame = 0;
+  return true;
+}
+
+void LogFrameTiming(uint64_t simNs, uint64_t renderNs) {
+  if (!timingFile)
+    return;
+  fprintf(timingFile, "%u,%.4f,%.4f\n", timingFrame++, simNs / 1e6,
+          renderNs / 1e6);
+}
+
+void StopTimingLog(void) {
+  if (!timingFile)
+    return;
+  fclose(timingFile);
+  timingFile = NULL;
+  printf("[Replay] Wrote timings for %u frames\n", timingFrame);
+}
+
+// ==========================================
+// STATE HASH
+// ==========================================
+
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+  const uint8_t *bytes = data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+uint64_t HashGameState(const GameState *game) {
+  uint64_t hash = 14695981039346656037ull;
+  hash = HashBytes(hash, &game->playerPos, sizeof(game->playerPos));
+  hash = HashBytes(hash, &game->playerYaw, sizeof(game->playerYaw));
+  hash = HashBytes(hash, &game->playerPitch, sizeof(game->playerPitch));
+  hash = HashBytes(hash, &game->playerHP, sizeof(game->playerHP));
+  hash = HashBytes(hash, &game->enemyPos, sizeof(game->enemyPos));
+  hash = HashBytes(hash, &game->enemyHP, sizeof(game->enemyHP));
+  hash = HashBytes(hash, &activeEnemyCount, sizeof(activeEnemyCount));
+
+  size_t n = (size_t)enemyHighWater;
+  hash = HashBytes(hash, enemyPool.posX, n * sizeof(float));
+  hash = HashBytes(hash, enemyPool.posZ, n * sizeof(float));
+  hash = HashBytes(hash, enemyPool.hp, n * sizeof(int));
+  hash = HashBytes(hash, enemyPool.state, n * sizeof(uint8_t));
+  return hash;
+}
@@ -0,0 +1,57 @@
+/**
+ * Kitchen Knight - Input Recording and Replay
+ * ===========================================
+ * Records the InputFrame stream (buttons, mouse motion and frame time) to a
+ * file and plays it back. The simulation only sees InputFrames, steps at a
+ * fixed rate and seeds raylib's RNG from the header, so a replay reruns a
+ * session bit for bit; the end-state hash stored at the end of recording
+ * is checked when playback finishes. Per-frame timings can be written to a
+ * CSV alongside, for diffing builds.
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game.h"
+#include "input.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define REPLAY_LEVEL_MAX 256 // Level path stored in the header
+
+typedef struct {
+  uint32_t seed;      // For SetRandomSeed, before InitGame
+  uint32_t simHz;     // SIM_HZ of the recording build
+  uint32_t frameCount;
+  uint64_t endHash;   // HashGameState after the last frame, 0 if unknown
+  char level[REPLAY_LEVEL_MAX]; // Empty for the arena
+} ReplayHeader;
+
+// --- Recording ---
+// level may be NULL. Returns false if the file can't be created.
+bool StartRecording(const char *path, uint32_t seed, const char *level);
+void RecordInputFrame(const InputFrame *input);
+// Finish the file, storing the final state's hash for replays to check
+void StopRecording(const GameState *game);
+bool IsRecording(void);
+
+// --- Playback ---
+// Returns false (with a message) for a missing or malformed file
+bool StartReplay(const char *path, ReplayHeader *header);
+// Next recorded frame; false once the replay is exhausted
+bool NextReplayFrame(InputFrame *input);
+// Compare the final state against the recording and close. Returns true on
+// a match (or when the recording has no hash).
+bool FinishReplay(const GameState *game);
+bool IsReplaying(void);
+
+// --- Timings ---
+// CSV of frame, sim_ms, render_ms; render_ms is 0 when headless
+bool StartTimingLog(const char *path);
+void LogFrameTiming(uint64_t simNs, uint64_t renderNs);
+void StopTimingLog(void);
+
+// FNV-1a over player and enemy pool state, for desync checks
+uint64_t HashGameState(const GameState *game);
+
+#endif // REPLAY_H
@@ -0,0 +1,80 @@
+/**
+ * Kitchen Knight - SIMD Support Implementation
+ * ============================================
+ * CPU feature detection for the vectorized update kernels.
+ */
+
+#include "simd.h"
+
+#if KK_HAVE_AVX2 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+static SimdLevel detectedLevel = SIMD_SCALAR;
+static SimdLevel activeLevel = SIMD_SCALAR;
+static bool detected = false;
+
+// ==========================================
+// DETECTION
+// ==========================================
+
+static bool CpuSupportsAVX2(void) {
+#if !KK_HAVE_AVX2
+  return false;
+#elif defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx)
+    return false;
+  // The OS must save YMM registers on context switch
+  if ((_xgetbv(0) & 0x6) != 0x6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+
+static void DetectSimdLevel(void) {
+  if (detected)
+    return;
+  detectedLevel = SIMD_SCALAR;
+#if KK_HAVE_SSE2
+  detectedLevel = SIMD_SSE2;
+#endif
+  if (CpuSupportsAVX2())
+    detectedLevel = SIMD_AVX2;
+  activeLevel = detectedLevel;
+  detected = true;
+}
+
+// ==========================================
+// QUERIES
+// ==========================================
+
+SimdLevel GetSimdLevel(void) {
+  DetectSimdLevel();
+  return activeLevel;
+}
+
+void SetSimdLevel(SimdLevel level) {
+  DetectSimdLevel();
+  activeLevel = level > detectedLevel ? detectedLevel : level;
+}
+
+const char *GetSimdLevelName(SimdLevel level) {
+  switch (level) {
+  case SIMD_AVX2:
+    return "AVX2";
+  case SIMD_SSE2:
+    return "SSE2";
+  default:
+    return "scalar";
+  }
+}
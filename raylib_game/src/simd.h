@@ -0,0 +1,46 @@
+/**
+ * Kitchen Knight - SIMD Support
+ * =============================
+ * Compile-time SIMD availability and runtime instruction set selection.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stdbool.h>
+
+// SSE2 is the x86-64 baseline, so it is always compiled in there
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KK_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define KK_HAVE_SSE2 0
+#endif
+
+// AVX2 kernels are compiled per-function and picked at runtime, so the
+// binary still runs on CPUs without AVX2
+#if KK_HAVE_SSE2
+#define KK_HAVE_AVX2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define KK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KK_TARGET_AVX2
+#endif
+#else
+#define KK_HAVE_AVX2 0
+#define KK_TARGET_AVX2
+#endif
+
+typedef enum { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 } SimdLevel;
+
+// Best level supported by this CPU (or the override, if lower)
+SimdLevel GetSimdLevel(void);
+
+// Force a lower level (benchmarks); clamped to what the CPU supports
+void SetSimdLevel(SimdLevel level);
+
+const char *GetSimdLevelName(SimdLevel level);
+
+#endif // SIMD_H
@@ -0,0 +1,300 @@
+/**
+ * Kitchen Knight - Spatial Grid Implementation
+ * ============================================
+ * Enemies are counting-sorted into hashed XZ cells once per frame, so the
+ * grid is unbounded (works for any level size) and rebuild cost is linear.
+ * Each entry keeps its cell coordinates, which lets queries reject entries
+ * that only share a bucket through a hash collision.
+ */
+
+#include "spatial_grid.h"
+#include "enemies/enemy_types.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// Bucket table grows with the live enemy count (~2 buckets per enemy)
+#define MIN_TABLE_SIZE 64
+#define MAX_TABLE_SIZE (MAX_ENEMIES * 2)
+
+static int tableSize = MIN_TABLE_SIZE;
+static int tableMask = MIN_TABLE_SIZE - 1;
+static int bucketStart[MAX_TABLE_SIZE + 1];
+static int bucketCursor[MAX_TABLE_SIZE];
+
+// Entries sorted by bucket, with positions copied in for cache-friendly
+// queries
+static int entryCount = 0;
+static int entrySlot[MAX_ENEMIES];
+static int entryCellX[MAX_ENEMIES];
+static int entryCellZ[MAX_ENEMIES];
+static float entryX[MAX_ENEMIES];
+static float entryY[MAX_ENEMIES];
+static float entryZ[MAX_ENEMIES];
+static float entryRadius[MAX_ENEMIES];
+static float maxEntryRadius = 0.0f;
+
+// Rebuild scratch
+static int liveSlots[MAX_ENEMIES];
+static int liveBucket[MAX_ENEMIES];
+
+// ==========================================
+// HELPERS
+// ==========================================
+
+static inline int CellCoord(float v) {
+  return (int)floorf(v / SPATIAL_CELL_SIZE);
+}
+
+static inline int HashCell(int cx, int cz) {
+  uint32_t h = ((uint32_t)cx * 73856093u) ^ ((uint32_t)cz * 19349663u);
+  return (int)(h & (uint32_t)tableMask);
+}
+
+// Enemies can die between the rebuild and a query (several hits per frame)
+static inline bool EntryAlive(int e) {
+  int slot = entrySlot[e];
+  return (enemyPool.flags[slot] & ENEMY_FLAG_ACTIVE) &&
+         enemyPool.state[slot] != AI_DEAD;
+}
+
+// Ray vs sphere, ray direction normalized. Hits behind the origin are
+// rejected; from inside the sphere the exit distance is reported.
+static bool RaySphere(Ray ray, float cx, float cy, float cz, float radius,
+                      float *t) {
+  float lx = cx - ray.position.x;
+  float ly = cy - ray.position.y;
+  float lz = cz - ray.position.z;
+  float tca =
+      lx * ray.direction.x + ly * ray.direction.y + lz * ray.direction.z;
+  float l2 = lx * lx + ly * ly + lz * lz;
+  float r2 = radius * radius;
+  float d2 = l2 - tca * tca;
+  if (d2 > r2)
+    return false;
+
+  float thc = sqrtf(r2 - d2);
+  float hit = (l2 < r2) ? tca + thc : tca - thc;
+  if (hit < 0.0f)
+    return false;
+  *t = hit;
+  return true;
+}
+
+// ==========================================
+// REBUILD
+// ==========================================
+
+void RebuildEnemyGrid(void) {
+  // Gather live slots and size the table
+  int live = 0;
+  for (int k = 0; k < activeEnemyCount; k++) {
+    int i = enemyPool.activeList[k];
+    if (enemyPool.state[i] != AI_DEAD)
+      liveSlots[live++] = i;
+  }
+
+  tableSize = MIN_TABLE_SIZE;
+  while (tableSize < live * 2 && tableSize < MAX_TABLE_SIZE)
+    tableSize <<= 1;
+  tableMask = tableSize - 1;
+
+  // Counting sort by bucket
+  memset(bucketStart, 0, sizeof(int) * (size_t)(tableSize + 1));
+  maxEntryRadius = 0.0f;
+  for (int k = 0; k < live; k++) {
+    int slot = liveSlots[k];
+    int bucket = HashCell(CellCoord(enemyPool.posX[slot]),
+                          CellCoord(enemyPool.posZ[slot]));
+    liveBucket[k] = bucket;
+    bucketStart[bucket + 1]++;
+    maxEntryRadius = fmaxf(maxEntryRadius, enemyPool.radius[slot]);
+  }
+  for (int b = 0; b < tableSize; b++) {
+    bucketStart[b + 1] += bucketStart[b];
+    bucketCursor[b] = bucketStart[b];
+  }
+
+  for (int k = 0; k < live; k++) {
+    int slot = liveSlots[k];
+    int e = bucketCursor[liveBucket[k]]++;
+    entrySlot[e] = slot;
+    entryX[e] = enemyPool.posX[slot];
+    entryY[e] = enemyPool.posY[slot];
+    entryZ[e] = enemyPool.posZ[slot];
+    entryRadius[e] = enemyPool.radius[slot];
+    entryCellX[e] = CellCoord(entryX[e]);
+    entryCellZ[e] = CellCoord(entryZ[e]);
+  }
+  entryCount = live;
+}
+
+int GetEnemyGridCount(void) { return entryCount; }
+
+// ==========================================
+// RANGE QUERIES
+// ==========================================
+
+typedef bool (*EntryTest)(int entry, const void *ctx);
+
+// Visit every entry in cells [x0..x1] x [z0..z1]. Falls back to a linear
+// scan when the range covers more cells than there are buckets.
+static int VisitCellRange(int x0, int x1, int z0, int z1, EntryTest test,
+                          const void *ctx, int *out, int maxOut) {
+  int found = 0;
+  int64_t cells = (int64_t)(x1 - x0 + 1) * (int64_t)(z1 - z0 + 1);
+
+  if (cells > tableSize) {
+    for (int e = 0; e < entryCount && found < maxOut; e++) {
+      if (EntryAlive(e) && test(e, ctx))
+        out[found++] = entrySlot[e];
+    }
+    return found;
+  }
+
+  for (int cz = z0; cz <= z1; cz++) {
+    for (int cx = x0; cx <= x1; cx++) {
+      int bucket = HashCell(cx, cz);
+      for (int e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++) {
+        if (entryCellX[e] != cx || entryCellZ[e] != cz)
+          continue; // Hash collision from another cell
+        if (!EntryAlive(e) || !test(e, ctx))
+          continue;
+        out[found++] = entrySlot[e];
+        if (found >= maxOut)
+          return found;
+      }
+    }
+  }
+  return found;
+}
+
+typedef struct {
+  Vector3 center;
+  float radius;
+} SphereQuery;
+
+static bool TestSphere(int e, const void *ctx) {
+  const SphereQuery *q = ctx;
+  float dx = entryX[e] - q->center.x;
+  float dy = entryY[e] - q->center.y;
+  float dz = entryZ[e] - q->center.z;
+  float r = q->radius + entryRadius[e];
+  return dx * dx + dy * dy + dz * dz < r * r;
+}
+
+static bool TestBox(int e, const void *ctx) {
+  const BoundingBox *box = ctx;
+  // Closest point on the box to the sphere center
+  float cx = fminf(fmaxf(entryX[e], box->min.x), box->max.x);
+  float cy = fminf(fmaxf(entryY[e], box->min.y), box->max.y);
+  float cz = fminf(fmaxf(entryZ[e], box->min.z), box->max.z);
+  float dx = entryX[e] - cx;
+  float dy = entryY[e] - cy;
+  float dz = entryZ[e] - cz;
+  return dx * dx + dy * dy + dz * dz <= entryRadius[e] * entryRadius[e];
+}
+
+int QueryEnemiesInRadius(Vector3 center, float radius, int *out, int maxOut) {
+  if (entryCount == 0 || maxOut <= 0)
+    return 0;
+
+  // Entries are binned by center, so pad by the largest enemy radius
+  float reach = radius + maxEntryRadius;
+  SphereQuery q = {center, radius};
+  return VisitCellRange(
+      CellCoord(center.x - reach), CellCoord(center.x + reach),
+      CellCoord(center.z - reach), CellCoord(center.z + reach), TestSphere, &q,
+      out, maxOut);
+}
+
+int QueryEnemiesInAABB(BoundingBox box, int *out, int maxOut) {
+  if (entryCount == 0 || maxOut <= 0)
+    return 0;
+
+  float pad = maxEntryRadius;
+  return VisitCellRange(CellCoord(box.min.x - pad), CellCoord(box.max.x + pad),
+                        CellCoord(box.min.z - pad), CellCoord(box.max.z + pad),
+                        TestBox, &box, out, maxOut);
+}
+
+// ==========================================
+// RAY WALK
+// ==========================================
+
+// Test the 3x3 block around a cell: an enemy binned next door can still
+// overlap this one, since radius < SPATIAL_CELL_SIZE.
+static void RaycastCellBlock(Ray ray, int cx, int cz, float *best,
+                             int *bestSlot) {
+  for (int nz = cz - 1; nz <= cz + 1; nz++) {
+    for (int nx = cx - 1; nx <= cx + 1; nx++) {
+      int bucket = HashCell(nx, nz);
+      for (int e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++) {
+        if (entryCellX[e] != nx || entryCellZ[e] != nz)
+          continue;
+        float t;
+        if (RaySphere(ray, entryX[e], entryY[e], entryZ[e], entryRadius[e],
+                      &t) &&
+            t <= *best && EntryAlive(e)) {
+          *best = t;
+          *bestSlot = entrySlot[e];
+        }
+      }
+    }
+  }
+}
+
+bool RaycastEnemies(Ray ray, float maxDistance, int *outIndex,
+                    float *outDistance) {
+  if (entryCount == 0 || !(maxDistance >= 0.0f))
+    return false;
+  if (isinf(maxDistance))
+    maxDistance = 1.0e4f; // Keep the walk bounded
+
+  // 2D DDA over the XZ projection, parameterized by 3D ray distance
+  int cx = CellCoord(ray.position.x);
+  int cz = CellCoord(ray.position.z);
+  float dx = ray.direction.x;
+  float dz = ray.direction.z;
+  int stepX = (dx > 0.0f) - (dx < 0.0f);
+  int stepZ = (dz > 0.0f) - (dz < 0.0f);
+
+  float tDeltaX = stepX ? SPATIAL_CELL_SIZE / fabsf(dx) : INFINITY;
+  float tDeltaZ = stepZ ? SPATIAL_CELL_SIZE / fabsf(dz) : INFINITY;
+  float tMaxX = stepX ? ((float)(cx + (stepX > 0)) * SPATIAL_CELL_SIZE -
+                         ray.position.x) /
+                            dx
+                      : INFINITY;
+  float tMaxZ = stepZ ? ((float)(cz + (stepZ > 0)) * SPATIAL_CELL_SIZE -
+                         ray.position.z) /
+                            dz
+                      : INFINITY;
+
+  float best = maxDistance;
+  int bestSlot = -1;
+  float tEnter = 0.0f;
+
+  // Any hit at distance t lies in a cell entered at or before t, so once
+  // the next cell starts past the best hit nothing closer remains
+  while (tEnter <= best) {
+    RaycastCellBlock(ray, cx, cz, &best, &bestSlot);
+
+    if (tMaxX < tMaxZ) {
+      tEnter = tMaxX;
+      tMaxX += tDeltaX;
+      cx += stepX;
+    } else {
+      tEnter = tMaxZ;
+      tMaxZ += tDeltaZ;
+      cz += stepZ;
+    }
+    if (isinf(tEnter))
+      break; // Vertical ray: a single column of cells
+  }
+
+  if (bestSlot < 0)
+    return false;
+  *outIndex = bestSlot;
+  *outDistance = best;
+  return true;
+}
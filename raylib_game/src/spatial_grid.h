@@ -0,0 +1,36 @@
+/**
+ * Kitchen Knight - Spatial Grid
+ * =============================
+ * Uniform hashed grid over the enemy pool for radius, box and ray queries.
+ */
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+// World units per grid cell (XZ plane). Must stay larger than any enemy
+// radius so a sphere never spans more than one neighbouring cell.
+#define SPATIAL_CELL_SIZE 4.0f
+
+// Rebuild from the enemy pool. Call once per frame after enemies move.
+void RebuildEnemyGrid(void);
+
+// Enemies whose bounding sphere overlaps the query sphere.
+// Returns the number of slot indices written to out (at most maxOut).
+int QueryEnemiesInRadius(Vector3 center, float radius, int *out, int maxOut);
+
+// Enemies whose bounding sphere overlaps the axis-aligned box.
+int QueryEnemiesInAABB(BoundingBox box, int *out, int maxOut);
+
+// Closest enemy hit by the ray within maxDistance (ray.direction must be
+// normalized). Walks grid cells front to back and stops at the first cell
+// beyond the best hit.
+bool RaycastEnemies(Ray ray, float maxDistance, int *outIndex,
+                    float *outDistance);
+
+// Entries in the grid as of the last rebuild
+int GetEnemyGridCount(void);
+
+#endif // SPATIAL_GRID_H
@@ -0,0 +1,400 @@
+/**
+ * Kitchen Knight - Sprite Batcher Implementation
+ * ==============================================
+ * One 40-byte instance per sprite (center, size, texture rectangle, tint),
+ * so sprites sharing an atlas differ only in their instance. The instance
+ * buffer is uploaded once per flush, already grouped and sorted, and each
+ * group's draw points the instance attributes at its own slice of it. The
+ * sort is a stable radix sort over the view depth followed by one pass on
+ * the group, so it stays linear at tens of thousands of sprites.
+ */
+
+#include "sprite_batch.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_CHUNK 1024 // Sprites per rlgl batch check in the fallback
+
+typedef struct {
+  float x, y, z;
+  float height;
+  float u, v, du, dv; // Source rectangle in texture coordinates
+  float width;
+  Color tint;
+} SpriteInstance;
+
+// Quad corners (xy, centered on the sprite) and texture coordinates (zw),
+// counter-clockwise as seen from the camera
+static const float quadCorners[6 * 4] = {
+    -0.5f, -0.5f, 0.0f, 1.0f, // Bottom left
+    0.5f,  -0.5f, 1.0f, 1.0f, // Bottom right
+    0.5f,  0.5f,  1.0f, 0.0f, // Top right
+    -0.5f, -0.5f, 0.0f, 1.0f, // Bottom left
+    0.5f,  0.5f,  1.0f, 0.0f, // Top right
+    -0.5f, 0.5f,  0.0f, 0.0f, // Top left
+};
+
+static const char *spriteVertexShader =
+    "#version 330\n"
+    "in vec4 spriteCorner;\n"     // xy corner, zw texcoord
+    "in vec4 instancePosition;\n" // xyz center, w height
+    "in vec4 instanceSource;\n"   // xy corner, zw size (texcoords)
+    "in float instanceWidth;\n"
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "uniform vec3 cameraRight;\n"
+    "uniform vec3 cameraUp;\n"
+    "out vec2 fragTexCoord;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "  vec3 world = instancePosition.xyz +\n"
+    "               cameraRight * (spriteCorner.x * instanceWidth) +\n"
+    "               cameraUp * (spriteCorner.y * instancePosition.w);\n"
+    "  fragTexCoord = instanceSource.xy +\n"
+    "                 spriteCorner.zw * instanceSource.zw;\n"
+    "  fragColor = instanceColor;\n"
+    "  gl_Position = mvp * vec4(world, 1.0);\n"
+    "}\n";
+
+static const char *spriteFragmentShader =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "  vec4 texel = texture(texture0, fragTexCoord) * fragColor;\n"
+    "  if (texel.a < 0.01) discard;\n" // Keep empty pixels out of depth
+    "  finalColor = texel;\n"
+    "}\n";
+
+// Queued sprites and sort scratch, all sized to capacity
+static SpriteInstance *sprites = NULL;
+static SpriteInstance *sorted = NULL;
+static uint32_t *depthKeys = NULL;
+static uint8_t *groupOf = NULL;
+static uint32_t *order = NULL;
+static uint32_t *orderScratch = NULL;
+static int capacity = 0;
+static int spriteCount = 0;
+
+static Texture2D groupTextures[SPRITE_BATCH_MAX_TEXTURES];
+static int groupCount = 0;
+
+static Camera3D batchCamera;
+static Vector3 cameraRight, cameraUp, cameraForward;
+static int drawCalls = 0;
+
+// Instanced path (GL 3.3+)
+static bool instanced = false;
+static Shader shader = {0};
+static unsigned int vao = 0;
+static unsigned int cornerVbo = 0;
+static unsigned int instanceVbo = 0;
+static int cornerLoc, positionLoc, sourceLoc, widthLoc, colorLoc;
+static int mvpLoc, rightLoc, upLoc;
+
+// ==========================================
+// SETUP
+// ==========================================
+
+// Instance attributes read from the instance at index start onwards
+static void PointInstanceAttributes(int start) {
+  int offset = start * (int)sizeof(SpriteInstance);
+  rlSetVertexAttribute((unsigned)positionLoc, 4, RL_FLOAT, false,
+                       sizeof(SpriteInstance), offset);
+  rlSetVertexAttribute((unsigned)sourceLoc, 4, RL_FLOAT, false,
+                       sizeof(SpriteInstance),
+                       offset + (int)offsetof(SpriteInstance, u));
+  rlSetVertexAttribute((unsigned)widthLoc, 1, RL_FLOAT, false,
+                       sizeof(SpriteInstance),
+                       offset + (int)offsetof(SpriteInstance, width));
+  rlSetVertexAttribute((unsigned)colorLoc, 4, RL_UNSIGNED_BYTE, true,
+                       sizeof(SpriteInstance),
+                       offset + (int)offsetof(SpriteInstance, tint));
+}
+
+static bool LoadInstancing(void) {
+  int version = rlGetVersion();
+  if (version != RL_OPENGL_33 && version != RL_OPENGL_43)
+    return false;
+
+  shader = LoadShaderFromMemory(spriteVertexShader, spriteFragmentShader);
+  if (shader.id == 0 || shader.id == rlGetShaderIdDefault())
+    return false;
+  cornerLoc = GetShaderLocationAttrib(shader, "spriteCorner");
+  positionLoc = GetShaderLocationAttrib(shader, "instancePosition");
+  sourceLoc = GetShaderLocationAttrib(shader, "instanceSource");
+  widthLoc = GetShaderLocationAttrib(shader, "instanceWidth");
+  colorLoc = GetShaderLocationAttrib(shader, "instanceColor");
+  mvpLoc = GetShaderLocation(shader, "mvp");
+  rightLoc = GetShaderLocation(shader, "cameraRight");
+  upLoc = GetShaderLocation(shader, "cameraUp");
+  if (cornerLoc < 0 || positionLoc < 0 || sourceLoc < 0 || widthLoc < 0 ||
+      colorLoc < 0) {
+    UnloadShader(shader);
+    return false;
+  }
+
+  vao = rlLoadVertexArray();
+  rlEnableVertexArray(vao);
+  cornerVbo = rlLoadVertexBuffer(quadCorners, sizeof(quadCorners), false);
+  rlSetVertexAttribute((unsigned)cornerLoc, 4, RL_FLOAT, false, 0, 0);
+  rlEnableVertexAttribute((unsigned)cornerLoc);
+
+  instanceVbo = rlLoadVertexBuffer(
+      NULL, capacity * (int)sizeof(SpriteInstance), true);
+  rlSetVertexAttribute((unsigned)positionLoc, 4, RL_FLOAT, false,
+                       sizeof(SpriteInstance), 0);
+  rlEnableVertexAttribute((unsigned)positionLoc);
+  rlSetVertexAttributeDivisor((unsigned)positionLoc, 1);
+  rlEnableVertexAttribute((unsigned)sourceLoc);
+  rlSetVertexAttributeDivisor((unsigned)sourceLoc, 1);
+  rlEnableVertexAttribute((unsigned)widthLoc);
+  rlSetVertexAttributeDivisor((unsigned)widthLoc, 1);
+  rlEnableVertexAttribute((unsigned)colorLoc);
+  rlSetVertexAttributeDivisor((unsigned)colorLoc, 1);
+  PointInstanceAttributes(0);
+  rlDisableVertexArray();
+  return true;
+}
+
+void InitSpriteBatch(int maxSprites) {
+  UnloadSpriteBatch();
+  capacity = maxSprites > 0 ? maxSprites : 1;
+  sprites = malloc(sizeof(SpriteInstance) * (size_t)capacity);
+  sorted = malloc(sizeof(SpriteInstance) * (size_t)capacity);
+  depthKeys = malloc(sizeof(uint32_t) * (size_t)capacity);
+  groupOf = malloc((size_t)capacity);
+  order = malloc(sizeof(uint32_t) * (size_t)capacity);
+  orderScratch = malloc(sizeof(uint32_t) * (size_t)capacity);
+  if (!sprites || !sorted || !depthKeys || !groupOf || !order ||
+      !orderScratch) {
+    printf("[Sprites] ERROR: Out of memory for %d sprites\n", capacity);
+    UnloadSpriteBatch();
+    return;
+  }
+
+  instanced = LoadInstancing();
+  printf("[Sprites] %d sprites per batch, %s\n", capacity,
+         instanced ? "instanced" : "streamed (no GL 3.3)");
+}
+
+void UnloadSpriteBatch(void) {
+  if (instanced) {
+    rlUnloadVertexArray(vao);
+    rlUnloadVertexBuffer(cornerVbo);
+    rlUnloadVertexBuffer(instanceVbo);
+    UnloadShader(shader);
+    instanced = false;
+  }
+  free(sprites);
+  free(sorted);
+  free(depthKeys);
+  free(groupOf);
+  free(order);
+  free(orderScratch);
+  sprites = sorted = NULL;
+  depthKeys = order = orderScratch = NULL;
+  groupOf = NULL;
+  capacity = spriteCount = groupCount = 0;
+}
+
+// ==========================================
+// SORTING
+// ==========================================
+
+// Stable sort of order[] by depth key (four byte passes, skipping bytes
+// every key shares), then by group
+static void SortSprites(void) {
+  uint32_t counts[4][256];
+  memset(counts, 0, sizeof(counts));
+  for (int i = 0; i < spriteCount; i++) {
+    uint32_t key = depthKeys[i];
+    counts[0][key & 0xFF]++;
+    counts[1][(key >> 8) & 0xFF]++;
+    counts[2][(key >> 16) & 0xFF]++;
+    counts[3][key >> 24]++;
+    order[i] = (uint32_t)i;
+  }
+
+  for (int pass = 0; pass < 4; pass++) {
+    int shift = pass * 8;
+    if (counts[pass][(depthKeys[0] >> shift) & 0xFF] == (uint32_t)spriteCount)
+      continue;
+    uint32_t offset = 0;
+    for (int b = 0; b < 256; b++) {
+      uint32_t n = counts[pass][b];
+      counts[pass][b] = offset;
+      offset += n;
+    }
+    for (int i = 0; i < spriteCount; i++) {
+      uint32_t index = order[i];
+      orderScratch[counts[pass][(depthKeys[index] >> shift) & 0xFF]++] =
+          index;
+    }
+    uint32_t *swap = order;
+    order = orderScratch;
+    orderScratch = swap;
+  }
+
+  uint32_t groupStart[SPRITE_BATCH_MAX_TEXTURES + 1] = {0};
+  for (int i = 0; i < spriteCount; i++)
+    groupStart[groupOf[i] + 1]++;
+  for (int g = 0; g < groupCount; g++)
+    groupStart[g + 1] += groupStart[g];
+  for (int i = 0; i < spriteCount; i++) {
+    uint32_t index = order[i];
+    sorted[groupStart[groupOf[index]]++] = sprites[index];
+  }
+}
+
+// ==========================================
+// DRAWING
+// ==========================================
+
+static void DrawGroupInstanced(int start, int count, Texture2D texture) {
+  rlActiveTextureSlot(0);
+  rlEnableTexture(texture.id);
+
+  // Point the instance attributes at this group's slice
+  rlEnableVertexBuffer(instanceVbo);
+  PointInstanceAttributes(start);
+  rlDrawVertexArrayInstanced(0, 6, count);
+  drawCalls++;
+}
+
+static void DrawGroupStreamed(int start, int count, Texture2D texture) {
+  for (int chunk = start; chunk < start + count; chunk += STREAM_CHUNK) {
+    int end = chunk + STREAM_CHUNK < start + count ? chunk + STREAM_CHUNK
+                                                   : start + count;
+    rlCheckRenderBatchLimit((end - chunk) * 4);
+    rlSetTexture(texture.id);
+    rlBegin(RL_QUADS);
+    for (int i = chunk; i < end; i++) {
+      const SpriteInstance *s = &sorted[i];
+      Vector3 center = {s->x, s->y, s->z};
+      Vector3 right = Vector3Scale(cameraRight, s->width * 0.5f);
+      Vector3 up = Vector3Scale(cameraUp, s->height * 0.5f);
+      Vector3 bottom = Vector3Subtract(center, up);
+      Vector3 top = Vector3Add(center, up);
+      Vector3 corners[4] = {
+          Vector3Subtract(bottom, right), Vector3Add(bottom, right),
+          Vector3Add(top, right), Vector3Subtract(top, right)};
+      float u[4] = {s->u, s->u + s->du, s->u + s->du, s->u};
+      float v[4] = {s->v + s->dv, s->v + s->dv, s->v, s->v};
+
+      rlColor4ub(s->tint.r, s->tint.g, s->tint.b, s->tint.a);
+      for (int c = 0; c < 4; c++) {
+        rlTexCoord2f(u[c], v[c]);
+        rlVertex3f(corners[c].x, corners[c].y, corners[c].z);
+      }
+    }
+    rlEnd();
+    rlSetTexture(0);
+    drawCalls++;
+  }
+}
+
+static void FlushSprites(void) {
+  if (spriteCount == 0)
+    return;
+  SortSprites();
+
+  int groupSize[SPRITE_BATCH_MAX_TEXTURES] = {0};
+  for (int i = 0; i < spriteCount; i++)
+    groupSize[groupOf[i]]++;
+
+  if (instanced) {
+    rlDrawRenderBatchActive(); // Earlier immediate-mode draws go first
+    Matrix mvp =
+        MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlEnableShader(shader.id);
+    rlSetUniformMatrix(mvpLoc, mvp);
+    rlSetUniform(rightLoc, &cameraRight, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(upLoc, &cameraUp, SHADER_UNIFORM_VEC3, 1);
+    rlEnableVertexArray(vao);
+    rlUpdateVertexBuffer(instanceVbo, sorted,
+                         spriteCount * (int)sizeof(SpriteInstance), 0);
+  }
+
+  int start = 0;
+  for (int g = 0; g < groupCount; g++) {
+    if (groupSize[g] == 0)
+      continue;
+    if (instanced)
+      DrawGroupInstanced(start, groupSize[g], groupTextures[g]);
+    else
+      DrawGroupStreamed(start, groupSize[g], groupTextures[g]);
+    start += groupSize[g];
+  }
+
+  if (instanced) {
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+  }
+  spriteCount = 0;
+  groupCount = 0;
+}
+
+void BeginSpriteBatch(Camera3D camera) {
+  batchCamera = camera;
+  Matrix view = GetCameraMatrix(camera);
+  cameraRight = (Vector3){view.m0, view.m4, view.m8};
+  cameraUp = (Vector3){view.m1, view.m5, view.m9};
+  cameraForward = (Vector3){-view.m2, -view.m6, -view.m10};
+  spriteCount = 0;
+  groupCount = 0;
+  drawCalls = 0;
+}
+
+void PushSprite(Texture2D texture, Rectangle source, Vector3 position,
+                float height, Color tint) {
+  if (!sprites || texture.width == 0 || texture.height == 0 ||
+      source.height == 0.0f)
+    return;
+
+  int group = 0;
+  while (group < groupCount && groupTextures[group].id != texture.id)
+    group++;
+  if (group == SPRITE_BATCH_MAX_TEXTURES || spriteCount == capacity) {
+    FlushSprites();
+    group = 0;
+  }
+  if (group == groupCount)
+    groupTextures[groupCount++] = texture;
+
+  // Far first: larger view depth gets the smaller key. Sprites behind
+  // the camera all share the last key.
+  float depth = Vector3DotProduct(
+      Vector3Subtract(position, batchCamera.position), cameraForward);
+  uint32_t bits = 0;
+  if (depth > 0.0f)
+    memcpy(&bits, &depth, sizeof(bits)); // Ordered like the float
+  depthKeys[spriteCount] = ~bits;
+  groupOf[spriteCount] = (uint8_t)group;
+  float width = height * fabsf(source.width / source.height);
+  sprites[spriteCount++] = (SpriteInstance){
+      position.x,
+      position.y,
+      position.z,
+      height,
+      source.x / (float)texture.width,
+      source.y / (float)texture.height,
+      source.width / (float)texture.width,
+      source.height / (float)texture.height,
+      width,
+      tint};
+}
+
+void EndSpriteBatch(void) { FlushSprites(); }
+
+int GetSpriteBatchDrawCalls(void) { return drawCalls; }
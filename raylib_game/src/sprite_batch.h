@@ -0,0 +1,39 @@
+/**
+ * Kitchen Knight - Sprite Batcher
+ * ===============================
+ * Camera-facing billboards drawn in bulk. Sprites are queued between
+ * BeginSpriteBatch and EndSpriteBatch; End groups them by texture, sorts
+ * each group back to front for alpha blending and draws every group with
+ * one instanced call (billboarding happens in the vertex shader). Sprites
+ * from the atlas (assets.h) share a texture, so they share that call.
+ * Without GL 3.3 the groups are streamed through rlgl's batch as quads.
+ *
+ *   BeginSpriteBatch(camera);
+ *   PushSprite(texture, source, position, 4.0f, tint); // Per sprite
+ *   EndSpriteBatch();                                  // Inside BeginMode3D
+ */
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "raylib.h"
+
+#define SPRITE_BATCH_MAX_TEXTURES 8 // Distinct textures per batch
+
+// Needs a window. capacity is the most sprites drawn in one call; a batch
+// that fills up is drawn and started again.
+void InitSpriteBatch(int capacity);
+void UnloadSpriteBatch(void);
+
+void BeginSpriteBatch(Camera3D camera);
+// source is in texture pixels and height in world units; width follows
+// the source's aspect ratio, like DrawBillboardRec
+void PushSprite(Texture2D texture, Rectangle source, Vector3 position,
+                float height, Color tint);
+void EndSpriteBatch(void);
+
+// Draw calls since BeginSpriteBatch (one per texture unless the batch
+// filled up; the streamed fallback counts one per chunk)
+int GetSpriteBatchDrawCalls(void);
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,211 @@
+/**
+ * Kitchen Knight - Threads Implementation
+ * =======================================
+ * Win32 threads with SRW locks and condition variables on Windows,
+ * pthreads everywhere else.
+ */
+
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // sysconf(_SC_NPROCESSORS_ONLN) on glibc
+#endif
+
+#include "sys_thread.h"
+#include <stdlib.h>
+
+#if defined(_WIN32)
+// Keep windows.h out of the way of raylib's symbols
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+struct SysThread {
+  SysThreadFn fn;
+  void *arg;
+#if defined(_WIN32)
+  HANDLE handle;
+#else
+  pthread_t handle;
+#endif
+};
+
+struct SysMutex {
+#if defined(_WIN32)
+  SRWLOCK lock;
+#else
+  pthread_mutex_t lock;
+#endif
+};
+
+struct SysCond {
+#if defined(_WIN32)
+  CONDITION_VARIABLE cond;
+#else
+  pthread_cond_t cond;
+#endif
+};
+
+// ==========================================
+// THREADS
+// ==========================================
+
+#if defined(_WIN32)
+static DWORD WINAPI ThreadEntry(LPVOID param) {
+  SysThread *thread = (SysThread *)param;
+  thread->fn(thread->arg);
+  return 0;
+}
+#else
+static void *ThreadEntry(void *param) {
+  SysThread *thread = (SysThread *)param;
+  thread->fn(thread->arg);
+  return NULL;
+}
+#endif
+
+SysThread *CreateSysThread(SysThreadFn fn, void *arg) {
+  SysThread *thread = malloc(sizeof(SysThread));
+  if (!thread)
+    return NULL;
+  thread->fn = fn;
+  thread->arg = arg;
+
+#if defined(_WIN32)
+  thread->handle = CreateThread(NULL, 0, ThreadEntry, thread, 0, NULL);
+  if (!thread->handle) {
+#else
+  if (pthread_create(&thread->handle, NULL, ThreadEntry, thread) != 0) {
+#endif
+    free(thread);
+    return NULL;
+  }
+  return thread;
+}
+
+void JoinSysThread(SysThread *thread) {
+  if (!thread)
+    return;
+#if defined(_WIN32)
+  WaitForSingleObject(thread->handle, INFINITE);
+  CloseHandle(thread->handle);
+#else
+  pthread_join(thread->handle, NULL);
+#endif
+  free(thread);
+}
+
+void YieldSysThread(void) {
+#if defined(_WIN32)
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+void SleepSysThread(int ms) {
+#if defined(_WIN32)
+  Sleep((DWORD)ms);
+#else
+  struct timespec duration = {ms / 1000, (long)(ms % 1000) * 1000000L};
+  nanosleep(&duration, NULL);
+#endif
+}
+
+int GetCpuCount(void) {
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int count = (int)info.dwNumberOfProcessors;
+#else
+  int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return count > 0 ? count : 1;
+}
+
+// ==========================================
+// MUTEXES
+// ==========================================
+
+SysMutex *CreateSysMutex(void) {
+  SysMutex *mutex = malloc(sizeof(SysMutex));
+  if (!mutex)
+    return NULL;
+#if defined(_WIN32)
+  InitializeSRWLock(&mutex->lock);
+#else
+  pthread_mutex_init(&mutex->lock, NULL);
+#endif
+  return mutex;
+}
+
+void DestroySysMutex(SysMutex *mutex) {
+  if (!mutex)
+    return;
+#if !defined(_WIN32)
+  pthread_mutex_destroy(&mutex->lock);
+#endif
+  free(mutex);
+}
+
+void LockSysMutex(SysMutex *mutex) {
+#if defined(_WIN32)
+  AcquireSRWLockExclusive(&mutex->lock);
+#else
+  pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+void UnlockSysMutex(SysMutex *mutex) {
+#if defined(_WIN32)
+  ReleaseSRWLockExclusive(&mutex->lock);
+#else
+  pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+// ==========================================
+// CONDITION VARIABLES
+// ==========================================
+
+SysCond *CreateSysCond(void) {
+  SysCond *cond = malloc(sizeof(SysCond));
+  if (!cond)
+    return NULL;
+#if defined(_WIN32)
+  InitializeConditionVariable(&cond->cond);
+#else
+  pthread_cond_init(&cond->cond, NULL);
+#endif
+  return cond;
+}
+
+void DestroySysCond(SysCond *cond) {
+  if (!cond)
+    return;
+#if !defined(_WIN32)
+  pthread_cond_destroy(&cond->cond);
+#endif
+  free(cond);
+}
+
+void WaitSysCond(SysCond *cond, SysMutex *mutex) {
+#if defined(_WIN32)
+  SleepConditionVariableSRW(&cond->cond, &mutex->lock, INFINITE, 0);
+#else
+  pthread_cond_wait(&cond->cond, &mutex->lock);
+#endif
+}
+
+void BroadcastSysCond(SysCond *cond) {
+#if defined(_WIN32)
+  WakeAllConditionVariable(&cond->cond);
+#else
+  pthread_cond_broadcast(&cond->cond);
+#endif
+}
@@ -0,0 +1,36 @@
+/**
+ * Kitchen Knight - Threads
+ * ========================
+ * Minimal portable threads, mutexes and condition variables (pthreads or
+ * Win32). Handles are opaque so platform headers stay out of the game code.
+ */
+
+#ifndef SYS_THREAD_H
+#define SYS_THREAD_H
+
+typedef struct SysThread SysThread;
+typedef struct SysMutex SysMutex;
+typedef struct SysCond SysCond;
+
+typedef void (*SysThreadFn)(void *arg);
+
+// --- Threads ---
+SysThread *CreateSysThread(SysThreadFn fn, void *arg); // NULL on failure
+void JoinSysThread(SysThread *thread);                 // Also frees it
+void YieldSysThread(void);
+void SleepSysThread(int ms);
+int GetCpuCount(void); // Logical processors, at least 1
+
+// --- Mutexes ---
+SysMutex *CreateSysMutex(void);
+void DestroySysMutex(SysMutex *mutex);
+void LockSysMutex(SysMutex *mutex);
+void UnlockSysMutex(SysMutex *mutex);
+
+// --- Condition Variables ---
+SysCond *CreateSysCond(void);
+void DestroySysCond(SysCond *cond);
+void WaitSysCond(SysCond *cond, SysMutex *mutex);
+void BroadcastSysCond(SysCond *cond);
+
+#endif // SYS_THREAD_H
@@ -0,0 +1,45 @@
+/**
+ * Kitchen Knight - High Resolution Timer Implementation
+ * =====================================================
+ * QueryPerformanceCounter on Windows, clock_gettime everywhere else.
+ * raylib's GetTime() needs an open window, benchmarks don't have one.
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "timer.h"
+
+#if defined(_WIN32)
+// Keep windows.h out of the way of raylib's symbols
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+uint64_t GetTimestampNs(void) {
+#if defined(_WIN32)
+  static LARGE_INTEGER frequency = {0};
+  LARGE_INTEGER counter;
+  if (frequency.QuadPart == 0)
+    QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  // Split to avoid overflowing 64 bits on long uptimes
+  uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+  uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+  return seconds * 1000000000ull +
+         remainder * 1000000000ull / (uint64_t)frequency.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+double NsToMs(uint64_t ns) { return (double)ns / 1.0e6; }
+
+double NsToSeconds(uint64_t ns) { return (double)ns / 1.0e9; }
@@ -0,0 +1,19 @@
+/**
+ * Kitchen Knight - High Resolution Timer
+ * ======================================
+ * Monotonic nanosecond clock that works without a raylib window.
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+// Monotonic timestamp in nanoseconds (arbitrary epoch)
+uint64_t GetTimestampNs(void);
+
+// Convenience conversions
+double NsToMs(uint64_t ns);
+double NsToSeconds(uint64_t ns);
+
+#endif // TIMER_H
@@ -0,0 +1,177 @@
+/**
+ * Kitchen Knight - Asset Packer
+ * =============================
+ * Writes the assets directory as one archive (see archive.h) for the game
+ * to map at startup. Images are stored decoded, in the pixel format they
+ * load as; block-compressed files (.dds, and .ktx/.pkm/.astc where raylib
+ * reads them) keep their DXT/ETC/ASTC blocks and upload compressed. WAV
+ * files become PCM, and the game's sprites go in as the finished atlas.
+ * Everything else (levels, PVS, music) is stored byte for byte.
+ *
+ * Run it from the directory the game runs in, since the game asks for
+ * assets by paths relative to it, and again whenever an asset changes.
+ *
+ * Usage: kk_pack [assets dir] [out file]   (default: assets assets.kkpak)
+ */
+
+#include "archive.h"
+#include "assets.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IMAGE_EXTENSIONS                                                       \
+  ".png;.jpg;.jpeg;.bmp;.tga;.gif;.qoi;.dds;.ktx;.pkm;.astc"
+
+typedef enum { OWNED_NONE, OWNED_IMAGE, OWNED_WAVE, OWNED_FILE } Owned;
+
+int main(int argc, char **argv) {
+  const char *dir = argc > 1 ? argv[1] : "assets";
+  const char *out = argc > 2 ? argv[2] : ASSET_ARCHIVE_FILE;
+  char root[ARCHIVE_NAME_MAX];
+  snprintf(root, sizeof(root), "%s", dir);
+  size_t length = strlen(root);
+  while (length > 0 && (root[length - 1] == '/' || root[length - 1] == '\\'))
+    root[--length] = '\0';
+  snprintf(root + length, sizeof(root) - length, "/");
+  uint64_t start = GetTimestampNs();
+
+  FilePathList files = LoadDirectoryFilesEx(dir, NULL, true);
+  int capacity = (int)files.count + 1 + gameSpriteCount;
+  ArchiveEntry *entries = calloc((size_t)capacity, sizeof(ArchiveEntry));
+  Owned *owned = calloc((size_t)capacity, sizeof(Owned));
+  if (!entries || !owned) {
+    printf("[Pack] ERROR: Out of memory for %u files\n", files.count);
+    return 1;
+  }
+  int count = 0;
+
+  // The atlas first: its sprites don't need entries of their own
+  Image sheet;
+  Rectangle sources[ATLAS_MAX_SPRITES];
+  bool atlas = PackSpriteAtlas(gameSprites, gameSpriteCount, &sheet, sources);
+  if (atlas) {
+    ArchiveEntry *e = &entries[count++];
+    snprintf(e->name, sizeof(e->name), "%s", ATLAS_KEY);
+    e->type = ARCHIVE_IMAGE;
+    e->params[0] = (uint32_t)sheet.width;
+    e->params[1] = (uint32_t)sheet.height;
+    e->params[2] = (uint32_t)sheet.format;
+    e->params[3] = 1;
+    e->data = sheet.data;
+    e->size = (uint64_t)GetPixelDataSize(sheet.width, sheet.height,
+                                         sheet.format);
+    for (int i = 0; i < gameSpriteCount && i < ATLAS_MAX_SPRITES; i++) {
+      if (sources[i].width <= 0.0f)
+        continue;
+      e = &entries[count++];
+      snprintf(e->name, sizeof(e->name), "%s", gameSprites[i]);
+      e->type = ARCHIVE_SPRITE;
+      e->params[0] = (uint32_t)sources[i].x;
+      e->params[1] = (uint32_t)sources[i].y;
+      e->params[2] = (uint32_t)sources[i].width;
+      e->params[3] = (uint32_t)sources[i].height;
+    }
+  }
+
+  for (unsigned int f = 0; f < files.count; f++) {
+    char name[512];
+    snprintf(name, sizeof(name), "%s", files.paths[f]);
+    for (char *c = name; *c; c++)
+      if (*c == '\\')
+        *c = '/';
+    if (strcmp(name, out) == 0)
+      continue;
+    if (strlen(name) >= ARCHIVE_NAME_MAX) {
+      printf("[Pack] WARNING: Skipping %s (name over %d characters)\n", name,
+             ARCHIVE_NAME_MAX - 1);
+      continue;
+    }
+    bool inAtlas = false;
+    for (int i = 0; atlas && i < gameSpriteCount && i < ATLAS_MAX_SPRITES; i++)
+      inAtlas |= sources[i].width > 0.0f && strcmp(gameSprites[i], name) == 0;
+    if (inAtlas)
+      continue;
+
+    ArchiveEntry *e = &entries[count];
+    snprintf(e->name, sizeof(e->name), "%s", name);
+    if (IsFileExtension(name, IMAGE_EXTENSIONS)) {
+      Image image = LoadImage(name);
+      if (IsImageValid(image)) {
+        e->type = ARCHIVE_IMAGE;
+        e->params[0] = (uint32_t)image.width;
+        e->params[1] = (uint32_t)image.height;
+        e->params[2] = (uint32_t)image.format;
+        e->params[3] = (uint32_t)image.mipmaps;
+        e->data = image.data;
+        // Every mip level in the file
+        int width = image.width, height = image.height;
+        for (int level = 0; level < image.mipmaps; level++) {
+          e->size += (uint64_t)GetPixelDataSize(width, height, image.format);
+          width = width > 1 ? width / 2 : 1;
+          height = height > 1 ? height / 2 : 1;
+        }
+        owned[count++] = OWNED_IMAGE;
+        continue;
+      }
+    } else if (IsFileExtension(name, ".wav")) {
+      Wave wave = LoadWave(name);
+      if (IsWaveValid(wave)) {
+        e->type = ARCHIVE_WAVE;
+        e->params[0] = wave.frameCount;
+        e->params[1] = wave.sampleRate;
+        e->params[2] = wave.sampleSize;
+        e->params[3] = wave.channels;
+        e->data = wave.data;
+        e->size = (uint64_t)wave.frameCount * wave.channels *
+                  (wave.sampleSize / 8);
+        owned[count++] = OWNED_WAVE;
+        continue;
+      }
+    }
+
+    // Anything raylib can't decode goes in as it is
+    int size = 0;
+    unsigned char *data = LoadFileData(name, &size);
+    if (!data) {
+      printf("[Pack] WARNING: Can't read %s\n", name);
+      continue;
+    }
+    e->type = ARCHIVE_RAW;
+    e->data = data;
+    e->size = (uint64_t)size;
+    owned[count++] = OWNED_FILE;
+  }
+
+  bool ok = WriteAssetArchive(out, root, entries, count);
+  if (ok) {
+    uint64_t bytes = 0;
+    for (int i = 0; i < count; i++)
+      bytes += entries[i].size;
+    printf("[Pack] %s: %d entries from %s, %.1f MB, in %.0f ms\n", out, count,
+           root, bytes / (1024.0 * 1024.0), NsToMs(GetTimestampNs() - start));
+  }
+
+  for (int i = 0; i < count; i++) {
+    switch (owned[i]) {
+    case OWNED_IMAGE:
+      UnloadImage((Image){.data = (void *)entries[i].data});
+      break;
+    case OWNED_WAVE:
+      UnloadWave((Wave){.data = (void *)entries[i].data});
+      break;
+    case OWNED_FILE:
+      UnloadFileData((unsigned char *)entries[i].data);
+      break;
+    case OWNED_NONE:
+      break;
+    }
+  }
+  if (atlas)
+    UnloadImage(sheet);
+  free(entries);
+  free(owned);
+  UnloadDirectoryFiles(files);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/**
+ * Kitchen Knight - PVS Precompiler
+ * ================================
+ * Builds the potentially visible set of an ASCII level and writes it next
+ * to the level, where LoadLevelVisibility picks it up instead of building
+ * it at load. A file from an edited level no longer matches its hash and
+ * is rebuilt at load, so run this again after changing a map.
+ *
+ * Usage: kk_pvs level.txt [out.pvs]
+ */
+
+#include "enemies/enemy_types.h"
+#include "jobs.h"
+#include "logger.h"
+#include "map_loader.h"
+#include "pvs.h"
+#include "timer.h"
+#include <stdio.h>
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    printf("Usage: %s level.txt [out.pvs]\n", argv[0]);
+    return 1;
+  }
+  char path[512];
+  if (argc > 2)
+    snprintf(path, sizeof(path), "%s", argv[2]);
+  else
+    snprintf(path, sizeof(path), "%s%s", argv[1], PVS_FILE_EXTENSION);
+
+  InitLogger();
+  InitJobSystem(0);
+  InitEnemySystem(); // The loader places the level's spawns
+
+  LevelMap map = {0};
+  bool ok = LoadLevel(argv[1], &map);
+  LevelPVS pvs = {0};
+  if (ok) {
+    uint64_t start = GetTimestampNs();
+    ok = BuildLevelPVS(&pvs, &map);
+    double ms = NsToMs(GetTimestampNs() - start);
+    ok = ok && SaveLevelPVS(&pvs, path);
+    if (ok) {
+      int cells = map.width * map.height;
+      printf("[PVS] %s: %dx%d cells in %.1f ms, %u bytes of runs "
+             "(%.1f per cell) -> %s\n",
+             argv[1], map.width, map.height, ms, pvs.rleSize,
+             cells > 0 ? (double)pvs.rleSize / cells : 0.0, path);
+    }
+  }
+
+  UnloadLevelPVS(&pvs);
+  UnloadLevel(&map);
+  ShutdownJobSystem();
+  ShutdownLogger();
+  return ok ? 0 : 1;
+}